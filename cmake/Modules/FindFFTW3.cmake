@@ -3,6 +3,8 @@
 #  FFTW3_FOUND - System has fftw3
 #  FFTW3_INCLUDE_DIRS - The fftw3 include directories
 #  FFTW3_LIBRARIES - The libraries needed to use fftw3
+#  HAVE_LIBFFTW3_THREADS - Set if the fftw3_threads library was found, it is
+#    then part of FFTW3_LIBRARIES
 #  FFTW3_DEFINITIONS - Compiler switches required for using fftw3
 
 find_package(PkgConfig QUIET)
@@ -16,6 +18,11 @@ find_library(
   FFTW3_LIBRARY NAMES fftw3
   HINTS ${PC_FFTW3_LIBDIR} ${PC_FFTW3_LIBRARY_DIRS} )
 
+# The threads library is optional and enables multithreaded transforms
+find_library(
+  FFTW3_THREADS_LIBRARY NAMES fftw3_threads
+  HINTS ${PC_FFTW3_LIBDIR} ${PC_FFTW3_LIBRARY_DIRS} )
+
 if(PC_FFTW3_VERSION)
   set(FFTW3_VERSION_STRING ${PC_FFTW3_VERSION})
 endif()
@@ -28,7 +35,11 @@ find_package_handle_standard_args(
   REQUIRED_VARS FFTW3_LIBRARY FFTW3_INCLUDE_DIR
   VERSION_VAR FFTW3_VERSION_STRING)
 
-mark_as_advanced(FFTW3_INCLUDE_DIR FFTW3_LIBRARY )
+mark_as_advanced(FFTW3_INCLUDE_DIR FFTW3_LIBRARY FFTW3_THREADS_LIBRARY )
 
 set(FFTW3_LIBRARIES ${FFTW3_LIBRARY} )
+if(FFTW3_THREADS_LIBRARY)
+  set(FFTW3_LIBRARIES ${FFTW3_THREADS_LIBRARY} ${FFTW3_LIBRARIES} )
+  set(HAVE_LIBFFTW3_THREADS 1)
+endif()
 set(FFTW3_INCLUDE_DIRS ${FFTW3_INCLUDE_DIR} )
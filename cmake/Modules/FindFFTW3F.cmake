@@ -3,6 +3,8 @@
 #  FFTW3F_FOUND - System has fftw3f
 #  FFTW3F_INCLUDE_DIRS - The fftw3f include directories
 #  FFTW3F_LIBRARIES - The libraries needed to use fftw3f
+#  HAVE_LIBFFTW3F_THREADS - Set if the fftw3f_threads library was found, it is
+#    then part of FFTW3F_LIBRARIES
 #  FFTW3F_DEFINITIONS - Compiler switches required for using fftw3f
 
 find_package(PkgConfig QUIET)
@@ -16,6 +18,11 @@ find_library(
   FFTW3F_LIBRARY NAMES fftw3f
   HINTS ${PC_FFTW3F_LIBDIR} ${PC_FFTW3F_LIBRARY_DIRS} )
 
+# The threads library is optional and enables multithreaded transforms
+find_library(
+  FFTW3F_THREADS_LIBRARY NAMES fftw3f_threads
+  HINTS ${PC_FFTW3F_LIBDIR} ${PC_FFTW3F_LIBRARY_DIRS} )
+
 if(PC_FFTW3F_VERSION)
   set(FFTW3F_VERSION_STRING ${PC_FFTW3F_VERSION})
 endif()
@@ -28,7 +35,11 @@ find_package_handle_standard_args(
   REQUIRED_VARS FFTW3F_LIBRARY FFTW3F_INCLUDE_DIR
   VERSION_VAR FFTW3F_VERSION_STRING)
 
-mark_as_advanced(FFTW3F_INCLUDE_DIR FFTW3F_LIBRARY )
+mark_as_advanced(FFTW3F_INCLUDE_DIR FFTW3F_LIBRARY FFTW3F_THREADS_LIBRARY )
 
 set(FFTW3F_LIBRARIES ${FFTW3F_LIBRARY} )
+if(FFTW3F_THREADS_LIBRARY)
+  set(FFTW3F_LIBRARIES ${FFTW3F_THREADS_LIBRARY} ${FFTW3F_LIBRARIES} )
+  set(HAVE_LIBFFTW3F_THREADS 1)
+endif()
 set(FFTW3F_INCLUDE_DIRS ${FFTW3F_INCLUDE_DIR} )
@@ -35,7 +35,17 @@
 
 #include <blitz/array.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include <map>
+#include <vector>
+#include <limits>
+#include <functional>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 
 /*======================================================================*/
 /*!
@@ -49,6 +59,8 @@ namespace atb
 
   enum NHood { SIMPLE_NHOOD, COMPLEX_NHOOD };
 
+  enum StrelApproximation { EXACT_STREL, LINE_SEGMENT_STREL };
+
 /*======================================================================*/
 /*! 
  *   Generate a spherical neighborhood for morphological operations.
@@ -66,13 +78,96 @@ namespace atb
   template<int Dim>
   std::vector< blitz::TinyVector<BlitzIndexT,Dim> > sphericalStructuringElement(
       blitz::TinyVector<double,Dim> const &elementSizeUm, double radiusUm);
+
+/*======================================================================*/
+/*! 
+ *   Generate a box shaped neighborhood for morphological operations.
+ *   The reference point is the box center (shape / 2).
+ *
+ *   Morphological operations with box shaped structuring elements are
+ *   computed as separable one-dimensional van Herk/Gil-Werman passes,
+ *   whose cost is independent of the box size.
+ *
+ *   \param shapePx  The box extents in pixels
+ *
+ *   \return The points within the box
+ */
+/*======================================================================*/ 
+  template<int Dim>
+  std::vector< blitz::TinyVector<BlitzIndexT,Dim> > boxStructuringElement(
+      blitz::TinyVector<BlitzIndexT,Dim> const &shapePx);
+
+/*======================================================================*/
+/*! 
+ *   Check whether the given structuring element is a completely filled
+ *   axis-aligned box and get its bounds.
+ *
+ *   \param strel       The structuring element
+ *   \param lowerBound  If strel is a box, its lower bound is returned here
+ *   \param upperBound  If strel is a box, its (inclusive) upper bound is
+ *     returned here
+ *
+ *   \return \c true if strel is a box, \c false otherwise
+ */
+/*======================================================================*/ 
+  template<int Dim>
+  bool isBoxStructuringElement(
+      std::vector< blitz::TinyVector<BlitzIndexT,Dim> > const &strel,
+      blitz::TinyVector<BlitzIndexT,Dim> &lowerBound,
+      blitz::TinyVector<BlitzIndexT,Dim> &upperBound);
+
+/*======================================================================*/
+/*!
+ *  \struct StructuringElementLine ATBMorphology.hh "ArrayToolbox/ATBMorphology.hh"
+ *  \brief Symmetric line segment for decomposed structuring elements.
+ *
+ *  The segment contains the points k * step for k = -nSteps ... nSteps.
+ *  Morphological operations with a sequence of lines apply the operation
+ *  line by line, i.e. the effective structuring element is the Minkowski
+ *  sum of all line segments.
+ */
+/*======================================================================*/
+  template<int Dim>
+  struct StructuringElementLine
+  {
+    /*! The grid step between two consecutive segment points */
+    blitz::TinyVector<BlitzIndexT,Dim> step;
+
+    /*! The number of steps from the segment center to each of its ends */
+    BlitzIndexT nSteps;
+  };
+
+/*======================================================================*/
+/*! 
+ *   Approximate a spherical neighborhood by a sequence of line segments.
+ *
+ *   The segments run along all (3^Dim - 1) / 2 directions of the complex
+ *   neighborhood (axes, face diagonals and space diagonals). Their lengths
+ *   are chosen so that the mean width of the resulting polytope equals the
+ *   sphere diameter. For each segment the operation is computed with a
+ *   van Herk/Gil-Werman pass, so the cost per voxel is independent of the
+ *   radius. The approximation gets better with increasing radius in pixels,
+ *   for radii of only few pixels use sphericalStructuringElement().
+ *
+ *   \param elementSizeUm  The element size of the Array to apply the
+ *     filter to
+ *   \param radiusUm       The sphere radius in micrometers
+ *
+ *   \return The line segments approximating the sphere
+ */
+/*======================================================================*/
+  template<int Dim>
+  std::vector< StructuringElementLine<Dim> >
+  sphericalStructuringElementLines(
+      blitz::TinyVector<double,Dim> const &elementSizeUm, double radiusUm);
   
 /*======================================================================*/
 /*! 
  *   Morphological dilation.
  *
  *   Bright structures are extended using the maximum operation over the
- *   given structuring element.
+ *   given structuring element. If the structuring element is a filled box
+ *   the dilation is computed with separable van Herk/Gil-Werman passes.
  *
  *   \param data      The Array to apply the filter to
  *   \param result    The output Array the result will be written to. This
@@ -88,13 +183,38 @@ namespace atb
       blitz::Array<DataT,Dim> &result,
       std::vector< blitz::TinyVector<BlitzIndexT,Dim> > const &strel,
       iRoCS::ProgressReporter *progress = NULL);
+
+/*======================================================================*/
+/*! 
+ *   Morphological dilation with a structuring element decomposed into line
+ *   segments.
+ *
+ *   The maximum is computed along each line segment with a van
+ *   Herk/Gil-Werman pass. The lines of the Array along each segment
+ *   direction are processed in parallel.
+ *
+ *   \param data      The Array to apply the filter to
+ *   \param result    The output Array the result will be written to. This
+ *     can be the same Array as the input Array.
+ *   \param lines     The line segments forming the structuring element
+ *   \param progress  Progress of the filter will be reported to the given
+ *     ProgressReporter.
+ */
+/*======================================================================*/
+  template<typename DataT, int Dim>
+  void dilate(
+      blitz::Array<DataT,Dim> const &data,
+      blitz::Array<DataT,Dim> &result,
+      std::vector< StructuringElementLine<Dim> > const &lines,
+      iRoCS::ProgressReporter *progress = NULL);
   
 /*======================================================================*/
 /*! 
  *   Morphological erosion.
  *
  *   Dark structures are extended using the minimum operation over the
- *   given structuring element.
+ *   given structuring element. If the structuring element is a filled box
+ *   the erosion is computed with separable van Herk/Gil-Werman passes.
  *
  *   \param data      The Array to apply the filter to
  *   \param result    The output Array the result will be written to. This
@@ -110,6 +230,30 @@ namespace atb
       blitz::Array<DataT,Dim> &result,
       std::vector< blitz::TinyVector<BlitzIndexT,Dim> > const &strel,
       iRoCS::ProgressReporter *progress = NULL);
+
+/*======================================================================*/
+/*! 
+ *   Morphological erosion with a structuring element decomposed into line
+ *   segments.
+ *
+ *   The minimum is computed along each line segment with a van
+ *   Herk/Gil-Werman pass. The lines of the Array along each segment
+ *   direction are processed in parallel.
+ *
+ *   \param data      The Array to apply the filter to
+ *   \param result    The output Array the result will be written to. This
+ *     can be the same Array as the input Array.
+ *   \param lines     The line segments forming the structuring element
+ *   \param progress  Progress of the filter will be reported to the given
+ *     ProgressReporter.
+ */
+/*======================================================================*/
+  template<typename DataT, int Dim>
+  void erode(
+      blitz::Array<DataT,Dim> const &data,
+      blitz::Array<DataT,Dim> &result,
+      std::vector< StructuringElementLine<Dim> > const &lines,
+      iRoCS::ProgressReporter *progress = NULL);
   
 /*======================================================================*/
 /*! 
@@ -131,6 +275,28 @@ namespace atb
       blitz::Array<DataT,Dim> &result,
       std::vector< blitz::TinyVector<BlitzIndexT,Dim> > const &strel,
       iRoCS::ProgressReporter *progress = NULL);
+
+/*======================================================================*/
+/*! 
+ *   Morphological opening with a structuring element decomposed into line
+ *   segments.
+ *
+ *   Dilation after Erosion using the given line segments.
+ *
+ *   \param data      The Array to apply the filter to
+ *   \param result    The output Array the result will be written to. This
+ *     can be the same Array as the input Array.
+ *   \param lines     The line segments forming the structuring element
+ *   \param progress  Progress of the filter will be reported to the given
+ *     ProgressReporter.
+ */
+/*======================================================================*/
+  template<typename DataT, int Dim>
+  void open(
+      blitz::Array<DataT,Dim> const &data,
+      blitz::Array<DataT,Dim> &result,
+      std::vector< StructuringElementLine<Dim> > const &lines,
+      iRoCS::ProgressReporter *progress = NULL);
   
 /*======================================================================*/
 /*! 
@@ -153,6 +319,28 @@ namespace atb
       std::vector< blitz::TinyVector<BlitzIndexT,Dim> > const &strel,
       iRoCS::ProgressReporter *progress = NULL);
 
+/*======================================================================*/
+/*! 
+ *   Morphological closing with a structuring element decomposed into line
+ *   segments.
+ *
+ *   Erosion after Dilation using the given line segments.
+ *
+ *   \param data      The Array to apply the filter to
+ *   \param result    The output Array the result will be written to. This
+ *     can be the same Array as the input Array.
+ *   \param lines     The line segments forming the structuring element
+ *   \param progress  Progress of the filter will be reported to the given
+ *     ProgressReporter.
+ */
+/*======================================================================*/
+  template<typename DataT, int Dim>
+  void close(
+      blitz::Array<DataT,Dim> const &data,
+      blitz::Array<DataT,Dim> &result,
+      std::vector< StructuringElementLine<Dim> > const &lines,
+      iRoCS::ProgressReporter *progress = NULL);
+
 /*======================================================================*/
 /*! 
  *   Morphological top-hat filter.
@@ -177,6 +365,35 @@ namespace atb
       double radiusUm,
       iRoCS::ProgressReporter *progress = NULL);
 
+/*======================================================================*/
+/*! 
+ *   Morphological top-hat filter.
+ *
+ *   Computes data - open(data) with the spherical structuring element
+ *   represented as given. With LINE_SEGMENT_STREL the sphere is
+ *   approximated by sphericalStructuringElementLines() and the runtime
+ *   becomes independent of the radius.
+ *
+ *   \param data           The Array to apply the filter to
+ *   \param elementSizeUm  The element size of the Array
+ *   \param result         The output Array the result will be written to.
+ *     This can be the same Array as the input Array.
+ *   \param radiusUm       The radius of the structuring element in
+ *     micrometers
+ *   \param strelType      EXACT_STREL to use the exact voxelized sphere,
+ *     LINE_SEGMENT_STREL to use the line segment approximation
+ *   \param progress       Progress of the filter will be reported to the
+ *     given ProgressReporter.
+ */
+/*======================================================================*/
+  template<typename DataT, int Dim>
+  void tophat(
+      blitz::Array<DataT,Dim> const &data,
+      blitz::TinyVector<double,Dim> const &elementSizeUm,
+      blitz::Array<DataT,Dim> &result,
+      double radiusUm, StrelApproximation strelType,
+      iRoCS::ProgressReporter *progress = NULL);
+
 /*======================================================================*/
 /*! 
  *   Morphological hole filling for gray value data.
@@ -203,6 +420,12 @@ namespace atb
 /*! 
  *   Connected component labelling of the given binary Array
  *
+ *   The Array is split into slabs along the first dimension that are
+ *   labelled in parallel using a flat union-find structure with path
+ *   compression. The slab borders are merged afterwards. Components are
+ *   numbered consecutively starting at 1 in raster order of their first
+ *   voxel, background voxels get label 0.
+ *
  *   \param data   Binary Array to find connected components in
  *   \param labels Integer Array the labelled regions are returned in
  *   \param nh     Connectivity of adjacant elements (Neighborhood)<br />
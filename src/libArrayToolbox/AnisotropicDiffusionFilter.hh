@@ -34,8 +34,10 @@
 #include <config.hh>
 #endif
 
+#include <vector>
+
 #include "GaussianFilter.hh"
-#include "CentralHessianUTFilter.hh"
+#include "HessianEigenFilter.hh"
 #include "ATBLinAlg.hh"
 
 namespace atb
@@ -215,6 +217,47 @@ namespace atb
 /*======================================================================*/
     void setHessianUpdateStepWidth(int hessianUpdateStepWidth);
 
+/*======================================================================*/
+/*! 
+ *   Check whether the memory-lean single precision mode is enabled.
+ *
+ *   \return true if the low memory mode is enabled, false otherwise
+ */
+/*======================================================================*/
+    bool lowMemory() const;
+
+/*======================================================================*/
+/*! 
+ *   Enable or disable the memory-lean single precision mode.
+ *
+ *   In low memory mode the intermediate volumes are stored in single
+ *   precision and the diffusion tensor field is never stored as a whole.
+ *   Instead the diffusion tensors are recomputed for every iteration in
+ *   slabs along the first (z) dimension, each with a one voxel halo, from
+ *   the smoothed data of the last hessian update. Since the diffusion
+ *   tensors only depend on the smoothed data this yields the same result as
+ *   the default mode up to single precision rounding at the cost of
+ *   recomputing the hessian in every iteration.
+ *
+ *   \param lowMemory Pass true to enable the low memory mode
+ */
+/*======================================================================*/
+    void setLowMemory(bool lowMemory);
+
+/*======================================================================*/
+/*! 
+ *   Estimate the peak amount of memory apply() allocates in addition to
+ *   the input and output Arrays for data of the given shape in the
+ *   current mode.
+ *
+ *   \param shape The shape of the Array to filter
+ *
+ *   \return The approximate peak memory consumption in bytes
+ */
+/*======================================================================*/
+    size_t peakMemoryBytes(
+        blitz::TinyVector<BlitzIndexT,Dim> const &shape) const;
+
 /*======================================================================*/
 /*! 
  *   Apply the filter to the given Array.
@@ -311,9 +354,78 @@ namespace atb
         iRoCS::ProgressReporter *pr = NULL);
 
   private:
+
+    typedef blitz::TinyVector<double,Dim * (Dim + 1) / 2> DiffusionTensorT;
+
+    // Number of slices along dimension 0 per slab in low memory mode
+    static BlitzIndexT const _slabThickness = 16;
+
+    void _applyLowMemory(
+        blitz::Array<DataT,Dim> const &data,
+        blitz::TinyVector<double,Dim> const &elementSizeUm,
+        blitz::Array<ResultT,Dim> &filtered,
+        iRoCS::ProgressReporter *pr) const;
+
+    // Semi-implicit update of one voxel. in and D point to the value and
+    // diffusion tensor of the voxel at pos, neighbours are addressed
+    // with the given strides.
+    template<typename ValueT>
+    double _diffusionStep(
+        ValueT const *in, DiffusionTensorT const *D,
+        blitz::TinyVector<BlitzIndexT,Dim> const &pos,
+        blitz::TinyVector<BlitzIndexT,Dim> const &shape,
+        blitz::TinyVector<ptrdiff_t,Dim> const &stride) const;
+
+    // Stores the smallest hessian eigenvalue of voxels offset to
+    // offset + n - 1
+    class SmallestEigenvalueWriter
+    {
+
+    public:
+
+      static bool const needsEigenvectors = false;
+
+      SmallestEigenvalueWriter(double *out, ptrdiff_t offset, ptrdiff_t n);
+
+      void operator()(
+          ptrdiff_t i, blitz::TinyVector<double,Dim> const &lambda,
+          blitz::TinyMatrix<double,Dim,Dim> const &U);
+
+    private:
+
+      double *p_out;
+      ptrdiff_t _offset, _n;
+
+    };
+
+    // Computes the diffusion tensors of voxels offset to offset + n - 1
+    // from the hessian eigen decomposition
+    class DiffusionTensorWriter
+    {
+
+    public:
+
+      static bool const needsEigenvectors = true;
+
+      DiffusionTensorWriter(
+          DiffusionTensorT *D, ptrdiff_t offset, ptrdiff_t n,
+          double stddevInv, double zAnisotropyCorrection, double kappa);
+
+      void operator()(
+          ptrdiff_t i, blitz::TinyVector<double,Dim> const &lambda,
+          blitz::TinyMatrix<double,Dim,Dim> const &eVecs);
+
+    private:
+
+      DiffusionTensorT *p_D;
+      ptrdiff_t _offset, _n;
+      double _stddevInv, _zAnisotropyCorrection, _kappa;
+
+    };
     
     double _kappa, _sigmaUm, _tau, _zAnisotropyCorrection;
     int _nIterations, _hessianUpdateStepWidth;
+    bool _lowMemory;
 
   };
 
@@ -1294,6 +1294,7 @@ namespace atb
     blitz::ListInitializationSwitch<typename blitz::Array<DataT,Dim>, DataT*>
     operator=(DataT x)
           {
+            p_interpolator->invalidateCache();
             return blitz::ListInitializationSwitch<
                 typename blitz::Array<DataT,Dim>, DataT*>(*this, x);
           }
@@ -1551,6 +1552,22 @@ namespace atb
     DataT valueAt(blitz::TinyVector<double,Dim> const &positionUm)
         const;
 
+/*======================================================================*/
+/*! 
+ *   Get the Array values at the given model (sub-pixel) positions. This
+ *   is equivalent to calling valueAt() for every position, but the
+ *   interpolator is called only once for all positions using its
+ *   Interpolator::getBatch() method.
+ *
+ *   \param positionsUm The micrometer positions to query
+ *   \param nPositions  The number of positions
+ *   \param out         The output buffer of at least nPositions elements
+ */
+/*======================================================================*/
+    void valuesAt(
+        blitz::TinyVector<double,Dim> const *positionsUm, size_t nPositions,
+        DataT *out) const;
+
   protected:
     
 /*======================================================================*/
@@ -1000,6 +1000,210 @@ namespace atb
 
   };
 
+/*======================================================================*/
+/*!
+ *  \class ValueBoundaryPolicy BoundaryTreatment.hh "libArrayToolbox/BoundaryTreatment.hh"
+ *  \brief The ValueBoundaryPolicy class is the compile-time counterpart of
+ *    the ValueBoundaryTreatment class.
+ *
+ *  The boundary policies implement exactly the access semantics of the
+ *  corresponding BoundaryTreatment classes, but with non-virtual inline
+ *  member functions and the treatment type as compile-time constant.
+ *  Algorithms templated on the policy type get the boundary handling
+ *  inlined into their loops and can drop branches for other treatments
+ *  at compile time. Use BoundaryTreatmentFactory::dispatch() to select the
+ *  policy matching a run-time BoundaryTreatment object once per call.
+ */
+/*======================================================================*/
+  template<typename DataT, int Dim>
+  class ValueBoundaryPolicy
+  {
+
+  public:
+
+    static BoundaryTreatmentType const type = ValueBT;
+    static bool const providesIndices = false;
+
+/*======================================================================*/
+/*! 
+ *   Constructor.
+ *
+ *   \param value  The value of out-of-Array pixels
+ */
+/*======================================================================*/
+    explicit ValueBoundaryPolicy(DataT const &value = traits<DataT>::zero);
+
+/*======================================================================*/
+/*! 
+ *   Get the value, that is returned when out-of-Array positions
+ *   are requested.
+ *
+ *   \return The out-of-Array value
+ */
+/*======================================================================*/
+    DataT const &boundaryValue() const;
+
+/*======================================================================*/
+/*! 
+ *   \see BoundaryTreatment::get()
+ */
+/*======================================================================*/
+    DataT get(blitz::Array<DataT,Dim> const &data,
+              blitz::TinyVector<ptrdiff_t,Dim> const &pos) const;
+
+/*======================================================================*/
+/*! 
+ *   \see BoundaryTreatment::getIndex()
+ */
+/*======================================================================*/
+    blitz::TinyVector<ptrdiff_t,Dim> getIndex(
+        blitz::TinyVector<ptrdiff_t,Dim> const &pos,
+        blitz::TinyVector<ptrdiff_t,Dim> const &shape) const;
+
+/*======================================================================*/
+/*! 
+ *   \see BoundaryTreatment::get()
+ */
+/*======================================================================*/
+    DataT get(DataT const *data, ptrdiff_t pos, ptrdiff_t length) const;
+
+/*======================================================================*/
+/*! 
+ *   \see BoundaryTreatment::getIndex()
+ */
+/*======================================================================*/
+    ptrdiff_t getIndex(ptrdiff_t pos, ptrdiff_t length) const;
+
+  private:
+
+    DataT _value;
+
+  };
+
+/*======================================================================*/
+/*!
+ *  \class CyclicBoundaryPolicy BoundaryTreatment.hh "libArrayToolbox/BoundaryTreatment.hh"
+ *  \brief The CyclicBoundaryPolicy class is the compile-time counterpart of
+ *    the CyclicBoundaryTreatment class.
+ *
+ *  \see ValueBoundaryPolicy
+ */
+/*======================================================================*/
+  template<typename DataT, int Dim>
+  class CyclicBoundaryPolicy
+  {
+
+  public:
+
+    static BoundaryTreatmentType const type = CyclicBT;
+    static bool const providesIndices = true;
+
+    DataT get(blitz::Array<DataT,Dim> const &data,
+              blitz::TinyVector<ptrdiff_t,Dim> const &pos) const;
+
+    blitz::TinyVector<ptrdiff_t,Dim> getIndex(
+        blitz::TinyVector<ptrdiff_t,Dim> const &pos,
+        blitz::TinyVector<ptrdiff_t,Dim> const &shape) const;
+
+    DataT get(DataT const *data, ptrdiff_t pos, ptrdiff_t length) const;
+
+    ptrdiff_t getIndex(ptrdiff_t pos, ptrdiff_t length) const;
+
+  };
+
+/*======================================================================*/
+/*!
+ *  \class RepeatBoundaryPolicy BoundaryTreatment.hh "libArrayToolbox/BoundaryTreatment.hh"
+ *  \brief The RepeatBoundaryPolicy class is the compile-time counterpart of
+ *    the RepeatBoundaryTreatment class.
+ *
+ *  \see ValueBoundaryPolicy
+ */
+/*======================================================================*/
+  template<typename DataT, int Dim>
+  class RepeatBoundaryPolicy
+  {
+
+  public:
+
+    static BoundaryTreatmentType const type = RepeatBT;
+    static bool const providesIndices = true;
+
+    DataT get(blitz::Array<DataT,Dim> const &data,
+              blitz::TinyVector<ptrdiff_t,Dim> const &pos) const;
+
+    blitz::TinyVector<ptrdiff_t,Dim> getIndex(
+        blitz::TinyVector<ptrdiff_t,Dim> const &pos,
+        blitz::TinyVector<ptrdiff_t,Dim> const &shape) const;
+
+    DataT get(DataT const *data, ptrdiff_t pos, ptrdiff_t length) const;
+
+    ptrdiff_t getIndex(ptrdiff_t pos, ptrdiff_t length) const;
+
+  };
+
+/*======================================================================*/
+/*!
+ *  \class MirrorBoundaryPolicy BoundaryTreatment.hh "libArrayToolbox/BoundaryTreatment.hh"
+ *  \brief The MirrorBoundaryPolicy class is the compile-time counterpart of
+ *    the MirrorBoundaryTreatment class.
+ *
+ *  \see ValueBoundaryPolicy
+ */
+/*======================================================================*/
+  template<typename DataT, int Dim>
+  class MirrorBoundaryPolicy
+  {
+
+  public:
+
+    static BoundaryTreatmentType const type = MirrorBT;
+    static bool const providesIndices = true;
+
+    DataT get(blitz::Array<DataT,Dim> const &data,
+              blitz::TinyVector<ptrdiff_t,Dim> const &pos) const;
+
+    blitz::TinyVector<ptrdiff_t,Dim> getIndex(
+        blitz::TinyVector<ptrdiff_t,Dim> const &pos,
+        blitz::TinyVector<ptrdiff_t,Dim> const &shape) const;
+
+    DataT get(DataT const *data, ptrdiff_t pos, ptrdiff_t length) const;
+
+    ptrdiff_t getIndex(ptrdiff_t pos, ptrdiff_t length) const;
+
+  };
+
+/*======================================================================*/
+/*!
+ *  \class CropBoundaryPolicy BoundaryTreatment.hh "libArrayToolbox/BoundaryTreatment.hh"
+ *  \brief The CropBoundaryPolicy class is the compile-time counterpart of
+ *    the CropBoundaryTreatment class.
+ *
+ *  \see ValueBoundaryPolicy
+ */
+/*======================================================================*/
+  template<typename DataT, int Dim>
+  class CropBoundaryPolicy
+  {
+
+  public:
+
+    static BoundaryTreatmentType const type = CropBT;
+    static bool const providesIndices = true;
+
+    DataT get(blitz::Array<DataT,Dim> const &data,
+              blitz::TinyVector<ptrdiff_t,Dim> const &pos) const;
+
+    blitz::TinyVector<ptrdiff_t,Dim> getIndex(
+        blitz::TinyVector<ptrdiff_t,Dim> const &pos,
+        blitz::TinyVector<ptrdiff_t,Dim> const &shape) const;
+
+    DataT get(DataT const *data, ptrdiff_t pos, ptrdiff_t length) const;
+
+    ptrdiff_t getIndex(ptrdiff_t pos, ptrdiff_t length) const;
+
+  };
+
 /*======================================================================*/
 /*!
  *  \class BoundaryTreatmentFactory BoundaryTreatment.hh "libArrayToolbox/BoundaryTreatment.hh"
@@ -1034,6 +1238,33 @@ namespace atb
 /*======================================================================*/
     static BoundaryTreatment<DataT,Dim> *get(
         BoundaryTreatmentType type, DataT const &value = traits<DataT>::zero);
+
+/*======================================================================*/
+/*! 
+ *   Call the given functor with the boundary policy corresponding to the
+ *   given BoundaryTreatment object. The functor must provide a templated
+ *   call operator accepting any of the boundary policies, e.g.
+ *
+ *   \code
+ *   struct LineFilter
+ *   {
+ *     template<typename BoundaryPolicyT>
+ *     void operator()(BoundaryPolicyT const &bt) { ... }
+ *   };
+ *   \endcode
+ *
+ *   This way the virtual boundary treatment is resolved once per call
+ *   instead of once per out-of-Array access.
+ *
+ *   \param bt The run-time boundary treatment
+ *   \param f  The functor to call with the matching boundary policy
+ *
+ *   \exception RuntimeError If the boundary treatment type is not handled
+ *     this exception is thrown
+ */
+/*======================================================================*/
+    template<typename FunctorT>
+    static void dispatch(BoundaryTreatment<DataT,Dim> const &bt, FunctorT &f);
     
   };
 
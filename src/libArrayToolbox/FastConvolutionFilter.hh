@@ -35,6 +35,7 @@
 #endif
 
 #include "Filter.hh"
+#include "OverlapSaveConvolver.hh"
 
 #include <libBlitzFFTW/BlitzFFTW.hh>
 
@@ -56,6 +57,10 @@ namespace atb
  *  SeparableConvolutionFilter class instead. For big kernels it is slower,
  *  but it is almost in-place and fully parallelized to give optimum
  *  performance.
+ *
+ *  With setTiled(true) the filter switches to overlap-save convolution
+ *  in FFT-friendly tiles, which reduces the memory overhead to a few tiles
+ *  per thread.
  */
 /*======================================================================*/
   template<typename DataT, int Dim>
@@ -123,6 +128,27 @@ namespace atb
 /*======================================================================*/
     blitz::Array<DataT,Dim> const &kernel() const;
 
+/*======================================================================*/
+/*! 
+ *   Enable or disable the tiled overlap-save mode. In tiled mode the data
+ *   is filtered in FFT-friendly tiles using an OverlapSaveConvolver
+ *   instead of padding the whole Array. This needs much less memory and
+ *   is faster if the kernel is small compared to the data.
+ *
+ *   \param tiled  If true, use tiled overlap-save convolution
+ */
+/*======================================================================*/
+    void setTiled(bool tiled);
+
+/*======================================================================*/
+/*! 
+ *   Check whether the tiled overlap-save mode is enabled.
+ *
+ *   \return true if tiled mode is enabled, false otherwise
+ */
+/*======================================================================*/
+    bool tiled() const;
+
 /*======================================================================*/
 /*! 
  *   Apply the filter to the given Array.
@@ -197,7 +223,10 @@ namespace atb
   private:
   
     blitz::Array<DataT,Dim> const *p_kernel;
-    blitz::Array<std::complex<DataT>,Dim> _kernelFFTCache;    
+    mutable blitz::Array<std::complex<DataT>,Dim> _kernelFFTCache;
+
+    bool _tiled;
+    OverlapSaveConvolver<DataT,Dim> _overlapSave;
 
   };
 
@@ -0,0 +1,222 @@
+/**************************************************************************
+ *
+ * Copyright (C) 2015 Thorsten Falk
+ *
+ *        Image Analysis Lab, University of Freiburg, Germany
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ *
+ **************************************************************************/
+
+/*======================================================================*/
+/*!
+ *  \file FastCorrelationBank.hh
+ *  \brief Correlation of one data Array with banks of kernels using the
+ *    Fast Fourier Transform
+ */
+/*======================================================================*/
+
+#ifndef ATBFASTCORRELATIONBANK_HH
+#define ATBFASTCORRELATIONBANK_HH
+
+#ifdef HAVE_CONFIG_H
+#include <config.hh>
+#endif
+
+#include <vector>
+#include <limits>
+#include <sstream>
+
+#include "TypeTraits.hh"
+#include "BoundaryTreatment.hh"
+#include "LocalSumFilter.hh"
+#include "RuntimeError.hh"
+
+#include <libProgressReporter/ProgressReporter.hh>
+#include <libBlitzFFTW/BlitzFFTW.hh>
+
+namespace atb
+{
+
+/*======================================================================*/
+/*!
+ *  \class FastCorrelationBank FastCorrelationBank.hh "libArrayToolbox/FastCorrelationBank.hh"
+ *  \brief The FastCorrelationBank class correlates one data Array with
+ *    many kernels, transforming the data only once.
+ *
+ *  FastNormalizedCorrelationFilter and FastPhaseOnlyCorrelationFilter pad
+ *  and transform the data for every kernel they are applied with. When
+ *  a bank of templates (e.g. different radii or orientations) is matched
+ *  against the same data, setData() pads and transforms the data once.
+ *  Every kernel then only needs its own forward transform, one
+ *  multiplication in the frequency domain and the inverse transform.
+ *  For normalized cross-correlation the local sum and energy terms of the
+ *  data are computed once per kernel shape, so banks sorted by kernel
+ *  shape compute them only once per shape.
+ *
+ *  Normalized cross-correlations are identical to the ones of
+ *  FastNormalizedCorrelationFilter. Phase-only correlations depend on the
+ *  padded shape and are only identical to the ones of
+ *  FastPhaseOnlyCorrelationFilter if the kernel has the maximum kernel
+ *  shape. CropBT is not supported.
+ */
+/*======================================================================*/
+  template<typename DataT, int Dim>
+  class FastCorrelationBank
+  {
+
+  public:
+
+/*======================================================================*/
+/*!
+ *   \enum CorrelationType FastCorrelationBank.hh "libArrayToolbox/FastCorrelationBank.hh"
+ *   \brief The CorrelationType enum selects the correlation measure.
+ */
+/*======================================================================*/
+    enum CorrelationType { NormalizedCorrelation, PhaseOnlyCorrelation };
+
+/*======================================================================*/
+/*!
+ *   Default Constructor.
+ *
+ *   \param type           The correlation measure to compute
+ *   \param bt             The boundary treatment to use. CropBT is not
+ *     supported and will result in a RuntimeError when data is set.
+ *   \param boundaryValue  If bt is ValueBT, this value will be used for
+ *     out-of-Array access
+ */
+/*======================================================================*/
+    FastCorrelationBank(
+        CorrelationType type = NormalizedCorrelation,
+        BoundaryTreatmentType bt = ValueBT,
+        DataT const &boundaryValue = traits<DataT>::zero);
+
+/*======================================================================*/
+/*!
+ *   Destructor.
+ */
+/*======================================================================*/
+    ~FastCorrelationBank();
+
+/*======================================================================*/
+/*!
+ *   Get the correlation measure this bank computes.
+ *
+ *   \return The correlation type
+ */
+/*======================================================================*/
+    CorrelationType correlationType() const;
+
+/*======================================================================*/
+/*!
+ *   Pad and transform the data Array. Only a reference to the data is
+ *   kept for computing the local sums, so it must not be changed until
+ *   the next call to setData().
+ *
+ *   \param data            The data Array to correlate the kernels with
+ *   \param maxKernelShape  The elementwise maximum shape of all kernels
+ *     that will be correlated with this data
+ *   \param pr              If given progress will be reported to this
+ *     ProgressReporter
+ *
+ *   \exception RuntimeError If the boundary treatment is CropBT an
+ *     exception of this kind is thrown
+ */
+/*======================================================================*/
+    void setData(
+        blitz::Array<DataT,Dim> const &data,
+        blitz::TinyVector<BlitzIndexT,Dim> const &maxKernelShape,
+        iRoCS::ProgressReporter *pr = NULL);
+
+/*======================================================================*/
+/*!
+ *   Correlate the data with the given kernel.
+ *
+ *   \param kernel  The kernel. Its extents must not exceed the
+ *     maxKernelShape given to setData().
+ *   \param result  The correlation result. If it already has the shape of
+ *     the data it is filled in-place without allocation.
+ *
+ *   \exception RuntimeError If no data is set or the kernel is too big
+ *     an exception of this kind is thrown
+ */
+/*======================================================================*/
+    void correlate(
+        blitz::Array<DataT,Dim> const &kernel,
+        blitz::Array<DataT,Dim> &result);
+
+/*======================================================================*/
+/*!
+ *   Correlate the data with all given kernels and only keep the maximum
+ *   response and the index of the kernel producing it for every voxel.
+ *
+ *   \param kernels       The kernel bank. The kernel extents must not
+ *     exceed the maxKernelShape given to setData().
+ *   \param response      The maximum correlation over all kernels
+ *   \param bestTemplate  The index of the kernel with maximum correlation
+ *   \param pr            If given progress will be reported to this
+ *     ProgressReporter
+ *
+ *   \exception RuntimeError If no data is set or a kernel is too big
+ *     an exception of this kind is thrown
+ */
+/*======================================================================*/
+    void correlateMaximum(
+        std::vector< blitz::Array<DataT,Dim> > const &kernels,
+        blitz::Array<DataT,Dim> &response,
+        blitz::Array<int,Dim> &bestTemplate,
+        iRoCS::ProgressReporter *pr = NULL);
+
+  private:
+
+    FastCorrelationBank(FastCorrelationBank<DataT,Dim> const &);
+    FastCorrelationBank<DataT,Dim> &operator=(
+        FastCorrelationBank<DataT,Dim> const &);
+
+    // Leaves the unnormalized correlation with the kernel in _padded
+    void _correlateSpectrum(blitz::Array<DataT,Dim> const &kernel);
+
+    void _updateNormalization(
+        blitz::TinyVector<BlitzIndexT,Dim> const &kernelShape);
+
+    // Writes the normalized correlation into response or, if bestTemplate
+    // is given, updates the running maximum and its argument
+    void _collect(
+        blitz::Array<DataT,Dim> &response,
+        blitz::Array<int,Dim> *bestTemplate, int templateIndex) const;
+
+    CorrelationType _type;
+    BoundaryTreatment<DataT,Dim> *p_bt;
+
+    blitz::Array<DataT,Dim> _data;
+    blitz::TinyVector<BlitzIndexT,Dim> _maxKernelShape;
+    blitz::TinyVector<BlitzIndexT,Dim> _lb;
+
+    blitz::Array<DataT,Dim> _padded;
+    blitz::Array<std::complex<DataT>,Dim> _dataFFT;
+    blitz::Array<std::complex<DataT>,Dim> _spectrum;
+
+    blitz::TinyVector<BlitzIndexT,Dim> _normalizationShape;
+    blitz::Array<DataT,Dim> _normalization;
+
+    static DataT const eps;
+
+  };
+
+}
+
+#include "FastCorrelationBank.icc"
+
+#endif
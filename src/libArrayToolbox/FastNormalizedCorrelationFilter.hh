@@ -35,6 +35,7 @@
 #endif
 
 #include "Filter.hh"
+#include "OverlapSaveConvolver.hh"
 #include "LocalSumFilter.hh"
 
 #include <libBlitzFFTW/BlitzFFTW.hh>
@@ -57,6 +58,10 @@ namespace atb
  *  because it has to hold padded versions of the data Array, the kernel
  *  and the corresponding fourier transforms, therefore a memory overhead
  *  of factor 4 is the minimum, factor 6 to 8 is common.
+ *
+ *  With setTiled(true) the cross-correlation is computed with overlap-save
+ *  in FFT-friendly tiles, which reduces the memory overhead of the
+ *  correlation to a few tiles per thread.
  */
 /*======================================================================*/
   template<typename DataT, int Dim>
@@ -120,6 +125,28 @@ namespace atb
 /*======================================================================*/
     blitz::Array<DataT,Dim> const &kernel() const;
 
+/*======================================================================*/
+/*!
+ *   Enable or disable the tiled overlap-save mode. In tiled mode the
+ *   cross-correlation is computed in FFT-friendly tiles using an
+ *   OverlapSaveConvolver instead of padding the whole Array. This needs
+ *   much less memory and is faster if the kernel is small compared to the
+ *   data. The unpadded cyclic case is not affected.
+ *
+ *   \param tiled  If true, use tiled overlap-save correlation
+ */
+/*======================================================================*/
+    void setTiled(bool tiled);
+
+/*======================================================================*/
+/*!
+ *   Check whether the tiled overlap-save mode is enabled.
+ *
+ *   \return true if tiled mode is enabled, false otherwise
+ */
+/*======================================================================*/
+    bool tiled() const;
+
 /*======================================================================*/
 /*!
  *   Apply the filter to the given Array.
@@ -203,6 +230,9 @@ namespace atb
 
     mutable blitz::Array<std::complex<DataT>,Dim> _kernelFFTCache;
 
+    bool _tiled;
+    OverlapSaveConvolver<DataT,Dim> _overlapSave;
+
   };
 
 }
@@ -36,17 +36,143 @@
 #endif
 
 #include "SeparableConvolutionFilter.hh"
+#include "FastConvolutionFilter.hh"
 
 #include "ATBDataSynthesis.hh"
 
+#include <string>
+#include <vector>
+#include <limits>
+#include <cmath>
+#include <cstring>
+
 namespace atb
 {
 
+/*======================================================================*/
+/*! 
+ *   \enum GaussianFilterImplementation GaussianFilter.hh "libArrayToolbox/GaussianFilter.hh"
+ *   \brief The GaussianFilterImplementation enum contains entries for the
+ *     available implementations of Gaussian smoothing.
+ */
+/*======================================================================*/
+  enum GaussianFilterImplementation {
+      /** Direct convolution with the sampled Gaussian. The cost per
+       *  element grows linearly with the standard deviation. */
+      FIRGaussian = 0x0001,
+      /** Young-van Vliet third order recursive approximation. The cost per
+       *  element is constant, it is only available for standard
+       *  deviations of at least half a pixel and not for CropBT. */
+      IIRGaussian = 0x0002,
+      /** Convolution with the sampled Gaussian in the Fourier domain
+       *  (always applied to all dimensions at once). Only available for
+       *  float and double data and not for CropBT, FIRGaussian is used
+       *  instead otherwise. */
+      FFTGaussian = 0x0004,
+      /** Choose the cheapest of the above per dimension that meets the
+       *  requested accuracy. */
+      AutoGaussian = 0x0008
+  };
+
+/*======================================================================*/
+/*! 
+ *   Get a human readable name of the given Gaussian filter implementation,
+ *   e.g. for logging the automatic selection.
+ *
+ *   \param implementation The Gaussian filter implementation
+ *
+ *   \return The implementation name
+ */
+/*======================================================================*/
+  inline std::string gaussianFilterImplementationToString(
+      GaussianFilterImplementation implementation)
+  {
+    switch (implementation)
+    {
+    case FIRGaussian:
+      return "FIR";
+    case IIRGaussian:
+      return "IIR";
+    case FFTGaussian:
+      return "FFT";
+    default:
+      return "Auto";
+    }
+  }
+
+/*======================================================================*/
+/*!
+ *  \class GaussianFFTTraits GaussianFilter.hh "libArrayToolbox/GaussianFilter.hh"
+ *  \brief The GaussianFFTTraits class tells whether the FFTGaussian
+ *    implementation is available for the given data type.
+ *
+ *  The FFT convolution needs a BlitzFFTW plan specialization, which only
+ *  exists for float and double.
+ */
+/*======================================================================*/
+  template<typename DataT>
+  struct GaussianFFTTraits
+  {
+    static bool const available = false;
+  };
+
+  template<>
+  struct GaussianFFTTraits<float>
+  {
+    static bool const available = true;
+  };
+
+  template<>
+  struct GaussianFFTTraits<double>
+  {
+    static bool const available = true;
+  };
+
+/*======================================================================*/
+/*!
+ *  \class GaussianFFTConvolution GaussianFilter.hh "libArrayToolbox/GaussianFilter.hh"
+ *  \brief The GaussianFFTConvolution class applies the FFTGaussian
+ *    implementation if it is available for DataT.
+ *
+ *  Only the specialization for available data types instantiates the
+ *  FastConvolutionFilter, so that GaussianFilter can be used with all
+ *  other data types. The generic version throws a RuntimeError.
+ */
+/*======================================================================*/
+  template<typename DataT, int Dim,
+           bool Available = GaussianFFTTraits<DataT>::available>
+  struct GaussianFFTConvolution
+  {
+    static void apply(
+        blitz::Array<DataT,Dim> const &data,
+        blitz::TinyVector<double,Dim> const &elementSizeUm,
+        blitz::Array<DataT,Dim> const &kernel,
+        BoundaryTreatment<DataT,Dim> const &bt,
+        blitz::Array<DataT,Dim> &filtered, iRoCS::ProgressReporter *pr);
+  };
+
+  template<typename DataT, int Dim>
+  struct GaussianFFTConvolution<DataT,Dim,true>
+  {
+    static void apply(
+        blitz::Array<DataT,Dim> const &data,
+        blitz::TinyVector<double,Dim> const &elementSizeUm,
+        blitz::Array<DataT,Dim> const &kernel,
+        BoundaryTreatment<DataT,Dim> const &bt,
+        blitz::Array<DataT,Dim> &filtered, iRoCS::ProgressReporter *pr);
+  };
+
 /*======================================================================*/
 /*!
  *  \class GaussianFilter GaussianFilter.hh "libArrayToolbox/GaussianFilter.hh"
  *  \brief The GaussianFilter class implements the Filter interface and
  *    provides a Gaussian smoothing filter
+ *
+ *  By default the data are convolved with sampled Gaussian kernels, whose
+ *  cost grows linearly with the standard deviation. Alternatively a
+ *  recursive (IIR) or Fourier domain (FFT) implementation can be chosen,
+ *  or the filter selects the cheapest implementation meeting a given
+ *  accuracy for every dimension (AutoGaussian).
  */
 /*======================================================================*/
   template<typename DataT, int Dim>
@@ -142,6 +268,105 @@ namespace atb
     void setMinimumKernelShapePx(
         blitz::TinyVector<BlitzIndexT,Dim> const &minimumKernelShapePx);
 
+/*======================================================================*/
+/*! 
+ *   Get the implementation used by this filter.
+ *
+ *   \return The Gaussian filter implementation. If AutoGaussian is
+ *     returned, the actual implementations are chosen when applying the
+ *     filter, see selectImplementation().
+ */
+/*======================================================================*/
+    GaussianFilterImplementation implementation() const;
+
+/*======================================================================*/
+/*! 
+ *   Set the implementation used by this filter. The default is FIRGaussian.
+ *
+ *   \param implementation The Gaussian filter implementation
+ */
+/*======================================================================*/
+    void setImplementation(GaussianFilterImplementation implementation);
+
+/*======================================================================*/
+/*! 
+ *   Get the maximum error per dimension accepted by the automatic
+ *   implementation selection. The error is the L1 distance between the
+ *   impulse response of the implementation and the sampled Gaussian, which
+ *   bounds the absolute filter error relative to the maximum absolute
+ *   input value.
+ *
+ *   \return The maximum accepted error per dimension
+ */
+/*======================================================================*/
+    double maximumError() const;
+
+/*======================================================================*/
+/*! 
+ *   Set the maximum error per dimension accepted by the automatic
+ *   implementation selection. The default is 0.05.
+ *
+ *   \param maximumError The maximum accepted error per dimension
+ */
+/*======================================================================*/
+    void setMaximumError(double maximumError);
+
+/*======================================================================*/
+/*! 
+ *   Get the implementations that would be used when applying this filter
+ *   to an Array of the given shape and element size. If the filter is
+ *   set to AutoGaussian, the choice is based on an operation count
+ *   model for the given shape, the standard deviations in pixels,
+ *   the data type and boundary treatment, and the maximum accepted error.
+ *
+ *   \param shape         The data Array shape
+ *   \param elementSizeUm The element size of the data Array
+ *
+ *   \return The implementation for each dimension. It is never
+ *     AutoGaussian, and if it is FFTGaussian for one dimension it is
+ *     FFTGaussian for all dimensions.
+ */
+/*======================================================================*/
+    blitz::TinyVector<GaussianFilterImplementation,Dim> selectImplementation(
+        blitz::TinyVector<BlitzIndexT,Dim> const &shape,
+        blitz::TinyVector<double,Dim> const &elementSizeUm) const;
+
+/*======================================================================*/
+/*! 
+ *   Get the error bound of this filter when applied to an Array with the
+ *   given shape and element size using the implementations returned by
+ *   selectImplementation(). The bound is the sum of the per dimension
+ *   L1 distances between the impulse responses and the sampled Gaussian.
+ *
+ *   \param shape         The data Array shape
+ *   \param elementSizeUm The element size of the data Array
+ *
+ *   \return The bound of the absolute filter error relative to the maximum
+ *     absolute input value (boundary effects not included)
+ */
+/*======================================================================*/
+    double errorBound(
+        blitz::TinyVector<BlitzIndexT,Dim> const &shape,
+        blitz::TinyVector<double,Dim> const &elementSizeUm) const;
+
+/*======================================================================*/
+/*! 
+ *   Get the L1 distance between the impulse response of the given
+ *   implementation and the sampled Gaussian along one dimension.
+ *
+ *   \param implementation The Gaussian filter implementation, must not be
+ *     AutoGaussian
+ *   \param sigmaUm        The standard deviation in micrometers
+ *   \param elementSizeUm  The element size in micrometers
+ *   \param minExtent      The minimum FIR kernel extent in pixels
+ *
+ *   \return The L1 error of the one-dimensional impulse response
+ */
+/*======================================================================*/
+    static double errorBound(
+        GaussianFilterImplementation implementation, double sigmaUm,
+        double elementSizeUm, BlitzIndexT minExtent = 0);
+
 /*======================================================================*/
 /*! 
  *   Apply the filter to the given Array.
@@ -233,8 +458,48 @@ namespace atb
     static void _gaussian(
         atb::Array<DataT,1> &gauss, double sigmaUm, BlitzIndexT minExtent);
 
+    static void _recursiveGaussian(
+        DataT *line, ptrdiff_t length, double sigmaPx);
+
+    void _recursiveGaussianAlongDim(
+        blitz::Array<DataT,Dim> &data,
+        blitz::TinyVector<double,Dim> const &elementSizeUm, int dim,
+        iRoCS::ProgressReporter *pr) const;
+
+    template<typename BoundaryPolicyT>
+    void _recursiveGaussianAlongDim(
+        blitz::Array<DataT,Dim> &data, double sigmaPx, int dim,
+        BoundaryPolicyT const &bt, iRoCS::ProgressReporter *pr) const;
+
+    // Passed to BoundaryTreatmentFactory::dispatch() to call
+    // _recursiveGaussianAlongDim() with the matching boundary policy
+    class RecursiveGaussianDispatcher
+    {
+
+    public:
+
+      RecursiveGaussianDispatcher(
+          GaussianFilter<DataT,Dim> const &filter,
+          blitz::Array<DataT,Dim> &data, double sigmaPx, int dim,
+          iRoCS::ProgressReporter *pr);
+
+      template<typename BoundaryPolicyT>
+      void operator()(BoundaryPolicyT const &bt);
+
+    private:
+
+      GaussianFilter<DataT,Dim> const &_filter;
+      blitz::Array<DataT,Dim> &_data;
+      double _sigmaPx;
+      int _dim;
+      iRoCS::ProgressReporter *p_pr;
+
+    };
+
     blitz::TinyVector<double,Dim>  _standardDeviationUm;
     blitz::TinyVector<BlitzIndexT,Dim> _minimumKernelShapePx;
+    GaussianFilterImplementation _implementation;
+    double _maximumError;
 
   };
 
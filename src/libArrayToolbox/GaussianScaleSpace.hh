@@ -0,0 +1,181 @@
+/**************************************************************************
+ *
+ * Copyright (C) 2015 Thorsten Falk
+ *
+ *        Image Analysis Lab, University of Freiburg, Germany
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ *
+ **************************************************************************/
+
+/*======================================================================*/
+/*!
+ *  \file GaussianScaleSpace.hh
+ *  \brief Incremental computation of Gaussian scale-space levels
+ */
+/*======================================================================*/
+
+#ifndef ATBGAUSSIANSCALESPACE_HH
+#define ATBGAUSSIANSCALESPACE_HH
+
+#ifdef HAVE_CONFIG_H
+#include <config.hh>
+#endif
+
+#include "Array.hh"
+#include "GaussianFilter.hh"
+
+#include <map>
+
+namespace atb
+{
+
+/*======================================================================*/
+/*!
+ *  \class GaussianScaleSpace GaussianScaleSpace.hh "libArrayToolbox/GaussianScaleSpace.hh"
+ *  \brief The GaussianScaleSpace class computes Gaussian smoothed versions
+ *    of an Array for a set of standard deviations incrementally.
+ *
+ *  Levels are computed lazily on request. A new level is obtained from the
+ *  closest already computed level with smaller standard deviation by
+ *  smoothing with the incremental standard deviation
+ *  \f$\sqrt{\sigma^2 - \sigma_{\mathrm{prev}}^2}\f$, so requesting the
+ *  levels in increasing order costs only little more than one smoothing
+ *  at the finest scale.
+ *
+ *  Optionally the levels are downsampled octave-wise: Whenever the standard
+ *  deviation of a level reaches two elements along a dimension, every second
+ *  element along that dimension is dropped and the element size doubles.
+ *  Subsequent levels are computed from the reduced Array.
+ *
+ *  Levels are returned as Array views sharing their memory with the
+ *  internal cache. Views stay valid when levels are evicted from the cache
+ *  or the scale space is destroyed, but must not be modified.
+ */
+/*======================================================================*/
+  template<typename DataT, int Dim>
+  class GaussianScaleSpace
+  {
+
+  public:
+
+/*======================================================================*/
+/*!
+ *   Constructor. The scale space keeps a view of the given data Array.
+ *
+ *   \param data               The Array to compute the scale space of. Its
+ *     element size defines the unit of the standard deviations.
+ *   \param downsampleOctaves  If \c true, coarse levels are downsampled
+ *     octave-wise
+ *   \param btType             The boundary treatment for smoothing
+ *   \param boundaryValue      The out-of-Array value for ValueBT
+ */
+/*======================================================================*/
+    GaussianScaleSpace(
+        Array<DataT,Dim> const &data, bool downsampleOctaves = false,
+        BoundaryTreatmentType btType = RepeatBT,
+        DataT const &boundaryValue = traits<DataT>::zero);
+
+/*======================================================================*/
+/*!
+ *   Destructor.
+ */
+/*======================================================================*/
+    ~GaussianScaleSpace();
+
+/*======================================================================*/
+/*!
+ *   Get the implementation of the Gaussian filter used to compute the
+ *   incremental smoothing steps.
+ *
+ *   \return The Gaussian filter implementation
+ */
+/*======================================================================*/
+    GaussianFilterImplementation implementation() const;
+
+/*======================================================================*/
+/*!
+ *   Set the implementation of the Gaussian filter used to compute the
+ *   incremental smoothing steps. The default is FIRGaussian.
+ *
+ *   \param implementation The Gaussian filter implementation
+ */
+/*======================================================================*/
+    void setImplementation(GaussianFilterImplementation implementation);
+
+/*======================================================================*/
+/*!
+ *   Get the maximum number of levels kept in the cache.
+ *
+ *   \return The maximum number of cached levels, 0 means unlimited
+ */
+/*======================================================================*/
+    size_t maximumCachedLevels() const;
+
+/*======================================================================*/
+/*!
+ *   Set the maximum number of levels kept in the cache. If more levels
+ *   are computed, the levels with smallest standard deviation are evicted
+ *   first. A value of 1 is sufficient if the levels are requested in
+ *   increasing order.
+ *
+ *   \param maximumCachedLevels The maximum number of cached levels, 0 means
+ *     unlimited (default)
+ */
+/*======================================================================*/
+    void setMaximumCachedLevels(size_t maximumCachedLevels);
+
+/*======================================================================*/
+/*!
+ *   Get the scale-space level with the given standard deviation. If the
+ *   level is not cached it is computed from the closest cached level
+ *   below.
+ *
+ *   \param sigmaUm  The standard deviation of the level in micrometers
+ *   \param pr       Progress will be reported through the given
+ *     iRoCS::ProgressReporter
+ *
+ *   \return A view of the level. Its element size differs from the one of
+ *     the input Array if octave-wise downsampling is enabled.
+ */
+/*======================================================================*/
+    Array<DataT,Dim> level(
+        double sigmaUm, iRoCS::ProgressReporter *pr = NULL);
+
+/*======================================================================*/
+/*!
+ *   Remove all levels from the cache.
+ */
+/*======================================================================*/
+    void clear();
+
+  private:
+
+    Array<DataT,Dim> _data;
+    bool _downsampleOctaves;
+    BoundaryTreatmentType _btType;
+    DataT _boundaryValue;
+    GaussianFilterImplementation _implementation;
+    size_t _maximumCachedLevels;
+
+    std::map< double, Array<DataT,Dim> > _levels;
+
+  };
+
+}
+
+#include "GaussianScaleSpace.icc"
+
+#endif
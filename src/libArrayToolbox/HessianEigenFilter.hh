@@ -0,0 +1,223 @@
+/**************************************************************************
+ *
+ * Copyright (C) 2015 Thorsten Falk
+ *
+ *        Image Analysis Lab, University of Freiburg, Germany
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ *
+ **************************************************************************/
+
+/*======================================================================*/
+/*!
+ *  \file HessianEigenFilter.hh
+ *  \brief Fused computation of the hessian and its eigen decomposition
+ */
+/*======================================================================*/
+
+#ifndef ATBHESSIANEIGENFILTER_HH
+#define ATBHESSIANEIGENFILTER_HH
+
+#ifdef HAVE_CONFIG_H
+#include <config.hh>
+#endif
+
+#include <vector>
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "Filter.hh"
+#include "ATBLinAlg.hh"
+
+namespace atb
+{
+
+/*======================================================================*/
+/*!
+ *  \class HessianEigenFilter HessianEigenFilter.hh "libArrayToolbox/HessianEigenFilter.hh"
+ *  \brief The HessianEigenFilter class implements the Filter interface and
+ *    computes the eigenvalues (and optionally eigenvectors) of the hessian
+ *    of the input data without storing the hessian itself.
+ *
+ *  The hessian is approximated with second order central differences like
+ *  in CentralHessianUTFilter. The filter runs line by line along the
+ *  innermost dimension. For every line the 3^(Dim-1) neighbouring lines
+ *  are copied into a padded stencil buffer, the hessian entries of the
+ *  line are evaluated from that buffer and the eigenvalues are computed
+ *  in closed form for 2-D and 3-D data. Other dimensionalities use the
+ *  generic eigenvalueDecompositionRealSymmetric().
+ *
+ *  For boundary treatments providing indices (CyclicBT, RepeatBT, MirrorBT)
+ *  the hessian is identical to the one computed by CentralHessianUTFilter.
+ *  For ValueBT mixed derivatives at the Array boundary are computed from
+ *  the value-extended data instead of value-extending the first
+ *  derivatives. CropBT is not supported.
+ *
+ *  The eigenvalues are always sorted ascending.
+ */
+/*======================================================================*/
+  template<typename DataT, int Dim>
+  class HessianEigenFilter :
+        public Filter<DataT,Dim,blitz::TinyVector<DataT,Dim> >
+  {
+
+  public:
+
+    typedef blitz::TinyVector<DataT,Dim> ResultT;
+
+/*======================================================================*/
+/*!
+ *   Default Constructor.
+ *
+ *   \param bt             The boundary treatment this filter uses
+ *   \param boundaryValue  If bt is ValueBT, this value will be used for
+ *     out-of-Array access
+ */
+/*======================================================================*/
+    HessianEigenFilter(
+        BoundaryTreatmentType bt = MirrorBT,
+        DataT const &boundaryValue = traits<DataT>::zero);
+
+/*======================================================================*/
+/*!
+ *   Destructor.
+ */
+/*======================================================================*/
+    ~HessianEigenFilter();
+
+/*======================================================================*/
+/*!
+ *   Compute the ascending hessian eigenvalues of the given Array.
+ *
+ *   \param data          The blitz++ Array to apply the filter to
+ *   \param elementSizeUm The element size of the Array
+ *   \param filtered      The hessian eigenvalues
+ *   \param pr            If given progress will be reported to this
+ *     ProgressReporter
+ *
+ *   \exception RuntimeError If an error occurs during the filter operation
+ *     an exception of this kind is thrown
+ */
+/*======================================================================*/
+    void apply(
+        blitz::Array<DataT,Dim> const &data,
+        blitz::TinyVector<double,Dim> const &elementSizeUm,
+        blitz::Array<ResultT,Dim> &filtered,
+        iRoCS::ProgressReporter *pr = NULL) const;
+
+    // Explicitly force the name mangler to also consider the base class
+    // implementation
+    using atb::Filter<DataT,Dim,ResultT>::apply;
+
+/*======================================================================*/
+/*!
+ *   Compute the hessian eigen decomposition of the given Array and pass
+ *   it voxel by voxel to the given visitor. Only what the visitor uses has
+ *   to be stored.
+ *
+ *   The visitor must provide a static boolean constant
+ *   \c needsEigenvectors and the function call operator
+ *
+ *   \code
+ *   void operator()(ptrdiff_t i, blitz::TinyVector<double,Dim> const &lambda,
+ *                   blitz::TinyMatrix<double,Dim,Dim> const &U);
+ *   \endcode
+ *
+ *   i is the row-major linear index of the voxel, lambda contains the
+ *   ascending eigenvalues and the columns of U the corresponding
+ *   eigenvectors. If \c needsEigenvectors is false, U is left
+ *   uninitialized. The operator is called concurrently for different
+ *   voxels if OpenMP is enabled.
+ *
+ *   \param data          The blitz++ Array to decompose the hessian of
+ *   \param elementSizeUm The element size of the Array
+ *   \param visitor       The visitor receiving the decompositions
+ *   \param pr            If given progress will be reported to this
+ *     ProgressReporter
+ *
+ *   \exception RuntimeError If an error occurs during the filter operation
+ *     an exception of this kind is thrown
+ */
+/*======================================================================*/
+    template<typename VisitorT>
+    void decompose(
+        blitz::Array<DataT,Dim> const &data,
+        blitz::TinyVector<double,Dim> const &elementSizeUm,
+        VisitorT &visitor, iRoCS::ProgressReporter *pr = NULL) const;
+
+  private:
+
+    template<typename VisitorT, typename BoundaryPolicyT>
+    void _decompose(
+        blitz::Array<DataT,Dim> const &data,
+        blitz::TinyVector<double,Dim> const &elementSizeUm,
+        VisitorT &visitor, BoundaryPolicyT const &bt,
+        iRoCS::ProgressReporter *pr) const;
+
+    template<typename VisitorT>
+    class DecompositionDispatcher
+    {
+
+    public:
+
+      DecompositionDispatcher(
+          HessianEigenFilter<DataT,Dim> const &filter,
+          blitz::Array<DataT,Dim> const &data,
+          blitz::TinyVector<double,Dim> const &elementSizeUm,
+          VisitorT &visitor, iRoCS::ProgressReporter *pr);
+
+      template<typename BoundaryPolicyT>
+      void operator()(BoundaryPolicyT const &bt);
+
+    private:
+
+      HessianEigenFilter<DataT,Dim> const &_filter;
+      blitz::Array<DataT,Dim> const &_data;
+      blitz::TinyVector<double,Dim> const &_elementSizeUm;
+      VisitorT &_visitor;
+      iRoCS::ProgressReporter *p_pr;
+
+    };
+
+    // Writes the eigenvalues into a contiguous result Array
+    class EigenvalueWriter
+    {
+
+    public:
+
+      static bool const needsEigenvectors = false;
+
+      EigenvalueWriter(ResultT *out);
+
+      void operator()(
+          ptrdiff_t i, blitz::TinyVector<double,Dim> const &lambda,
+          blitz::TinyMatrix<double,Dim,Dim> const &U);
+
+    private:
+
+      ResultT *p_out;
+
+    };
+
+  };
+
+}
+
+#include "HessianEigenFilter.icc"
+
+#endif
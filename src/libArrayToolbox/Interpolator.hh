@@ -202,6 +202,63 @@ namespace atb
         blitz::Array<DataT,Dim> const &data,
         blitz::TinyVector<double,Dim> const &pos) const = 0;
 
+/*======================================================================*/
+/*! 
+ *   Get the Array values at the given sub-pixel positions. For out-of-Array
+ *   coordinates the corresponding boundary treatment will be applied.
+ *
+ *   The default implementation calls get() for every position. The
+ *   nearest neighbor and linear interpolators resolve the boundary
+ *   treatment once per call and process the positions in vectorizable
+ *   blocks.
+ *
+ *   \param data        The Array to read the values from
+ *   \param positions   The positions to read
+ *   \param nPositions  The number of positions
+ *   \param out         The output buffer of at least nPositions elements
+ */
+/*======================================================================*/
+    virtual void getBatch(
+        blitz::Array<DataT,Dim> const &data,
+        blitz::TinyVector<double,Dim> const *positions, size_t nPositions,
+        DataT *out) const;
+
+/*======================================================================*/
+/*! 
+ *   Get the Array values on a regular affine two-dimensional sampling
+ *   grid. The value at position origin + r * rowStep + c * columnStep
+ *   is written to out[r * nColumns + c]. A single line is sampled by
+ *   passing nRows = 1, grids of higher dimension can be sampled as
+ *   stack of planes.
+ *
+ *   \param data        The Array to read the values from
+ *   \param origin      The position of grid sample (0, 0)
+ *   \param rowStep     The position offset between consecutive rows
+ *   \param nRows       The number of rows
+ *   \param columnStep  The position offset between consecutive columns
+ *   \param nColumns    The number of columns
+ *   \param out         The output buffer of at least nRows * nColumns
+ *     elements
+ */
+/*======================================================================*/
+    virtual void getGrid(
+        blitz::Array<DataT,Dim> const &data,
+        blitz::TinyVector<double,Dim> const &origin,
+        blitz::TinyVector<double,Dim> const &rowStep, size_t nRows,
+        blitz::TinyVector<double,Dim> const &columnStep, size_t nColumns,
+        DataT *out) const;
+
+/*======================================================================*/
+/*! 
+ *   Drop all data dependent state cached by this Interpolator. This must
+ *   be called after modifying the values of an Array that was already
+ *   sampled with this Interpolator. atb::Array does this automatically
+ *   in its modifying member functions. The default implementation does
+ *   nothing.
+ */
+/*======================================================================*/
+    virtual void invalidateCache();
+
   protected:
     
     BoundaryTreatment<DataT,Dim> *p_bt;
@@ -299,6 +356,28 @@ namespace atb
     DataT get(
         blitz::Array<DataT,Dim> const &data,
         blitz::TinyVector<double,Dim> const &pos) const;
+
+/*======================================================================*/
+/*! 
+ *   \see Interpolator::getBatch()
+ */
+/*======================================================================*/
+    void getBatch(
+        blitz::Array<DataT,Dim> const &data,
+        blitz::TinyVector<double,Dim> const *positions, size_t nPositions,
+        DataT *out) const;
+
+/*======================================================================*/
+/*! 
+ *   \see Interpolator::getGrid()
+ */
+/*======================================================================*/
+    void getGrid(
+        blitz::Array<DataT,Dim> const &data,
+        blitz::TinyVector<double,Dim> const &origin,
+        blitz::TinyVector<double,Dim> const &rowStep, size_t nRows,
+        blitz::TinyVector<double,Dim> const &columnStep, size_t nColumns,
+        DataT *out) const;
   };
   
 /*======================================================================*/
@@ -392,6 +471,28 @@ namespace atb
     DataT get(
         blitz::Array<DataT,Dim> const &data,
         blitz::TinyVector<double,Dim> const &pos) const;
+
+/*======================================================================*/
+/*! 
+ *   \see Interpolator::getBatch()
+ */
+/*======================================================================*/
+    void getBatch(
+        blitz::Array<DataT,Dim> const &data,
+        blitz::TinyVector<double,Dim> const *positions, size_t nPositions,
+        DataT *out) const;
+
+/*======================================================================*/
+/*! 
+ *   \see Interpolator::getGrid()
+ */
+/*======================================================================*/
+    void getGrid(
+        blitz::Array<DataT,Dim> const &data,
+        blitz::TinyVector<double,Dim> const &origin,
+        blitz::TinyVector<double,Dim> const &rowStep, size_t nRows,
+        blitz::TinyVector<double,Dim> const &columnStep, size_t nColumns,
+        DataT *out) const;
   };
 
 /*======================================================================*/
@@ -485,6 +586,99 @@ namespace atb
     DataT get(
         blitz::Array<DataT,Dim> const &data,
         blitz::TinyVector<double,Dim> const &pos) const;
+
+/*======================================================================*/
+/*! 
+ *   \see Interpolator::getBatch()
+ */
+/*======================================================================*/
+    void getBatch(
+        blitz::Array<DataT,Dim> const &data,
+        blitz::TinyVector<double,Dim> const *positions, size_t nPositions,
+        DataT *out) const;
+
+/*======================================================================*/
+/*! 
+ *   \see Interpolator::getGrid()
+ */
+/*======================================================================*/
+    void getGrid(
+        blitz::Array<DataT,Dim> const &data,
+        blitz::TinyVector<double,Dim> const &origin,
+        blitz::TinyVector<double,Dim> const &rowStep, size_t nRows,
+        blitz::TinyVector<double,Dim> const &columnStep, size_t nColumns,
+        DataT *out) const;
+
+/*======================================================================*/
+/*! 
+ *   Check whether cubic B-spline interpolation of prefiltered data is
+ *   used instead of local cubic convolution.
+ *
+ *   \return true if B-spline interpolation is used, false otherwise
+ */
+/*======================================================================*/
+    bool bSplinePrefilter() const;
+
+/*======================================================================*/
+/*! 
+ *   Enable or disable cubic B-spline interpolation.
+ *
+ *   If enabled, the sampled Array is prefiltered once into cubic B-spline
+ *   coefficients, which are cached in this Interpolator and reused as
+ *   long as the same Array is sampled and invalidateCache() is not
+ *   called. Interpolation then evaluates the B-spline with separable
+ *   weights. The result is smoother and more accurate than local cubic
+ *   convolution at the cost of one coefficient Array of high precision
+ *   type.
+ *
+ *   The cache is keyed on the memory and layout of the sampled Array, not
+ *   on its values. After changing values of an Array that was already
+ *   sampled, call invalidateCache(), otherwise the stale coefficients are
+ *   interpolated. atb::Array does this in its modifying member functions,
+ *   but not for writes through data() or element access.
+ *
+ *   The prefilter assumes mirrored (for CyclicBT cyclic) boundary
+ *   conditions, other boundary treatments are applied to the
+ *   coefficients. For them values within two voxels of the Array
+ *   boundary are approximate.
+ *
+ *   Do not sample different Arrays concurrently with the same
+ *   Interpolator in this mode.
+ *
+ *   \param bSplinePrefilter  Pass true to enable B-spline interpolation
+ */
+/*======================================================================*/
+    void setBSplinePrefilter(bool bSplinePrefilter);
+
+/*======================================================================*/
+/*! 
+ *   Drop the cached B-spline coefficients. They are recomputed on the next
+ *   access. This must be called after modifying the values of the sampled
+ *   Array, see setBSplinePrefilter().
+ */
+/*======================================================================*/
+    void invalidateCache();
+
+  private:
+
+    typedef typename traits<DataT>::HighPrecisionT CoefficientT;
+
+    bool _coefficientsUpToDate(blitz::Array<DataT,Dim> const &data) const;
+
+    // Recompute the B-spline coefficients if they were not computed for
+    // the given Array yet
+    void _updateCoefficients(blitz::Array<DataT,Dim> const &data) const;
+
+    static void _prefilterLine(CoefficientT *c, ptrdiff_t n, bool cyclic);
+
+    bool _bSplinePrefilter;
+
+    mutable blitz::Array<CoefficientT,Dim> _coefficients;
+    mutable bool _coefficientsValid;
+    mutable DataT const *_coefficientsData;
+    mutable blitz::TinyVector<BlitzIndexT,Dim> _coefficientsShape;
+    mutable blitz::TinyVector<BlitzIndexT,Dim> _coefficientsStride;
+    mutable bool _coefficientsCyclic;
   };
 
 
@@ -766,6 +960,251 @@ namespace atb
         blitz::TinyVector<double,Dim> const &pos) const;
   };
 
+/*======================================================================*/
+/*!
+ *  \class BatchInterpolation Interpolator.hh "libArrayToolbox/Interpolator.hh"
+ *  \brief The BatchInterpolation class implements the batch sampling
+ *    behind Interpolator::getBatch() and Interpolator::getGrid() for the
+ *    nearest neighbor and linear interpolators.
+ *
+ *  Objects of this class are passed to
+ *  BoundaryTreatmentFactory::dispatch(), which calls them once with the
+ *  boundary policy matching the interpolator's boundary treatment. The
+ *  sample positions are then processed in blocks of BlockSize samples
+ *  with the coordinates stored per dimension. Integer positions, weights
+ *  and memory offsets of a block are computed in vectorizable loops,
+ *  the interpolation of all samples is done assuming in-Array positions,
+ *  and only the samples with out-of-Array support are recomputed using
+ *  the inlined boundary policy.
+ *
+ *  \tparam DataT  The Array value type
+ *  \tparam Dim    The Array dimensionality
+ *  \tparam IPType The interpolation type, either NearestIP or LinearIP
+ */
+/*======================================================================*/
+  template<typename DataT, int Dim, InterpolationType IPType>
+  class BatchInterpolation
+  {
+
+  public:
+
+    static ptrdiff_t const BlockSize = 64;
+
+/*======================================================================*/
+/*! 
+ *   Set up sampling at arbitrary positions.
+ *
+ *   \see Interpolator::getBatch()
+ */
+/*======================================================================*/
+    BatchInterpolation(
+        blitz::Array<DataT,Dim> const &data,
+        blitz::TinyVector<double,Dim> const *positions, size_t nPositions,
+        DataT *out);
+
+/*======================================================================*/
+/*! 
+ *   Set up sampling on an affine grid.
+ *
+ *   \see Interpolator::getGrid()
+ */
+/*======================================================================*/
+    BatchInterpolation(
+        blitz::Array<DataT,Dim> const &data,
+        blitz::TinyVector<double,Dim> const &origin,
+        blitz::TinyVector<double,Dim> const &rowStep, size_t nRows,
+        blitz::TinyVector<double,Dim> const &columnStep, size_t nColumns,
+        DataT *out);
+
+/*======================================================================*/
+/*! 
+ *   Sample all positions using the given boundary policy.
+ *
+ *   \param bt  The boundary policy
+ */
+/*======================================================================*/
+    template<typename BoundaryPolicyT>
+    void operator()(BoundaryPolicyT const &bt);
+
+  private:
+
+    template<typename BoundaryPolicyT>
+    void _sampleBlock(
+        double coords[][BlockSize], ptrdiff_t n, DataT *out,
+        BoundaryPolicyT const &bt) const;
+
+    static DataT _round(typename traits<DataT>::HighPrecisionT const &value);
+
+    blitz::Array<DataT,Dim> const &_data;
+    blitz::TinyVector<double,Dim> const *_positions;
+    size_t _nPositions;
+    blitz::TinyVector<double,Dim> _origin, _rowStep, _columnStep;
+    size_t _nRows, _nColumns;
+    DataT *_out;
+
+  };
+
+/*======================================================================*/
+/*!
+ *  \class CubicBatchInterpolation Interpolator.hh "libArrayToolbox/Interpolator.hh"
+ *  \brief The CubicBatchInterpolation class implements the batch sampling
+ *    of the CubicInterpolator.
+ *
+ *  Like BatchInterpolation it is called once per batch with the boundary
+ *  policy by BoundaryTreatmentFactory::dispatch(). The four weights and
+ *  memory offsets per dimension are computed separately for every
+ *  sample; when sampling a grid, those of dimensions the grid rows do not
+ *  advance in are computed only once per row. The samples are either
+ *  read from the Array directly (cubic convolution) or from the cached
+ *  B-spline coefficients.
+ */
+/*======================================================================*/
+  template<typename DataT, int Dim>
+  class CubicBatchInterpolation
+  {
+
+  public:
+
+    typedef typename traits<DataT>::HighPrecisionT CoefficientT;
+
+/*======================================================================*/
+/*! 
+ *   Set up sampling at arbitrary positions.
+ *
+ *   \param coefficients  The B-spline coefficients of data or NULL for
+ *     cubic convolution of data
+ *
+ *   \see Interpolator::getBatch()
+ */
+/*======================================================================*/
+    CubicBatchInterpolation(
+        blitz::Array<DataT,Dim> const &data,
+        blitz::Array<CoefficientT,Dim> const *coefficients,
+        blitz::TinyVector<double,Dim> const *positions, size_t nPositions,
+        DataT *out);
+
+/*======================================================================*/
+/*! 
+ *   Set up sampling on an affine grid.
+ *
+ *   \param coefficients  The B-spline coefficients of data or NULL for
+ *     cubic convolution of data
+ *
+ *   \see Interpolator::getGrid()
+ */
+/*======================================================================*/
+    CubicBatchInterpolation(
+        blitz::Array<DataT,Dim> const &data,
+        blitz::Array<CoefficientT,Dim> const *coefficients,
+        blitz::TinyVector<double,Dim> const &origin,
+        blitz::TinyVector<double,Dim> const &rowStep, size_t nRows,
+        blitz::TinyVector<double,Dim> const &columnStep, size_t nColumns,
+        DataT *out);
+
+/*======================================================================*/
+/*! 
+ *   Sample all positions using the given boundary policy.
+ *
+ *   \param bt  The boundary policy
+ */
+/*======================================================================*/
+    template<typename BoundaryPolicyT>
+    void operator()(BoundaryPolicyT const &bt);
+
+  private:
+
+    template<typename SourceT, typename BoundaryPolicyT>
+    void _sample(SourceT const *base, BoundaryPolicyT const &bt);
+
+    // Compute weights and memory offsets of the four taps in dimension d
+    // for the given coordinate. Taps without valid index (value boundary
+    // treatment) get the offset -1.
+    template<typename BoundaryPolicyT>
+    void _taps(int d, double x, double *w, ptrdiff_t *offset,
+               BoundaryPolicyT const &bt) const;
+
+    template<typename SourceT>
+    CoefficientT _evaluate(
+        SourceT const *base, double const w[][4],
+        ptrdiff_t const offset[][4], CoefficientT const &boundaryValue) const;
+
+    static CoefficientT _boundaryValue(
+        ValueBoundaryPolicy<DataT,Dim> const &bt);
+
+    template<typename BoundaryPolicyT>
+    static CoefficientT _boundaryValue(BoundaryPolicyT const &);
+
+    static DataT _round(CoefficientT const &value);
+
+    blitz::Array<DataT,Dim> const &_data;
+    blitz::Array<CoefficientT,Dim> const *p_coefficients;
+    blitz::TinyVector<double,Dim> const *_positions;
+    size_t _nPositions;
+    blitz::TinyVector<double,Dim> _origin, _rowStep, _columnStep;
+    size_t _nRows, _nColumns;
+    DataT *_out;
+
+  };
+
+/*======================================================================*/
+/*!
+ *  \class AdjacentValueGather Interpolator.hh "libArrayToolbox/Interpolator.hh"
+ *  \brief The AdjacentValueGather class reads the grid neighborhood of a
+ *    single sample position for the per-sample Interpolator::get()
+ *    implementations.
+ *
+ *  Interpolators read in-Array neighborhoods directly. Only if the
+ *  neighborhood leaves the Array this class is passed to
+ *  BoundaryTreatmentFactory::dispatch(), so that all support values are
+ *  read with one boundary treatment dispatch instead of one virtual call
+ *  per value. The neighborhood spans support grid positions per
+ *  dimension starting at lowerBound + first. Value i of the output
+ *  corresponds to the offsets k_d with i = sum_d k_d * support^d, i.e.
+ *  the offset along dimension 0 varies fastest.
+ */
+/*======================================================================*/
+  template<typename DataT, int Dim>
+  class AdjacentValueGather
+  {
+
+  public:
+
+/*======================================================================*/
+/*! 
+ *   Constructor.
+ *
+ *   \param data        The Array to read from
+ *   \param lowerBound  The grid position below the sample position
+ *   \param first       The offset of the first neighbor relative to
+ *     lowerBound, e.g. -1 for cubic interpolation
+ *   \param support     The number of neighbors per dimension (at most 4)
+ *   \param values      The output buffer for the support^Dim values
+ */
+/*======================================================================*/
+    AdjacentValueGather(
+        blitz::Array<DataT,Dim> const &data,
+        blitz::TinyVector<ptrdiff_t,Dim> const &lowerBound, int first,
+        int support, DataT *values);
+
+/*======================================================================*/
+/*! 
+ *   Read the neighborhood values using the given boundary policy.
+ *
+ *   \param bt  The boundary policy
+ */
+/*======================================================================*/
+    template<typename BoundaryPolicyT>
+    void operator()(BoundaryPolicyT const &bt);
+
+  private:
+
+    blitz::Array<DataT,Dim> const &_data;
+    blitz::TinyVector<ptrdiff_t,Dim> _lowerBound;
+    int _first, _support;
+    DataT *_values;
+
+  };
+
 /*======================================================================*/
 /*!
  *  \class InterpolatorFactory Interpolator.hh "libArrayToolbox/Interpolator.hh"
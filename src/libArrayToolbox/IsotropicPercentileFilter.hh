@@ -27,14 +27,15 @@
  */
 /*======================================================================*/
 
-#ifndef ATBISOTROPICMEDIANFILTER_HH
-#define ATBISOTROPICMEDIANFILTER_HH
+#ifndef ATBISOTROPICPERCENTILEFILTER_HH
+#define ATBISOTROPICPERCENTILEFILTER_HH
 
 #ifdef HAVE_CONFIG_H
 #include <config.hh>
 #endif
 
 #include "Filter.hh"
+#include "SlidingWindowRank.hh"
 
 namespace atb
 {
@@ -50,6 +51,13 @@ namespace atb
  *  the median element. A percentile filter with percentile 50 is equivalent
  *  to the median filter, a percentile value of 0 results in a minimum filter
  *  and a percentile value of 100 in a maximum filter.
+ *
+ *  The spherical window is moved along the innermost dimension. Per step
+ *  only the voxels of the trailing and leading caps of the voxelized sphere
+ *  are removed from and added to a SlidingWindowRank structure, so the cost
+ *  per voxel grows with the square of the radius instead of its cube.
+ *  8 and 16 Bit integer data use a sliding histogram, all other types a
+ *  blocked sorted list.
  */
 /*======================================================================*/
   template<typename DataT, int Dim>
@@ -155,7 +163,8 @@ namespace atb
     static void apply(
         blitz::Array<DataT,Dim> const &data,
         blitz::Array<ResultT,Dim> &filtered,
-        double radiusUm, iRoCS::ProgressReporter *pr = NULL);
+        double radiusUm, double percentile,
+        iRoCS::ProgressReporter *pr = NULL);
 
   private:
     
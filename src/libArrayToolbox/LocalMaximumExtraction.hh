@@ -27,17 +27,50 @@
 #include <config.hh>
 #endif
 
+#include <vector>
+#include <list>
+#include <algorithm>
+#include <cmath>
+
+#include "TypeTraits.hh"
+
 #include <libProgressReporter/ProgressReporter.hh>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace atb
 {
 
   enum NHood { SIMPLE_NHOOD, COMPLEX_NHOOD };
 
+/*======================================================================*/
+/*!
+ *  \struct LocalMaximum LocalMaximumExtraction.hh "libArrayToolbox/LocalMaximumExtraction.hh"
+ *  \brief A local maximum found by extractLocalMaximaNMS().
+ */
+/*======================================================================*/
+  template<typename Type, int Dim>
+  struct LocalMaximum
+  {
+    /*! The voxel position of the maximum */
+    blitz::TinyVector<BlitzIndexT,Dim> voxel;
+
+    /*! The voxel position, sub-voxel refined if requested */
+    blitz::TinyVector<double,Dim> position;
+
+    /*! The value at the maximum, interpolated if sub-voxel refined */
+    Type value;
+  };
+
 /*======================================================================*/
 /*! 
  *   Extraction of local maxima of a blitz::Array
  *
+ *   Every thread collects the maxima of its part of the Array, they are
+ *   appended in scan order when all threads finished.
+ *
  *   \param data        The blitz::Array to search maxima in
  *   \param localMaxima A list of TinyVectors, the local Minima are
  *                      appended to
@@ -142,6 +175,63 @@ namespace atb
                      NHood nh = COMPLEX_NHOOD,
                      iRoCS::ProgressReporter *progress = NULL);
 
+/*======================================================================*/
+/*!
+ *   Extraction of local maxima of a blitz::Array using block based
+ *   non-maximum suppression.
+ *
+ *   The Array is first filtered with a separable maximum filter of
+ *   extent 2 * radius + 1 (van Herk/Gil-Werman, three comparisons per
+ *   voxel and dimension independent of the radius). A voxel is a local
+ *   maximum if it equals the filtered value, i.e. no voxel within the
+ *   box is greater. In contrast to extractLocalMaxima() plateaus yield
+ *   one maximum per plateau voxel (use minDistance to thin them out) and
+ *   voxels at the Array boundary can be maxima unless excludeBoundary is
+ *   set, out-of-Array values are treated as -infinity. Every thread
+ *   collects its maxima into its own vector, they are merged in scan order
+ *   afterwards.
+ *
+ *   The maxima are returned sorted by decreasing value. If minDistance
+ *   is positive, maxima closer than minDistance to a stronger maximum
+ *   are greedily suppressed. If maxCount is positive, only the maxCount
+ *   strongest (remaining) maxima are returned.
+ *
+ *   \param data         The blitz::Array to search maxima in. It must be
+ *     stored contiguously.
+ *   \param localMaxima  The vector the local maxima are written to. Old
+ *     contents are discarded.
+ *   \param radius       The half extent of the suppression box in voxels
+ *   \param minValue     Only local maxima with value not below minValue
+ *     are returned
+ *   \param elementSize  The element size used to compute distances for
+ *     the minimum distance constraint
+ *   \param minDistance  The minimum distance between returned maxima in
+ *     units of the elementSize. 0 disables the constraint.
+ *   \param maxCount     The maximum number of maxima to return. 0 returns
+ *     all maxima.
+ *   \param subVoxel     If true, the maxima are refined to sub-voxel
+ *     precision by fitting a parabola through the maximum and its direct
+ *     neighbours along each axis
+ *   \param excludeBoundary If true, voxels at the Array boundary are not
+ *     reported as maxima, like in extractLocalMaxima()
+ *   \param progress     If desired a progress reporter can be attached.
+ *      All output will be redirected to the progress reporter and the
+ *      progress will be updated regularly
+ */
+/*======================================================================*/
+  template<typename Type, int Dim>
+  void
+  extractLocalMaximaNMS(
+      blitz::Array<Type,Dim> const &data,
+      std::vector< LocalMaximum<Type,Dim> > &localMaxima,
+      blitz::TinyVector<BlitzIndexT,Dim> const &radius,
+      Type const &minValue = traits<Type>::smallest,
+      blitz::TinyVector<double,Dim> const &elementSize =
+      blitz::TinyVector<double,Dim>(1.0),
+      double minDistance = 0.0, size_t maxCount = 0,
+      bool subVoxel = false, bool excludeBoundary = false,
+      iRoCS::ProgressReporter *progress = NULL);
+
 }
 
 #include "LocalMaximumExtraction.icc"
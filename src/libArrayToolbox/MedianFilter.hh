@@ -35,6 +35,7 @@
 #endif
 
 #include "Filter.hh"
+#include "SlidingWindowRank.hh"
 
 namespace atb
 {
@@ -43,6 +44,13 @@ namespace atb
 /*!
  *  \class MedianFilter MedianFilter.hh "ArrayToolbox/MedianFilter.hh"
  *  \brief The MedianFilter class implements the n-dimensional median filter.
+ *
+ *  The window is moved along the innermost (contiguous) dimension and the
+ *  running window content is kept in a SlidingWindowRank structure, so that
+ *  only the window columns leaving and entering the window have to be
+ *  updated per voxel. For 8 and 16 Bit integer data this is a sliding
+ *  histogram, for all other types a blocked sorted list. The scanlines are
+ *  processed in parallel in slabs along the outermost dimension.
  */
 /*======================================================================*/
   template<typename DataT, int Dim>
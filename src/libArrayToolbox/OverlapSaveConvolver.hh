@@ -0,0 +1,237 @@
+/**************************************************************************
+ *
+ * Copyright (C) 2015 Thorsten Falk
+ *
+ *        Image Analysis Lab, University of Freiburg, Germany
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ *
+ **************************************************************************/
+
+/*======================================================================*/
+/*!
+ *  \file OverlapSaveConvolver.hh
+ *  \brief Tiled n-D FFT convolution and correlation using overlap-save
+ */
+/*======================================================================*/
+
+#ifndef ATBOVERLAPSAVECONVOLVER_HH
+#define ATBOVERLAPSAVECONVOLVER_HH
+
+#ifdef HAVE_CONFIG_H
+#include <config.hh>
+#endif
+
+#include <cmath>
+#include <algorithm>
+
+#include "TypeTraits.hh"
+#include "BoundaryTreatment.hh"
+#include "RuntimeError.hh"
+
+#include <libProgressReporter/ProgressReporter.hh>
+#include <libBlitzFFTW/BlitzFFTW.hh>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace atb
+{
+
+/*======================================================================*/
+/*!
+ *  \class OverlapSaveConvolver OverlapSaveConvolver.hh "libArrayToolbox/OverlapSaveConvolver.hh"
+ *  \brief The OverlapSaveConvolver class computes n-D convolutions and
+ *    correlations tile by tile using the overlap-save method.
+ *
+ *  The tile extents are FFT-friendly sizes obtained from
+ *  BlitzFFTW::getPaddedShape(). Every tile overlaps its neighbours by the
+ *  kernel extent minus one, so after the circular convolution of a tile
+ *  the last tileShape - kernelShape + 1 samples per dimension are exact
+ *  and are copied to the result. The kernel spectrum is computed once per
+ *  tile shape and shared by all tiles. The tiles are processed in
+ *  parallel, every thread plans and executes the forward and backward
+ *  transforms on its own tile buffers.
+ *
+ *  Compared to padding the whole Array this needs only a few tiles of
+ *  extra memory per thread and does less work when the kernel is small
+ *  compared to the data. Out-of-Array values are taken from the boundary
+ *  treatment, CropBT is not supported.
+ *
+ *  This class is the tiling engine of FastConvolutionFilter,
+ *  FastCorrelationFilter and FastNormalizedCorrelationFilter.
+ */
+/*======================================================================*/
+  template<typename DataT, int Dim>
+  class OverlapSaveConvolver
+  {
+
+  public:
+
+/*======================================================================*/
+/*!
+ *   Default Constructor.
+ *
+ *   \param correlate  If true, the correlation with the kernel is
+ *     computed, otherwise the convolution
+ */
+/*======================================================================*/
+    explicit OverlapSaveConvolver(bool correlate = false);
+
+/*======================================================================*/
+/*!
+ *   Destructor.
+ */
+/*======================================================================*/
+    ~OverlapSaveConvolver();
+
+/*======================================================================*/
+/*!
+ *   Set the kernel. A copy of the kernel is stored and the cached kernel
+ *   spectrum is invalidated.
+ *
+ *   \param kernel The convolution or correlation kernel
+ */
+/*======================================================================*/
+    void setKernel(blitz::Array<DataT,Dim> const &kernel);
+
+/*======================================================================*/
+/*!
+ *   Get the kernel.
+ *
+ *   \return The current kernel
+ */
+/*======================================================================*/
+    blitz::Array<DataT,Dim> const &kernel() const;
+
+/*======================================================================*/
+/*!
+ *   Set the approximate number of samples per tile. The tile extent along
+ *   each dimension is chosen as the Dim-th root of this value, but at
+ *   least four times the kernel extent. The default is 262144 samples.
+ *
+ *   \param tileSize  The number of samples per tile to aim for
+ */
+/*======================================================================*/
+    void setTileSize(size_t tileSize);
+
+/*======================================================================*/
+/*!
+ *   Get the approximate number of samples per tile.
+ *
+ *   \return The number of samples per tile to aim for
+ */
+/*======================================================================*/
+    size_t tileSize() const;
+
+/*======================================================================*/
+/*!
+ *   Check whether this convolver computes correlations.
+ *
+ *   \return true if the correlation is computed, false for convolution
+ */
+/*======================================================================*/
+    bool correlate() const;
+
+/*======================================================================*/
+/*!
+ *   Get the shape of the FFT tiles used for data Arrays of the given
+ *   shape. The tile never exceeds the padded shape of the full Array.
+ *
+ *   \param dataShape The shape of the data Array
+ *
+ *   \return The FFT tile shape including the kernel overlap
+ */
+/*======================================================================*/
+    blitz::TinyVector<BlitzIndexT,Dim> tileShape(
+        blitz::TinyVector<BlitzIndexT,Dim> const &dataShape) const;
+
+/*======================================================================*/
+/*!
+ *   Convolve (or correlate) the given Array with the kernel. The kernel
+ *   center is at kernelShape / 2 like for the padded FFT filters.
+ *
+ *   \param data    The blitz++ Array to filter
+ *   \param result  The filtering result. It may be the data Array itself.
+ *   \param bt      The boundary treatment to generate out-of-Array values
+ *   \param pr      If given progress will be reported to this
+ *     ProgressReporter
+ *
+ *   \exception RuntimeError If no kernel is set or bt is CropBT an
+ *     exception of this kind is thrown
+ */
+/*======================================================================*/
+    void apply(
+        blitz::Array<DataT,Dim> const &data,
+        blitz::Array<DataT,Dim> &result,
+        BoundaryTreatment<DataT,Dim> const &bt,
+        iRoCS::ProgressReporter *pr = NULL) const;
+
+  private:
+
+    void _computeKernelFFT(
+        blitz::TinyVector<BlitzIndexT,Dim> const &tileShape,
+        blitz::Array<std::complex<DataT>,Dim> &kernelFFT) const;
+
+    template<typename BoundaryPolicyT>
+    void _apply(
+        blitz::Array<DataT,Dim> const &data,
+        blitz::Array<DataT,Dim> &result,
+        blitz::TinyVector<BlitzIndexT,Dim> const &tileShape,
+        blitz::Array<std::complex<DataT>,Dim> const &kernelFFT,
+        BoundaryPolicyT const &bt, iRoCS::ProgressReporter *pr) const;
+
+    class ApplyDispatcher
+    {
+
+    public:
+
+      ApplyDispatcher(
+          OverlapSaveConvolver<DataT,Dim> const &convolver,
+          blitz::Array<DataT,Dim> const &data,
+          blitz::Array<DataT,Dim> &result,
+          blitz::TinyVector<BlitzIndexT,Dim> const &tileShape,
+          blitz::Array<std::complex<DataT>,Dim> const &kernelFFT,
+          iRoCS::ProgressReporter *pr);
+
+      template<typename BoundaryPolicyT>
+      void operator()(BoundaryPolicyT const &bt);
+
+    private:
+
+      OverlapSaveConvolver<DataT,Dim> const &_convolver;
+      blitz::Array<DataT,Dim> const &_data;
+      blitz::Array<DataT,Dim> &_result;
+      blitz::TinyVector<BlitzIndexT,Dim> const &_tileShape;
+      blitz::Array<std::complex<DataT>,Dim> const &_kernelFFT;
+      iRoCS::ProgressReporter *p_pr;
+
+    };
+
+    blitz::Array<DataT,Dim> _kernel;
+    bool _correlate;
+    size_t _tileSize;
+
+    mutable blitz::TinyVector<BlitzIndexT,Dim> _kernelFFTTileShape;
+    mutable blitz::Array<std::complex<DataT>,Dim> _kernelFFTCache;
+
+  };
+
+}
+
+#include "OverlapSaveConvolver.icc"
+
+#endif
@@ -36,6 +36,9 @@
 
 #include "SeparableFilter.hh"
 
+#include <vector>
+#include <cstdlib>
+
 namespace atb
 {
 
@@ -52,6 +55,15 @@ namespace atb
  *  have only limited memory but much processing power. The running time
  *  scales linearly with the kernel size, though, therefore for big kernels
  *  this class can be much slower than its Fourier counterparts.
+ *
+ *  Filtering along dimensions that are not contiguous in memory gathers
+ *  blocks of neighboring lines into a transposed buffer and correlates
+ *  them simultaneously, so that the inner loop runs over contiguous
+ *  memory and can be vectorized by the compiler.
+ *
+ *  The boundary treatment is resolved once per filtered dimension via
+ *  BoundaryTreatmentFactory::dispatch(). Lines are padded using the
+ *  inlined boundary policy and correlated without boundary checks.
  */
 /*======================================================================*/
   template<typename DataT,int Dim>
@@ -221,12 +233,91 @@ namespace atb
 
   private:
 
+    // Number of neighboring lines processed at once when filtering along
+    // strided dimensions
+    static ptrdiff_t const _lineBlockSize = 32;
+
+    template<typename BoundaryPolicyT>
+    void applyAlongDimBlocked(
+        blitz::Array<DataT,Dim> const &data,
+        blitz::Array<DataT,Dim> &filtered, int dim, DataT const *weights,
+        BoundaryPolicyT const &bt, iRoCS::ProgressReporter *pr) const;
+
     void applyAlongDimNaive(
         blitz::Array<DataT,Dim> const &data,
         blitz::TinyVector<double,Dim> const &elementSizeUm,
         blitz::Array<DataT,Dim> &filtered, int dim,
         iRoCS::ProgressReporter *pr = NULL) const;
 
+    /*--------------------------------------------------------------------
+     *  Filters all lines along dim. The lines are padded according to
+     *  the given boundary policy, so that the correlation itself needs no
+     *  boundary checks. If fullWeights is true, weights contains the
+     *  CropBT normalization for every line position, otherwise only for
+     *  the border positions as computed in applyAlongDim().
+     *--------------------------------------------------------------------*/
+    template<typename BoundaryPolicyT>
+    void applyAlongDimLines(
+        blitz::Array<DataT,Dim> const &data,
+        blitz::Array<DataT,Dim> &filtered, int dim, DataT const *weights,
+        bool fullWeights, BoundaryPolicyT const &bt,
+        iRoCS::ProgressReporter *pr) const;
+
+    // Passed to BoundaryTreatmentFactory::dispatch() to call
+    // applyAlongDimLines() with the policy matching p_bt
+    class LineFilterDispatcher
+    {
+
+    public:
+
+      LineFilterDispatcher(
+          SeparableCorrelationFilter<DataT,Dim> const &filter,
+          blitz::Array<DataT,Dim> const &data,
+          blitz::Array<DataT,Dim> &filtered, int dim, DataT const *weights,
+          bool fullWeights, iRoCS::ProgressReporter *pr);
+
+      template<typename BoundaryPolicyT>
+      void operator()(BoundaryPolicyT const &bt);
+
+    private:
+
+      SeparableCorrelationFilter<DataT,Dim> const &_filter;
+      blitz::Array<DataT,Dim> const &_data;
+      blitz::Array<DataT,Dim> &_filtered;
+      int _dim;
+      DataT const *_weights;
+      bool _fullWeights;
+      iRoCS::ProgressReporter *_pr;
+
+    };
+
+    // Passed to BoundaryTreatmentFactory::dispatch() to call
+    // applyAlongDimBlocked() with the policy matching p_bt
+    class BlockedFilterDispatcher
+    {
+
+    public:
+
+      BlockedFilterDispatcher(
+          SeparableCorrelationFilter<DataT,Dim> const &filter,
+          blitz::Array<DataT,Dim> const &data,
+          blitz::Array<DataT,Dim> &filtered, int dim, DataT const *weights,
+          iRoCS::ProgressReporter *pr);
+
+      template<typename BoundaryPolicyT>
+      void operator()(BoundaryPolicyT const &bt);
+
+    private:
+
+      SeparableCorrelationFilter<DataT,Dim> const &_filter;
+      blitz::Array<DataT,Dim> const &_data;
+      blitz::Array<DataT,Dim> &_filtered;
+      int _dim;
+      DataT const *_weights;
+      iRoCS::ProgressReporter *_pr;
+
+    };
+
     blitz::TinyVector<blitz::Array<DataT,1>*,Dim> _kernels;
 
   };
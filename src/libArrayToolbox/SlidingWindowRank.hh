@@ -0,0 +1,201 @@
+/**************************************************************************
+ *
+ * Copyright (C) 2015 Thorsten Falk
+ *
+ *        Image Analysis Lab, University of Freiburg, Germany
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ *
+ **************************************************************************/
+
+/*======================================================================*/
+/*!
+ *  \file SlidingWindowRank.hh
+ *  \brief Running order statistics for sliding window rank filters
+ */
+/*======================================================================*/
+
+#ifndef ATBSLIDINGWINDOWRANK_HH
+#define ATBSLIDINGWINDOWRANK_HH
+
+#ifdef HAVE_CONFIG_H
+#include <config.hh>
+#endif
+
+#include <vector>
+#include <limits>
+#include <cstddef>
+
+namespace atb
+{
+
+/*======================================================================*/
+/*!
+ *  \class SlidingWindowRank SlidingWindowRank.hh "ArrayToolbox/SlidingWindowRank.hh"
+ *  \brief The SlidingWindowRank class maintains a multiset of values that
+ *    supports insertion, removal and k-th smallest element queries.
+ *
+ *  It is the running rank structure behind the scanline-incremental rank
+ *  filters (MedianFilter, IsotropicPercentileFilter). When the filter
+ *  window moves by one voxel only the values leaving and entering the
+ *  window are erased and inserted, the remaining window content is kept.
+ *
+ *  The generic implementation stores the values in a list of sorted blocks
+ *  of about sqrt(n) values each. Overfull blocks are split and underfull
+ *  blocks are merged with a neighbour, so insertion, removal and rank
+ *  queries stay O(sqrt(n)) for arbitrary ordered types (float, double,
+ *  32/64 Bit integers), also after long slides.
+ *  For integer types of at most 16 Bit a specialization based on a
+ *  two-level (coarse/fine) histogram is used (Huang/Perreault).
+ */
+/*======================================================================*/
+  template<typename DataT,
+           bool UseHistogram = (std::numeric_limits<DataT>::is_integer &&
+                                sizeof(DataT) <= 2)>
+  class SlidingWindowRank
+  {
+
+  public:
+
+/*======================================================================*/
+/*!
+ *   Default constructor. Creates an empty window.
+ */
+/*======================================================================*/
+    SlidingWindowRank();
+
+/*======================================================================*/
+/*!
+ *   Remove all values from the window.
+ */
+/*======================================================================*/
+    void clear();
+
+/*======================================================================*/
+/*!
+ *   Get the number of values currently in the window.
+ *
+ *   \return The number of values in the window
+ */
+/*======================================================================*/
+    size_t size() const;
+
+/*======================================================================*/
+/*!
+ *   Add the given value to the window.
+ *
+ *   \param value The value to insert
+ */
+/*======================================================================*/
+    void insert(DataT const &value);
+
+/*======================================================================*/
+/*!
+ *   Remove one occurrence of the given value from the window. The value
+ *   must have been inserted before, otherwise the behaviour is undefined.
+ *
+ *   \param value The value to remove
+ */
+/*======================================================================*/
+    void erase(DataT const &value);
+
+/*======================================================================*/
+/*!
+ *   Get the k-th smallest value (zero based) in the window.
+ *
+ *   \param k The rank of the value to query. It must be less than size().
+ *
+ *   \return The k-th smallest value
+ */
+/*======================================================================*/
+    DataT kth(size_t k);
+
+/*======================================================================*/
+/*!
+ *   Get the number of sorted blocks the values are currently stored in.
+ *   It stays in the order of sqrt(size()).
+ *
+ *   eturn The number of blocks
+ */
+/*======================================================================*/
+    size_t nBlocks() const;
+
+  private:
+
+    // Minimum target block size, below it the block bookkeeping dominates
+    static size_t const _minBlockSize = 16;
+
+    size_t _targetBlockSize() const;
+
+    void _rebalance(size_t b);
+
+    std::vector< std::vector<DataT> > _blocks;
+    size_t _size;
+
+  };
+
+/*======================================================================*/
+/*!
+ *  \class SlidingWindowRank<DataT,true> SlidingWindowRank.hh "ArrayToolbox/SlidingWindowRank.hh"
+ *  \brief Histogram based SlidingWindowRank for 8 and 16 Bit integer types.
+ *
+ *  The histogram is split into a coarse level over the upper half of the
+ *  bits and a fine level over all values. The coarse bin containing the
+ *  last queried rank is tracked together with the number of values below
+ *  it, so that a query only walks the few coarse bins the rank moved by
+ *  plus one fine bin range.
+ */
+/*======================================================================*/
+  template<typename DataT>
+  class SlidingWindowRank<DataT,true>
+  {
+
+  public:
+
+    SlidingWindowRank();
+
+    void clear();
+
+    size_t size() const;
+
+    void insert(DataT const &value);
+
+    void erase(DataT const &value);
+
+    DataT kth(size_t k);
+
+  private:
+
+    static int const _nBits = 8 * static_cast<int>(sizeof(DataT));
+    static int const _fineBits = _nBits / 2;
+    static size_t const _nFine = size_t(1) << _fineBits;
+    static size_t const _nCoarse = size_t(1) << (_nBits - _fineBits);
+
+    static size_t _bin(DataT const &value);
+
+    std::vector<size_t> _fineHistogram;
+    std::vector<size_t> _coarseHistogram;
+    size_t _size;
+
+    size_t _coarseIndex;
+    size_t _nBelowCoarseIndex;
+
+  };
+
+}
+
+#include "SlidingWindowRank.icc"
+
+#endif
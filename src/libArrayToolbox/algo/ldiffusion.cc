@@ -163,3 +163,101 @@ void tridiagonal_Thomas_solution(
 
   delete[] yy;
 }
+
+void get1DAOS_batch(
+    double const *p, double delta_t, unsigned long len, int m, int nBatch,
+    double *alpha, double *beta, double *gamma, double *L, double *M,
+    double *R)
+{
+  double s = m * m * delta_t;
+
+  if (len == 1)
+  {
+    for (int b = 0; b < nBatch; ++b) alpha[b] = m;
+    tridiagonal_Thomas_decomposition_batch(
+        alpha, beta, gamma, L, M, R, len, nBatch);
+    return;
+  }
+
+  for (unsigned long i = 0; i < len - 1; ++i)
+  {
+    double const *pi = p + i * nBatch;
+    double *gi = gamma + i * nBatch;
+    double *bi = beta + i * nBatch;
+#if defined(_OPENMP) && _OPENMP >= 201307
+#pragma omp simd
+#endif
+    for (int b = 0; b < nBatch; ++b)
+    {
+      gi[b] = -s * (pi[b] + pi[nBatch + b]) / 2;
+      bi[b] = gi[b];
+    }
+  }
+
+  for (int b = 0; b < nBatch; ++b) alpha[b] = m - gamma[b];
+  for (unsigned long i = 1; i < len - 1; ++i)
+  {
+    double *ai = alpha + i * nBatch;
+    double const *gi = gamma + (i - 1) * nBatch;
+    double const *bi = beta + i * nBatch;
+#if defined(_OPENMP) && _OPENMP >= 201307
+#pragma omp simd
+#endif
+    for (int b = 0; b < nBatch; ++b) ai[b] = m - (gi[b] + bi[b]);
+  }
+  for (int b = 0; b < nBatch; ++b)
+      alpha[(len - 1) * nBatch + b] = m - beta[(len - 2) * nBatch + b];
+
+  tridiagonal_Thomas_decomposition_batch(
+      alpha, beta, gamma, L, M, R, len, nBatch);
+}
+
+void tridiagonal_Thomas_decomposition_batch(
+    double const *alpha, double const *beta, double const *gamma,
+    double *l, double *m, double *r, unsigned long N, int nBatch)
+{
+  for (int b = 0; b < nBatch; ++b) m[b] = alpha[b];
+  for (unsigned long i = 0; i + 1 < N; ++i)
+  {
+    ptrdiff_t o = i * nBatch;
+#if defined(_OPENMP) && _OPENMP >= 201307
+#pragma omp simd
+#endif
+    for (int b = 0; b < nBatch; ++b)
+    {
+      r[o + b] = beta[o + b];
+      l[o + b] = gamma[o + b] / m[o + b];
+      m[o + nBatch + b] = alpha[o + nBatch + b] - l[o + b] * beta[o + b];
+    }
+  }
+}
+
+void tridiagonal_Thomas_solution_batch(
+    double const *l, double const *m, double const *r, double const *d,
+    double *y, unsigned long N, int nBatch)
+{
+  // forward (y may alias d, every d[i] is read before y[i] is written)
+  for (int b = 0; b < nBatch; ++b) y[b] = d[b];
+  for (unsigned long i = 1; i < N; ++i)
+  {
+    ptrdiff_t o = i * nBatch;
+#if defined(_OPENMP) && _OPENMP >= 201307
+#pragma omp simd
+#endif
+    for (int b = 0; b < nBatch; ++b)
+        y[o + b] = d[o + b] - l[o - nBatch + b] * y[o - nBatch + b];
+  }
+
+  // backward
+  for (int b = 0; b < nBatch; ++b)
+      y[(N - 1) * nBatch + b] /= m[(N - 1) * nBatch + b];
+  for (unsigned long i = N - 1; i > 0; --i)
+  {
+    ptrdiff_t o = (i - 1) * nBatch;
+#if defined(_OPENMP) && _OPENMP >= 201307
+#pragma omp simd
+#endif
+    for (int b = 0; b < nBatch; ++b)
+        y[o + b] = (y[o + b] - r[o + b] * y[o + nBatch + b]) / m[o + b];
+  }
+}
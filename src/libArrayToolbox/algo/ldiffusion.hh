@@ -38,6 +38,9 @@
 
 #include <blitz/array.h>
 
+#include <vector>
+#include <algorithm>
+
 int mindex3(int x, int y, int z, int sizx, int sizy);
 
 template<typename Type, int Dim>
@@ -58,6 +61,26 @@ void get1DAOS_blitz(
     double* alpha, double *beta, double *gamma, double* L, double *M,
     double *R);
 
+// Number of lines the batched AOS solvers process simultaneously. The
+// coefficients of the lines are stored interleaved, i.e. element i of
+// line b of a batch is stored at index i * nBatch + b.
+int const AOS_BATCH_SIZE = 8;
+
+void get1DAOS_batch(
+    double const *p, double delta_t, unsigned long len, int m, int nBatch,
+    double *alpha, double *beta, double *gamma, double *L, double *M,
+    double *R);
+
+template<typename Type, typename GType>
+void AOS_1D_batch_blitz(
+    Type const *u, ptrdiff_t uStride, ptrdiff_t uLaneStride,
+    GType const *g, ptrdiff_t gStride, ptrdiff_t gLaneStride,
+    Type *u_new, ptrdiff_t uNewStride, ptrdiff_t uNewLaneStride,
+    double delta_t, unsigned long len, int nLanes, bool accumulate,
+    double *workspace);
+
+// One AOS step. u, g and u_new must have the same shape, each of them may
+// have its own memory layout (e.g. transposed or reversed views).
 template<typename Type, typename gType>
 void AOS_3D_blitz(
     const blitz::Array<Type, 3>& u, blitz::Array<gType, 3>& g,
@@ -77,6 +100,14 @@ void tridiagonal_Thomas_decomposition(
 void tridiagonal_Thomas_solution(
     double* l, double* m, double* r, double* d, double* y, unsigned long N);
 
+void tridiagonal_Thomas_decomposition_batch(
+    double const *alpha, double const *beta, double const *gamma,
+    double *l, double *m, double *r, unsigned long N, int nBatch);
+
+void tridiagonal_Thomas_solution_batch(
+    double const *l, double const *m, double const *r, double const *d,
+    double *y, unsigned long N, int nBatch);
+
 template<typename Type>
 void tridiagonal_Thomas_solution_blitz(
     double* l, double* m, double* r, blitz::Array<Type,1> &d, double* y,
@@ -35,6 +35,13 @@
 #endif
 
 #include <queue>
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include <blitz/array.h>
 
@@ -63,6 +70,48 @@ template<typename VoxelT, typename LabelT, int Dim>
 void morphWatershed(
     blitz::Array<VoxelT,Dim> &data, blitz::Array<LabelT,Dim> &label, int conn);
 
+/*
+ * Watershed flooding with a hierarchical bucket queue instead of a priority
+ * queue. The intensities are mapped to nLevels integer flooding levels. For
+ * integer data whose value range fits into nLevels the levels are the
+ * intensities themselves and the result is identical to morphWatershed(),
+ * otherwise the intensities are quantized linearly. The levels are
+ * precomputed, which needs one additional int per voxel.
+ */
+template<typename VoxelT, typename MarkerT, typename LabelT, int Dim>
+void morphWatershedBucketQueue(
+    blitz::Array<VoxelT,Dim> &data, blitz::Array<MarkerT,Dim> &marker,
+    blitz::Array<LabelT,Dim> &label, int conn, int nLevels = 65536);
+
+//with labeled marker
+template<typename VoxelT, typename LabelT, int Dim>
+void morphWatershedBucketQueue(
+    blitz::Array<VoxelT,Dim> &data, blitz::Array<LabelT,Dim> &label, int conn,
+    int nLevels = 65536);
+
+/*
+ * Bucket queue watershed flooding in nTiles slabs along the first dimension
+ * (0 = slabs of 32 planes) that are quantized and flooded independently in
+ * parallel. A sequential merge pass then re-floods the voxels that a basin
+ * of a neighboring slab reaches at a lower level, and separates different
+ * labels meeting at the slab borders by watershed voxels. With one slab
+ * the result is identical to morphWatershedBucketQueue(). With more slabs
+ * the watershed lines next to slab borders, and on plateaus crossing them,
+ * can deviate from the sequential flooding; the result only depends on
+ * nTiles, not on the number of threads.
+ */
+template<typename VoxelT, typename MarkerT, typename LabelT, int Dim>
+void morphWatershedTiled(
+    blitz::Array<VoxelT,Dim> &data, blitz::Array<MarkerT,Dim> &marker,
+    blitz::Array<LabelT,Dim> &label, int conn, int nLevels = 65536,
+    int nTiles = 0);
+
+//with labeled marker
+template<typename VoxelT, typename LabelT, int Dim>
+void morphWatershedTiled(
+    blitz::Array<VoxelT,Dim> &data, blitz::Array<LabelT,Dim> &label, int conn,
+    int nLevels = 65536, int nTiles = 0);
+
 /*
  * note that the boundary on the border will be omitted.
  */
@@ -84,6 +133,20 @@ struct orderedPrioritizedNode
   bool operator <(orderedPrioritizedNode const &opN) const;
 };
 
+// helper for bucket queue watersheding, maps intensities to flooding levels
+template<typename VoxelT>
+class WatershedLevelQuantizer
+{
+public:
+  WatershedLevelQuantizer(VoxelT minValue, VoxelT maxValue, int nLevels);
+  int operator()(VoxelT value) const;
+  int nLevels() const;
+private:
+  double m_min;
+  double m_scale;
+  int m_nLevels;
+};
+
 static const int moveIn3DNeighbor[26][3] =
 {
     { -1, 0, 0 },
@@ -162,3 +162,115 @@ template void BlitzFFTW<float>::exec_guru_plan_c2r(blitz::Array<std::complex<flo
 template void BlitzFFTW<double>::exec_guru_plan_c2r(blitz::Array<std::complex<double>,1>& in, blitz::Array<double,1>& out, blitz_fftw_plan plan, const DataPreservePolicy policy) const;
 template void BlitzFFTW<double>::exec_guru_plan_c2r(blitz::Array<std::complex<double>,2>& in, blitz::Array<double,2>& out, blitz_fftw_plan plan, const DataPreservePolicy policy) const;
 template void BlitzFFTW<double>::exec_guru_plan_c2r(blitz::Array<std::complex<double>,3>& in, blitz::Array<double,3>& out, blitz_fftw_plan plan, const DataPreservePolicy policy) const;
+
+
+template void BlitzFFTW<float>::forwardMany(const blitz::Array<float,1>& in, blitz::Array<std::complex<float>,1>& out, const int batchRank) const;
+template void BlitzFFTW<float>::forwardMany(const blitz::Array<float,2>& in, blitz::Array<std::complex<float>,2>& out, const int batchRank) const;
+template void BlitzFFTW<float>::forwardMany(const blitz::Array<float,3>& in, blitz::Array<std::complex<float>,3>& out, const int batchRank) const;
+template void BlitzFFTW<float>::forwardMany(const blitz::Array<float,4>& in, blitz::Array<std::complex<float>,4>& out, const int batchRank) const;
+
+template void BlitzFFTW<double>::forwardMany(const blitz::Array<double,1>& in, blitz::Array<std::complex<double>,1>& out, const int batchRank) const;
+template void BlitzFFTW<double>::forwardMany(const blitz::Array<double,2>& in, blitz::Array<std::complex<double>,2>& out, const int batchRank) const;
+template void BlitzFFTW<double>::forwardMany(const blitz::Array<double,3>& in, blitz::Array<std::complex<double>,3>& out, const int batchRank) const;
+template void BlitzFFTW<double>::forwardMany(const blitz::Array<double,4>& in, blitz::Array<std::complex<double>,4>& out, const int batchRank) const;
+
+
+template void BlitzFFTW<float>::forwardMany(blitz::Array<std::complex<float>,1>& in, blitz::Array<std::complex<float>,1>& out, const int batchRank) const;
+template void BlitzFFTW<float>::forwardMany(blitz::Array<std::complex<float>,2>& in, blitz::Array<std::complex<float>,2>& out, const int batchRank) const;
+template void BlitzFFTW<float>::forwardMany(blitz::Array<std::complex<float>,3>& in, blitz::Array<std::complex<float>,3>& out, const int batchRank) const;
+template void BlitzFFTW<float>::forwardMany(blitz::Array<std::complex<float>,4>& in, blitz::Array<std::complex<float>,4>& out, const int batchRank) const;
+
+template void BlitzFFTW<double>::forwardMany(blitz::Array<std::complex<double>,1>& in, blitz::Array<std::complex<double>,1>& out, const int batchRank) const;
+template void BlitzFFTW<double>::forwardMany(blitz::Array<std::complex<double>,2>& in, blitz::Array<std::complex<double>,2>& out, const int batchRank) const;
+template void BlitzFFTW<double>::forwardMany(blitz::Array<std::complex<double>,3>& in, blitz::Array<std::complex<double>,3>& out, const int batchRank) const;
+template void BlitzFFTW<double>::forwardMany(blitz::Array<std::complex<double>,4>& in, blitz::Array<std::complex<double>,4>& out, const int batchRank) const;
+
+
+template void BlitzFFTW<float>::backwardMany(blitz::Array<std::complex<float>,1>& in, blitz::Array<float,1>& out, const int batchRank, const DataPreservePolicy policy) const;
+template void BlitzFFTW<float>::backwardMany(blitz::Array<std::complex<float>,2>& in, blitz::Array<float,2>& out, const int batchRank, const DataPreservePolicy policy) const;
+template void BlitzFFTW<float>::backwardMany(blitz::Array<std::complex<float>,3>& in, blitz::Array<float,3>& out, const int batchRank, const DataPreservePolicy policy) const;
+template void BlitzFFTW<float>::backwardMany(blitz::Array<std::complex<float>,4>& in, blitz::Array<float,4>& out, const int batchRank, const DataPreservePolicy policy) const;
+
+template void BlitzFFTW<double>::backwardMany(blitz::Array<std::complex<double>,1>& in, blitz::Array<double,1>& out, const int batchRank, const DataPreservePolicy policy) const;
+template void BlitzFFTW<double>::backwardMany(blitz::Array<std::complex<double>,2>& in, blitz::Array<double,2>& out, const int batchRank, const DataPreservePolicy policy) const;
+template void BlitzFFTW<double>::backwardMany(blitz::Array<std::complex<double>,3>& in, blitz::Array<double,3>& out, const int batchRank, const DataPreservePolicy policy) const;
+template void BlitzFFTW<double>::backwardMany(blitz::Array<std::complex<double>,4>& in, blitz::Array<double,4>& out, const int batchRank, const DataPreservePolicy policy) const;
+
+
+template void BlitzFFTW<float>::backwardMany(blitz::Array<std::complex<float>,1>& in, blitz::Array<std::complex<float>,1>& out, const int batchRank) const;
+template void BlitzFFTW<float>::backwardMany(blitz::Array<std::complex<float>,2>& in, blitz::Array<std::complex<float>,2>& out, const int batchRank) const;
+template void BlitzFFTW<float>::backwardMany(blitz::Array<std::complex<float>,3>& in, blitz::Array<std::complex<float>,3>& out, const int batchRank) const;
+template void BlitzFFTW<float>::backwardMany(blitz::Array<std::complex<float>,4>& in, blitz::Array<std::complex<float>,4>& out, const int batchRank) const;
+
+template void BlitzFFTW<double>::backwardMany(blitz::Array<std::complex<double>,1>& in, blitz::Array<std::complex<double>,1>& out, const int batchRank) const;
+template void BlitzFFTW<double>::backwardMany(blitz::Array<std::complex<double>,2>& in, blitz::Array<std::complex<double>,2>& out, const int batchRank) const;
+template void BlitzFFTW<double>::backwardMany(blitz::Array<std::complex<double>,3>& in, blitz::Array<std::complex<double>,3>& out, const int batchRank) const;
+template void BlitzFFTW<double>::backwardMany(blitz::Array<std::complex<double>,4>& in, blitz::Array<std::complex<double>,4>& out, const int batchRank) const;
+
+
+template void BlitzFFTW<float>::forwardAlongAxis(const blitz::Array<float,1>& in, blitz::Array<std::complex<float>,1>& out, const int axis) const;
+template void BlitzFFTW<float>::forwardAlongAxis(const blitz::Array<float,2>& in, blitz::Array<std::complex<float>,2>& out, const int axis) const;
+template void BlitzFFTW<float>::forwardAlongAxis(const blitz::Array<float,3>& in, blitz::Array<std::complex<float>,3>& out, const int axis) const;
+template void BlitzFFTW<float>::forwardAlongAxis(const blitz::Array<float,4>& in, blitz::Array<std::complex<float>,4>& out, const int axis) const;
+
+template void BlitzFFTW<double>::forwardAlongAxis(const blitz::Array<double,1>& in, blitz::Array<std::complex<double>,1>& out, const int axis) const;
+template void BlitzFFTW<double>::forwardAlongAxis(const blitz::Array<double,2>& in, blitz::Array<std::complex<double>,2>& out, const int axis) const;
+template void BlitzFFTW<double>::forwardAlongAxis(const blitz::Array<double,3>& in, blitz::Array<std::complex<double>,3>& out, const int axis) const;
+template void BlitzFFTW<double>::forwardAlongAxis(const blitz::Array<double,4>& in, blitz::Array<std::complex<double>,4>& out, const int axis) const;
+
+
+template void BlitzFFTW<float>::forwardAlongAxis(blitz::Array<std::complex<float>,1>& in, blitz::Array<std::complex<float>,1>& out, const int axis) const;
+template void BlitzFFTW<float>::forwardAlongAxis(blitz::Array<std::complex<float>,2>& in, blitz::Array<std::complex<float>,2>& out, const int axis) const;
+template void BlitzFFTW<float>::forwardAlongAxis(blitz::Array<std::complex<float>,3>& in, blitz::Array<std::complex<float>,3>& out, const int axis) const;
+template void BlitzFFTW<float>::forwardAlongAxis(blitz::Array<std::complex<float>,4>& in, blitz::Array<std::complex<float>,4>& out, const int axis) const;
+
+template void BlitzFFTW<double>::forwardAlongAxis(blitz::Array<std::complex<double>,1>& in, blitz::Array<std::complex<double>,1>& out, const int axis) const;
+template void BlitzFFTW<double>::forwardAlongAxis(blitz::Array<std::complex<double>,2>& in, blitz::Array<std::complex<double>,2>& out, const int axis) const;
+template void BlitzFFTW<double>::forwardAlongAxis(blitz::Array<std::complex<double>,3>& in, blitz::Array<std::complex<double>,3>& out, const int axis) const;
+template void BlitzFFTW<double>::forwardAlongAxis(blitz::Array<std::complex<double>,4>& in, blitz::Array<std::complex<double>,4>& out, const int axis) const;
+
+
+template void BlitzFFTW<float>::backwardAlongAxis(blitz::Array<std::complex<float>,1>& in, blitz::Array<float,1>& out, const int axis, const DataPreservePolicy policy) const;
+template void BlitzFFTW<float>::backwardAlongAxis(blitz::Array<std::complex<float>,2>& in, blitz::Array<float,2>& out, const int axis, const DataPreservePolicy policy) const;
+template void BlitzFFTW<float>::backwardAlongAxis(blitz::Array<std::complex<float>,3>& in, blitz::Array<float,3>& out, const int axis, const DataPreservePolicy policy) const;
+template void BlitzFFTW<float>::backwardAlongAxis(blitz::Array<std::complex<float>,4>& in, blitz::Array<float,4>& out, const int axis, const DataPreservePolicy policy) const;
+
+template void BlitzFFTW<double>::backwardAlongAxis(blitz::Array<std::complex<double>,1>& in, blitz::Array<double,1>& out, const int axis, const DataPreservePolicy policy) const;
+template void BlitzFFTW<double>::backwardAlongAxis(blitz::Array<std::complex<double>,2>& in, blitz::Array<double,2>& out, const int axis, const DataPreservePolicy policy) const;
+template void BlitzFFTW<double>::backwardAlongAxis(blitz::Array<std::complex<double>,3>& in, blitz::Array<double,3>& out, const int axis, const DataPreservePolicy policy) const;
+template void BlitzFFTW<double>::backwardAlongAxis(blitz::Array<std::complex<double>,4>& in, blitz::Array<double,4>& out, const int axis, const DataPreservePolicy policy) const;
+
+
+template void BlitzFFTW<float>::backwardAlongAxis(blitz::Array<std::complex<float>,1>& in, blitz::Array<std::complex<float>,1>& out, const int axis) const;
+template void BlitzFFTW<float>::backwardAlongAxis(blitz::Array<std::complex<float>,2>& in, blitz::Array<std::complex<float>,2>& out, const int axis) const;
+template void BlitzFFTW<float>::backwardAlongAxis(blitz::Array<std::complex<float>,3>& in, blitz::Array<std::complex<float>,3>& out, const int axis) const;
+template void BlitzFFTW<float>::backwardAlongAxis(blitz::Array<std::complex<float>,4>& in, blitz::Array<std::complex<float>,4>& out, const int axis) const;
+
+template void BlitzFFTW<double>::backwardAlongAxis(blitz::Array<std::complex<double>,1>& in, blitz::Array<std::complex<double>,1>& out, const int axis) const;
+template void BlitzFFTW<double>::backwardAlongAxis(blitz::Array<std::complex<double>,2>& in, blitz::Array<std::complex<double>,2>& out, const int axis) const;
+template void BlitzFFTW<double>::backwardAlongAxis(blitz::Array<std::complex<double>,3>& in, blitz::Array<std::complex<double>,3>& out, const int axis) const;
+template void BlitzFFTW<double>::backwardAlongAxis(blitz::Array<std::complex<double>,4>& in, blitz::Array<std::complex<double>,4>& out, const int axis) const;
+
+
+template void BlitzFFTW<float>::r2r(const blitz::Array<float,1>& in, blitz::Array<float,1>& out, const R2RKind kind, const int batchRank) const;
+template void BlitzFFTW<float>::r2r(const blitz::Array<float,2>& in, blitz::Array<float,2>& out, const R2RKind kind, const int batchRank) const;
+template void BlitzFFTW<float>::r2r(const blitz::Array<float,3>& in, blitz::Array<float,3>& out, const R2RKind kind, const int batchRank) const;
+template void BlitzFFTW<float>::r2r(const blitz::Array<float,4>& in, blitz::Array<float,4>& out, const R2RKind kind, const int batchRank) const;
+
+template void BlitzFFTW<double>::r2r(const blitz::Array<double,1>& in, blitz::Array<double,1>& out, const R2RKind kind, const int batchRank) const;
+template void BlitzFFTW<double>::r2r(const blitz::Array<double,2>& in, blitz::Array<double,2>& out, const R2RKind kind, const int batchRank) const;
+template void BlitzFFTW<double>::r2r(const blitz::Array<double,3>& in, blitz::Array<double,3>& out, const R2RKind kind, const int batchRank) const;
+template void BlitzFFTW<double>::r2r(const blitz::Array<double,4>& in, blitz::Array<double,4>& out, const R2RKind kind, const int batchRank) const;
+
+
+template void BlitzFFTW<float>::r2rAlongAxis(const blitz::Array<float,1>& in, blitz::Array<float,1>& out, const R2RKind kind, const int axis) const;
+template void BlitzFFTW<float>::r2rAlongAxis(const blitz::Array<float,2>& in, blitz::Array<float,2>& out, const R2RKind kind, const int axis) const;
+template void BlitzFFTW<float>::r2rAlongAxis(const blitz::Array<float,3>& in, blitz::Array<float,3>& out, const R2RKind kind, const int axis) const;
+template void BlitzFFTW<float>::r2rAlongAxis(const blitz::Array<float,4>& in, blitz::Array<float,4>& out, const R2RKind kind, const int axis) const;
+
+template void BlitzFFTW<double>::r2rAlongAxis(const blitz::Array<double,1>& in, blitz::Array<double,1>& out, const R2RKind kind, const int axis) const;
+template void BlitzFFTW<double>::r2rAlongAxis(const blitz::Array<double,2>& in, blitz::Array<double,2>& out, const R2RKind kind, const int axis) const;
+template void BlitzFFTW<double>::r2rAlongAxis(const blitz::Array<double,3>& in, blitz::Array<double,3>& out, const R2RKind kind, const int axis) const;
+template void BlitzFFTW<double>::r2rAlongAxis(const blitz::Array<double,4>& in, blitz::Array<double,4>& out, const R2RKind kind, const int axis) const;
+
+
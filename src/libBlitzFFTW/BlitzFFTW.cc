@@ -223,9 +223,21 @@ void BlitzFFTW<double>::saveWisdom() const
 
 template<>
 BlitzFFTW<float>::BlitzFFTW()
+        : _nThreads(1)
 {
   static BlitzFFTWDestructor w;
   w.init();
+
+  // The threads library must be initialized before any other fftw call
+#ifdef HAVE_LIBFFTW3F_THREADS
+  fftwf_init_threads();
+  this->blitz_fftw_plan_with_nthreads = &fftwf_plan_with_nthreads;
+  this->blitz_fftw_cleanup_threads = &fftwf_cleanup_threads;
+#else
+  this->blitz_fftw_plan_with_nthreads = NULL;
+  this->blitz_fftw_cleanup_threads = NULL;
+#endif
+
   this->loadWisdom();
   this->prepareFFTSizes();
 
@@ -239,14 +251,32 @@ BlitzFFTW<float>::BlitzFFTW()
   this->blitz_fftw_destroy_plan = &fftwf_destroy_plan;
   this->blitz_fftw_cleanup = &fftwf_cleanup;
   this->blitz_fftw_malloc = &fftwf_malloc;
+  this->blitz_fftw_alignment_of = &fftwf_alignment_of;
+  this->blitz_fftw_plan_guru_dft = &fftwf_plan_guru_dft;
+  this->blitz_fftw_plan_guru_dft_r2c = &fftwf_plan_guru_dft_r2c;
+  this->blitz_fftw_plan_guru_dft_c2r = &fftwf_plan_guru_dft_c2r;
+  this->blitz_fftw_plan_guru_r2r = &fftwf_plan_guru_r2r;
+  this->blitz_fftw_execute_r2r = &fftwf_execute_r2r;
 }
 
 
 template<>
 BlitzFFTW<double>::BlitzFFTW()
+        : _nThreads(1)
 {
   static BlitzFFTWDestructor w;
   w.init();
+
+  // The threads library must be initialized before any other fftw call
+#ifdef HAVE_LIBFFTW3_THREADS
+  fftw_init_threads();
+  this->blitz_fftw_plan_with_nthreads = &fftw_plan_with_nthreads;
+  this->blitz_fftw_cleanup_threads = &fftw_cleanup_threads;
+#else
+  this->blitz_fftw_plan_with_nthreads = NULL;
+  this->blitz_fftw_cleanup_threads = NULL;
+#endif
+
   this->loadWisdom();
   this->prepareFFTSizes();
 
@@ -260,6 +290,12 @@ BlitzFFTW<double>::BlitzFFTW()
   this->blitz_fftw_destroy_plan = &fftw_destroy_plan;
   this->blitz_fftw_cleanup = &fftw_cleanup;
   this->blitz_fftw_malloc = &fftw_malloc;
+  this->blitz_fftw_alignment_of = &fftw_alignment_of;
+  this->blitz_fftw_plan_guru_dft = &fftw_plan_guru_dft;
+  this->blitz_fftw_plan_guru_dft_r2c = &fftw_plan_guru_dft_r2c;
+  this->blitz_fftw_plan_guru_dft_c2r = &fftw_plan_guru_dft_c2r;
+  this->blitz_fftw_plan_guru_r2r = &fftw_plan_guru_r2r;
+  this->blitz_fftw_execute_r2r = &fftw_execute_r2r;
 }
 
 
@@ -293,3 +329,225 @@ BlitzFFTW<double>::instance()
 #endif
   return p_instance;
 }
+
+
+/*-------------------------------------------------------------------------
+ *  Plan cache and threading
+ *-------------------------------------------------------------------------*/
+
+template<typename DataT>
+void BlitzFFTW<DataT>::setNumThreads(int nThreads)
+{
+  if (nThreads < 1) nThreads = 1;
+  if (blitz_fftw_plan_with_nthreads == NULL) nThreads = 1;
+  if (nThreads == _nThreads) return;
+
+  clearPlanCache();
+  _nThreads = nThreads;
+#ifdef _OPENMP
+#pragma omp critical (fftwplan)
+#endif
+  (*blitz_fftw_plan_with_nthreads)(_nThreads);
+}
+
+
+template<typename DataT>
+int BlitzFFTW<DataT>::numThreads() const
+{
+  return _nThreads;
+}
+
+
+template<typename DataT>
+void BlitzFFTW<DataT>::clearPlanCache()
+{
+#ifdef _OPENMP
+#pragma omp critical (fftwplan)
+  {
+#endif
+    for (typename std::map<std::vector<int>,blitz_fftw_plan>::iterator it =
+             _planCache.begin(); it != _planCache.end(); ++it)
+        (*blitz_fftw_destroy_plan)(it->second);
+    _planCache.clear();
+#ifdef _OPENMP
+  }
+#endif
+}
+
+
+template<typename DataT>
+std::vector<int> BlitzFFTW<DataT>::planKey(
+    PlanType type, int rank, const int *dims, DataT *in, DataT *out) const
+{
+  std::vector<int> key(rank + 4);
+  key[0] = static_cast<int>(type);
+  key[1] = (in == out) ? 1 : 0;
+  key[2] = (*blitz_fftw_alignment_of)(in);
+  key[3] = (*blitz_fftw_alignment_of)(out);
+  for (int d = 0; d < rank; ++d) key[d + 4] = dims[d];
+  return key;
+}
+
+
+template<typename DataT>
+typename BlitzFFTW<DataT>::blitz_fftw_plan
+BlitzFFTW<DataT>::cachedPlan(
+    PlanType type, int rank, const int *dims, DataT *in, DataT *out) const
+{
+  std::vector<int> key(planKey(type, rank, dims, in, out));
+  blitz_fftw_plan plan = NULL;
+#ifdef _OPENMP
+#pragma omp critical (fftwplan)
+  {
+#endif
+    typename std::map<std::vector<int>,blitz_fftw_plan>::const_iterator it =
+        _planCache.find(key);
+    if (it != _planCache.end()) plan = it->second;
+    else
+    {
+      // FFTW_ESTIMATE never touches the Arrays, but still uses wisdom
+      // gathered by plan_forward() and plan_backward(). The signs of the
+      // complex transforms are the ones BlitzFFTW always used.
+      switch (type)
+      {
+      case R2C:
+        plan = (*blitz_fftw_plan_dft_r2c)(
+            rank, dims, in, reinterpret_cast<blitz_fftw_complex*>(out),
+            FFTW_ESTIMATE);
+        break;
+      case C2R:
+        plan = (*blitz_fftw_plan_dft_c2r)(
+            rank, dims, reinterpret_cast<blitz_fftw_complex*>(in), out,
+            FFTW_ESTIMATE);
+        break;
+      case C2C_FORWARD:
+        plan = (*blitz_fftw_plan_dft)(
+            rank, dims, reinterpret_cast<blitz_fftw_complex*>(in),
+            reinterpret_cast<blitz_fftw_complex*>(out), 1, FFTW_ESTIMATE);
+        break;
+      case C2C_BACKWARD:
+        plan = (*blitz_fftw_plan_dft)(
+            rank, dims, reinterpret_cast<blitz_fftw_complex*>(in),
+            reinterpret_cast<blitz_fftw_complex*>(out), -1, FFTW_ESTIMATE);
+        break;
+      default:
+        break;
+      }
+      _planCache[key] = plan;
+    }
+#ifdef _OPENMP
+  }
+#endif
+  return plan;
+}
+
+
+template<typename DataT>
+typename BlitzFFTW<DataT>::blitz_fftw_plan
+BlitzFFTW<DataT>::cachedGuruPlan(
+    PlanType type, int rank, const fftw_iodim *dims,
+    int howmanyRank, const fftw_iodim *howmanyDims,
+    DataT *in, DataT *out, const fftw_r2r_kind *kinds) const
+{
+  // The leading -1 separates guru keys from the keys of cachedPlan()
+  std::vector<int> key;
+  key.push_back(-1);
+  key.push_back(static_cast<int>(type));
+  key.push_back((in == out) ? 1 : 0);
+  key.push_back((*blitz_fftw_alignment_of)(in));
+  key.push_back((*blitz_fftw_alignment_of)(out));
+  key.push_back(rank);
+  key.push_back(howmanyRank);
+  for (int d = 0; d < rank; ++d)
+  {
+    key.push_back(dims[d].n);
+    key.push_back(dims[d].is);
+    key.push_back(dims[d].os);
+    if (type == R2R) key.push_back(static_cast<int>(kinds[d]));
+  }
+  for (int d = 0; d < howmanyRank; ++d)
+  {
+    key.push_back(howmanyDims[d].n);
+    key.push_back(howmanyDims[d].is);
+    key.push_back(howmanyDims[d].os);
+  }
+
+  blitz_fftw_plan plan = NULL;
+#ifdef _OPENMP
+#pragma omp critical (fftwplan)
+  {
+#endif
+    typename std::map<std::vector<int>,blitz_fftw_plan>::const_iterator it =
+        _planCache.find(key);
+    if (it != _planCache.end()) plan = it->second;
+    else
+    {
+      switch (type)
+      {
+      case R2C:
+        plan = (*blitz_fftw_plan_guru_dft_r2c)(
+            rank, dims, howmanyRank, howmanyDims, in,
+            reinterpret_cast<blitz_fftw_complex*>(out), FFTW_ESTIMATE);
+        break;
+      case C2R:
+        plan = (*blitz_fftw_plan_guru_dft_c2r)(
+            rank, dims, howmanyRank, howmanyDims,
+            reinterpret_cast<blitz_fftw_complex*>(in), out, FFTW_ESTIMATE);
+        break;
+      case C2C_FORWARD:
+        plan = (*blitz_fftw_plan_guru_dft)(
+            rank, dims, howmanyRank, howmanyDims,
+            reinterpret_cast<blitz_fftw_complex*>(in),
+            reinterpret_cast<blitz_fftw_complex*>(out), 1, FFTW_ESTIMATE);
+        break;
+      case C2C_BACKWARD:
+        plan = (*blitz_fftw_plan_guru_dft)(
+            rank, dims, howmanyRank, howmanyDims,
+            reinterpret_cast<blitz_fftw_complex*>(in),
+            reinterpret_cast<blitz_fftw_complex*>(out), -1, FFTW_ESTIMATE);
+        break;
+      case R2R:
+        plan = (*blitz_fftw_plan_guru_r2r)(
+            rank, dims, howmanyRank, howmanyDims, in, out, kinds,
+            FFTW_ESTIMATE);
+        break;
+      }
+      if (plan != NULL) _planCache[key] = plan;
+    }
+#ifdef _OPENMP
+  }
+#endif
+
+  // fftw refuses e.g. DCT_I of length one
+  if (plan == NULL)
+  {
+    BlitzFFTWError err;
+    err << "BlitzFFTW<DataT>::cachedGuruPlan(): fftw could not create a "
+        << "plan for the requested transform.\n";
+    throw(err);
+  }
+  return plan;
+}
+
+template void BlitzFFTW<float>::setNumThreads(int);
+template int BlitzFFTW<float>::numThreads() const;
+template void BlitzFFTW<float>::clearPlanCache();
+template std::vector<int> BlitzFFTW<float>::planKey(
+    PlanType, int, const int*, float*, float*) const;
+template BlitzFFTW<float>::blitz_fftw_plan BlitzFFTW<float>::cachedPlan(
+    PlanType, int, const int*, float*, float*) const;
+template BlitzFFTW<float>::blitz_fftw_plan BlitzFFTW<float>::cachedGuruPlan(
+    PlanType, int, const fftw_iodim*, int, const fftw_iodim*, float*, float*,
+    const fftw_r2r_kind*) const;
+
+template void BlitzFFTW<double>::setNumThreads(int);
+template int BlitzFFTW<double>::numThreads() const;
+template void BlitzFFTW<double>::clearPlanCache();
+template std::vector<int> BlitzFFTW<double>::planKey(
+    PlanType, int, const int*, double*, double*) const;
+template BlitzFFTW<double>::blitz_fftw_plan BlitzFFTW<double>::cachedPlan(
+    PlanType, int, const int*, double*, double*) const;
+template BlitzFFTW<double>::blitz_fftw_plan
+BlitzFFTW<double>::cachedGuruPlan(
+    PlanType, int, const fftw_iodim*, int, const fftw_iodim*, double*,
+    double*, const fftw_r2r_kind*) const;
@@ -50,6 +50,8 @@
 #endif
 
 #include <set>
+#include <map>
+#include <vector>
 
 typedef int BlitzIndexT;
 
@@ -80,6 +82,17 @@ public:
   enum PaddingType { VALUE, REPEATBORDER, MIRRORBORDER, CYCLICBORDER };
   enum DataPreservePolicy { PRESERVE, OVERWRITE };
 
+  /*======================================================================*/
+  /*!
+   *   The real-to-real transform kinds for r2r(). These are the
+   *   unnormalized discrete cosine (DCT) and sine (DST) transforms of
+   *   FFTW: DCT_II corresponds to FFTW_REDFT10, its inverse DCT_III to
+   *   FFTW_REDFT01 and so on.
+   */
+  /*======================================================================*/
+  enum R2RKind { DCT_I, DCT_II, DCT_III, DCT_IV,
+                 DST_I, DST_II, DST_III, DST_IV };
+
   /*======================================================================*/
   /*!
    *   Get a handle to the Singleton BlitzFFTW Object. If no instance exists
@@ -136,6 +149,46 @@ public:
   /*======================================================================*/
   void saveWisdom() const;
 
+  /*======================================================================*/
+  /*!
+   *   Set the number of threads FFTW uses for every single transform
+   *   planned after this call. This only has an effect if the fftw
+   *   threads libraries were found at build time, otherwise all transforms
+   *   are single-threaded. The default is one thread, which is the right
+   *   choice if many transforms are run concurrently from OpenMP parallel
+   *   regions.
+   *
+   *   Changing the number of threads clears the plan cache, so this must
+   *   not be called while other threads execute transforms.
+   *
+   *   \param nThreads  The number of threads per transform
+   */
+  /*======================================================================*/
+  void setNumThreads(int nThreads);
+
+  /*======================================================================*/
+  /*!
+   *   Get the number of threads FFTW uses per transform.
+   *
+   *   \return The number of threads per transform
+   */
+  /*======================================================================*/
+  int numThreads() const;
+
+  /*======================================================================*/
+  /*!
+   *   Destroy all plans cached by forward() and backward(). The cache
+   *   holds one plan per transform type, shape, in-place-ness and
+   *   memory alignment and is only cleared by this method, by
+   *   setNumThreads() and by clear(). It is not bounded, because a plan
+   *   cannot be evicted while another thread may still execute it, so
+   *   long running processes that transform Arrays of changing shapes
+   *   should call this after finishing each data set. It must not be
+   *   called while other threads execute transforms.
+   */
+  /*======================================================================*/
+  void clearPlanCache();
+
   /*======================================================================*/
   /*!
    *   If you need to know the extents of a padded dataset without
@@ -477,6 +530,10 @@ public:
    *   combination exists it will be computed using the FFTW_ESTIMATE method.
    *   If you want to do many transforms with Arrays of the same shape it
    *   is highly recommended to use fftPlan() once before.
+   *   The plan is cached, so further transforms of Arrays with the same
+   *   shape and alignment are executed without planning. Concurrent calls
+   *   from different threads are safe. Cached plans do not pick up wisdom
+   *   gathered later, so plan a shape before its first transform.
    *   This is the forward transform real to complex.
    *
    *   \param in   The input data Array containing the float data to transform
@@ -496,6 +553,7 @@ public:
    *   it will be computed using the FFTW_ESTIMATE method. If you want to do
    *   many transforms with Arrays of the same shape it is highly recommended
    *   to use fftPlan() once before.
+   *   The plan is cached like in the real to complex forward().
    *   This is the forward transform real to complex.
    *
    *   \param in   The input data Array containing the float data to transform
@@ -516,6 +574,7 @@ public:
    *   combination exists it will be computed using the FFTW_ESTIMATE method.
    *   If you want to do many transforms with Arrays of the same shape it
    *   is highly recommended to use fftPlan() once before.
+   *   The plan is cached like in the real to complex forward().
    *   This is the backward transform complex to real.
    *
    *   \param in   The complex input Array containing the FFT to transform
@@ -537,6 +596,7 @@ public:
    *   it will be computed using the FFTW_ESTIMATE method. If you want to do
    *   many transforms with Arrays of the same shape it is highly recommended
    *   to use fftPlan() once before.
+   *   The plan is cached like in the real to complex forward().
    *   This is the backward transform complex to real.
    *
    *   \param in   The complex input Array containing the FFT to transform
@@ -549,6 +609,143 @@ public:
                 blitz::Array<std::complex<DataT>,Dim>& out,
                 const DataPreservePolicy policy = PRESERVE) const;
 
+  /*======================================================================*/
+  /*!
+   *   Batched real to complex forward transform of a stack of equally
+   *   shaped Arrays. The first batchRank dimensions of the Arrays index
+   *   the transforms, the remaining Dim - batchRank dimensions are
+   *   transformed, e.g. a stack of 2-D images is given as a 3-D Array with
+   *   batchRank 1. All transforms are executed by one cached plan
+   *   (see forward()). The Arrays need not be contiguous.
+   *
+   *   \param in         The stack of real Arrays to transform
+   *   \param out        The stack of transforms. Its last extent is
+   *                     in.extent(Dim - 1) / 2 + 1
+   *   \param batchRank  The number of leading stack dimensions
+   */
+  /*======================================================================*/
+  template<int Dim>
+  void forwardMany(const blitz::Array<DataT,Dim>& in,
+                   blitz::Array<std::complex<DataT>,Dim>& out,
+                   const int batchRank = 1) const;
+
+  /*======================================================================*/
+  /*!
+   *   Batched complex to complex forward transform, see the real to
+   *   complex forwardMany().
+   */
+  /*======================================================================*/
+  template<int Dim>
+  void forwardMany(blitz::Array<std::complex<DataT>,Dim>& in,
+                   blitz::Array<std::complex<DataT>,Dim>& out,
+                   const int batchRank = 1) const;
+
+  /*======================================================================*/
+  /*!
+   *   Batched complex to real backward transform, see the real to complex
+   *   forwardMany(). The complex to real transform destroys its input, so
+   *   with policy PRESERVE the input is copied first.
+   */
+  /*======================================================================*/
+  template<int Dim>
+  void backwardMany(blitz::Array<std::complex<DataT>,Dim>& in,
+                    blitz::Array<DataT,Dim>& out,
+                    const int batchRank = 1,
+                    const DataPreservePolicy policy = PRESERVE) const;
+
+  /*======================================================================*/
+  /*!
+   *   Batched complex to complex backward transform, see the real to
+   *   complex forwardMany().
+   */
+  /*======================================================================*/
+  template<int Dim>
+  void backwardMany(blitz::Array<std::complex<DataT>,Dim>& in,
+                    blitz::Array<std::complex<DataT>,Dim>& out,
+                    const int batchRank = 1) const;
+
+  /*======================================================================*/
+  /*!
+   *   1-D real to complex forward transforms of all lines of the Array
+   *   along the given axis, executed by one cached plan.
+   *
+   *   \param in    The real Array to transform
+   *   \param out   The transformed Array. Its extent along the axis is
+   *               in.extent(axis) / 2 + 1
+   *   \param axis  The dimension to transform along
+   */
+  /*======================================================================*/
+  template<int Dim>
+  void forwardAlongAxis(const blitz::Array<DataT,Dim>& in,
+                        blitz::Array<std::complex<DataT>,Dim>& out,
+                        const int axis) const;
+
+  /*======================================================================*/
+  /*!
+   *   1-D complex to complex forward transforms along the given axis, see
+   *   the real to complex forwardAlongAxis().
+   */
+  /*======================================================================*/
+  template<int Dim>
+  void forwardAlongAxis(blitz::Array<std::complex<DataT>,Dim>& in,
+                        blitz::Array<std::complex<DataT>,Dim>& out,
+                        const int axis) const;
+
+  /*======================================================================*/
+  /*!
+   *   1-D complex to real backward transforms along the given axis, see
+   *   the real to complex forwardAlongAxis() and backwardMany().
+   */
+  /*======================================================================*/
+  template<int Dim>
+  void backwardAlongAxis(blitz::Array<std::complex<DataT>,Dim>& in,
+                         blitz::Array<DataT,Dim>& out,
+                         const int axis,
+                         const DataPreservePolicy policy = PRESERVE) const;
+
+  /*======================================================================*/
+  /*!
+   *   1-D complex to complex backward transforms along the given axis, see
+   *   the real to complex forwardAlongAxis().
+   */
+  /*======================================================================*/
+  template<int Dim>
+  void backwardAlongAxis(blitz::Array<std::complex<DataT>,Dim>& in,
+                         blitz::Array<std::complex<DataT>,Dim>& out,
+                         const int axis) const;
+
+  /*======================================================================*/
+  /*!
+   *   Real to real transform (DCT or DST) of the last Dim - batchRank
+   *   dimensions, using the same kind along every transformed dimension.
+   *   Like FFTW, the transforms are unnormalized. The default batchRank 0
+   *   transforms the whole Array.
+   *
+   *   \param in         The Array to transform
+   *   \param out        The transformed Array of the same shape. It may be
+   *                     the input Array.
+   *   \param kind       The transform kind
+   *   \param batchRank  The number of leading stack dimensions
+   */
+  /*======================================================================*/
+  template<int Dim>
+  void r2r(const blitz::Array<DataT,Dim>& in,
+           blitz::Array<DataT,Dim>& out,
+           const R2RKind kind,
+           const int batchRank = 0) const;
+
+  /*======================================================================*/
+  /*!
+   *   1-D real to real transforms (DCT or DST) of all lines of the Array
+   *   along the given axis, see r2r().
+   */
+  /*======================================================================*/
+  template<int Dim>
+  void r2rAlongAxis(const blitz::Array<DataT,Dim>& in,
+                    blitz::Array<DataT,Dim>& out,
+                    const R2RKind kind,
+                    const int axis) const;
+
   /*---------------------------------------------------------------------
    * (guru interface) executes pre_computet plan with different data
    * use get_plan_X to precompute plans.
@@ -574,6 +771,19 @@ public:
                           blitz_fftw_plan plan,
                           const DataPreservePolicy policy = PRESERVE) const;
 
+  /*---------------------------------------------------------------------
+   * destroys a plan obtained from get_plan_X. Plan destruction is
+   * serialized with plan creation, because both are not thread safe
+   * in the fftw.
+   *--------------------------------------------------------------------*/
+  void destroy_plan(blitz_fftw_plan plan) const
+        {
+#ifdef _OPENMP
+#pragma omp critical (fftwplan)
+#endif
+          (*blitz_fftw_destroy_plan)(plan);
+        }
+
 
   /*======================================================================*/
   /*!
@@ -626,6 +836,7 @@ private:
     ~BlitzFFTWDestructor()
           {
             if (BlitzFFTW::p_instance != 0) {
+              BlitzFFTW::p_instance->saveWisdom();
               delete BlitzFFTW::p_instance;
               BlitzFFTW::p_instance = 0;
             }
@@ -635,6 +846,63 @@ private:
   };
   friend class BlitzFFTWDestructor;
 
+  enum PlanType { R2C, C2R, C2C_FORWARD, C2C_BACKWARD, R2R };
+
+  // Returns the cached FFTW_ESTIMATE plan for the given transform,
+  // creating it on first use. Cached plans must only be executed with
+  // the new-array execute functions.
+  blitz_fftw_plan cachedPlan(
+      PlanType type, int rank, const int *dims, DataT *in, DataT *out) const;
+
+  // A cached plan may be executed on any pair of Arrays with the same key,
+  // even if it was planned for different ones
+  std::vector<int> planKey(
+      PlanType type, int rank, const int *dims, DataT *in, DataT *out) const;
+
+  // Cached FFTW_ESTIMATE guru plan for the *Many(), *AlongAxis() and
+  // r2r() transforms. kinds is only used for R2R plans.
+  blitz_fftw_plan cachedGuruPlan(
+      PlanType type, int rank, const fftw_iodim *dims,
+      int howmanyRank, const fftw_iodim *howmanyDims,
+      DataT *in, DataT *out, const fftw_r2r_kind *kinds = NULL) const;
+
+  // Fills the guru dimensions for transforming dimensions firstDim to
+  // lastDim of the given Arrays and looping over all others. n is the
+  // logical (real) transform shape. Returns the transform rank.
+  template<typename InT, typename OutT, int Dim>
+  static int guruDims(
+      const blitz::Array<InT,Dim>& in, const blitz::Array<OutT,Dim>& out,
+      const blitz::TinyVector<BlitzIndexT,Dim>& n, int firstDim,
+      int lastDim, fftw_iodim *dims, fftw_iodim *howmanyDims,
+      int &howmanyRank);
+
+  template<int Dim>
+  void manyR2C(const blitz::Array<DataT,Dim>& in,
+               blitz::Array<std::complex<DataT>,Dim>& out,
+               int firstDim, int lastDim) const;
+
+  template<int Dim>
+  void manyC2C(blitz::Array<std::complex<DataT>,Dim>& in,
+               blitz::Array<std::complex<DataT>,Dim>& out,
+               int firstDim, int lastDim, PlanType type) const;
+
+  template<int Dim>
+  void manyC2R(blitz::Array<std::complex<DataT>,Dim>& in,
+               blitz::Array<DataT,Dim>& out,
+               int firstDim, int lastDim,
+               const DataPreservePolicy policy) const;
+
+  template<int Dim>
+  void manyR2R(const blitz::Array<DataT,Dim>& in,
+               blitz::Array<DataT,Dim>& out,
+               int firstDim, int lastDim, const R2RKind kind) const;
+
+  static void checkRange(
+      int value, int maxValue, const char *function, const char *name);
+
+  int _nThreads;
+  mutable std::map<std::vector<int>,blitz_fftw_plan> _planCache;
+
   static const size_t maxPrepareFFTSize = 65535;
   static void prepareFFTSizes();
   static std::set<size_t> _bestFFTSizes;
@@ -657,6 +925,16 @@ private:
   void (*blitz_fftw_destroy_plan)(blitz_fftw_plan p);
   void (*blitz_fftw_cleanup)(void);
   void *(*blitz_fftw_malloc)(size_t n);
+  int (*blitz_fftw_alignment_of)(DataT *p);
+  blitz_fftw_plan (*blitz_fftw_plan_guru_dft)(int rank, const fftw_iodim *dims, int howmany_rank, const fftw_iodim *howmany_dims, blitz_fftw_complex *in, blitz_fftw_complex *out, int sign, unsigned flags);
+  blitz_fftw_plan (*blitz_fftw_plan_guru_dft_r2c)(int rank, const fftw_iodim *dims, int howmany_rank, const fftw_iodim *howmany_dims, DataT *in, blitz_fftw_complex *out, unsigned flags);
+  blitz_fftw_plan (*blitz_fftw_plan_guru_dft_c2r)(int rank, const fftw_iodim *dims, int howmany_rank, const fftw_iodim *howmany_dims, blitz_fftw_complex *in, DataT *out, unsigned flags);
+  blitz_fftw_plan (*blitz_fftw_plan_guru_r2r)(int rank, const fftw_iodim *dims, int howmany_rank, const fftw_iodim *howmany_dims, DataT *in, DataT *out, const fftw_r2r_kind *kind, unsigned flags);
+  void (*blitz_fftw_execute_r2r)(const blitz_fftw_plan p, DataT *in, DataT *out);
+
+  // Only set if fftw was built with thread support, NULL otherwise
+  void (*blitz_fftw_plan_with_nthreads)(int nthreads);
+  void (*blitz_fftw_cleanup_threads)(void);
 
 };
 
@@ -277,6 +277,42 @@ int main()
   genHeader << '\n';
   genImpl << '\n';
 
+  // Batched, along-axis and real-to-real transforms, also for stacks of
+  // volumes
+  std::vector<std::string> ManyDim(Dim);
+  ManyDim.push_back("4");
+
+  std::vector<std::string> ManySignature;
+  ManySignature.push_back("void BlitzFFTW<$T>::forwardMany(const blitz::Array<$T,$D>& in, blitz::Array<std::complex<$T>,$D>& out, const int batchRank) const;");
+  ManySignature.push_back("void BlitzFFTW<$T>::forwardMany(blitz::Array<std::complex<$T>,$D>& in, blitz::Array<std::complex<$T>,$D>& out, const int batchRank) const;");
+  ManySignature.push_back("void BlitzFFTW<$T>::backwardMany(blitz::Array<std::complex<$T>,$D>& in, blitz::Array<$T,$D>& out, const int batchRank, const DataPreservePolicy policy) const;");
+  ManySignature.push_back("void BlitzFFTW<$T>::backwardMany(blitz::Array<std::complex<$T>,$D>& in, blitz::Array<std::complex<$T>,$D>& out, const int batchRank) const;");
+  ManySignature.push_back("void BlitzFFTW<$T>::forwardAlongAxis(const blitz::Array<$T,$D>& in, blitz::Array<std::complex<$T>,$D>& out, const int axis) const;");
+  ManySignature.push_back("void BlitzFFTW<$T>::forwardAlongAxis(blitz::Array<std::complex<$T>,$D>& in, blitz::Array<std::complex<$T>,$D>& out, const int axis) const;");
+  ManySignature.push_back("void BlitzFFTW<$T>::backwardAlongAxis(blitz::Array<std::complex<$T>,$D>& in, blitz::Array<$T,$D>& out, const int axis, const DataPreservePolicy policy) const;");
+  ManySignature.push_back("void BlitzFFTW<$T>::backwardAlongAxis(blitz::Array<std::complex<$T>,$D>& in, blitz::Array<std::complex<$T>,$D>& out, const int axis) const;");
+  ManySignature.push_back("void BlitzFFTW<$T>::r2r(const blitz::Array<$T,$D>& in, blitz::Array<$T,$D>& out, const R2RKind kind, const int batchRank) const;");
+  ManySignature.push_back("void BlitzFFTW<$T>::r2rAlongAxis(const blitz::Array<$T,$D>& in, blitz::Array<$T,$D>& out, const R2RKind kind, const int axis) const;");
+
+  for(size_t SigIdx = 0; SigIdx < ManySignature.size(); ++SigIdx) {
+    for(size_t DataTIdx = 0; DataTIdx < DataT.size(); ++DataTIdx) {
+      for(size_t DimIdx = 0; DimIdx < ManyDim.size(); ++DimIdx) {
+        std::string tmp("template " + ManySignature[SigIdx]);
+        size_t pos;
+        while ((pos = tmp.find("$T")) != std::string::npos)
+            tmp.replace(pos, 2, DataT[DataTIdx]);
+        while ((pos = tmp.find("$D")) != std::string::npos)
+            tmp.replace(pos, 2, ManyDim[DimIdx]);
+        genHeader << "extern " << tmp << '\n';
+        genImpl << tmp << '\n';
+      }
+      genHeader << '\n';
+      genImpl << '\n';
+    }
+    genHeader << '\n';
+    genImpl << '\n';
+  }
+
 
   // finished template instantiations
   genHeader << '\n';
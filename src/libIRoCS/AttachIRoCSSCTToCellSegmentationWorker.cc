@@ -28,6 +28,8 @@
 #include <libArrayToolbox/algo/lmorph.hh>
 #include <libArrayToolbox/algo/lrootShapeAnalysis.hh>
 
+#include <libBlitzFFTW/BlitzFFTW.hh>
+
 namespace iRoCS
 {
   
@@ -198,7 +200,22 @@ namespace iRoCS
     }
     atb::GaussianFilter<double,3> filter(
         blitz::TinyVector<double,3>(10.0), atb::RepeatBT);
+    filter.setImplementation(atb::AutoGaussian);
+    blitz::TinyVector<atb::GaussianFilterImplementation,3> implementation =
+        filter.selectImplementation(bw.shape(), segmentation.elementSizeUm());
+    std::cout << "  Smoothing implementation: "
+              << atb::gaussianFilterImplementationToString(implementation(0))
+              << ", "
+              << atb::gaussianFilterImplementationToString(implementation(1))
+              << ", "
+              << atb::gaussianFilterImplementationToString(implementation(2))
+              << " (error bound "
+              << filter.errorBound(bw.shape(), segmentation.elementSizeUm())
+              << ")" << std::endl;
     filter.apply(bw, segmentation.elementSizeUm(), bw, pr);
+    // The FFT plans are specific to the shape of this segmentation and
+    // would otherwise accumulate in the process wide plan cache
+    BlitzFFTW<double>::instance()->clearPlanCache();
     pState++;
 
     if (pr != NULL && !pr->updateProgressMessage(mVec[pState])) return;
@@ -22,16 +22,20 @@
 
 #include "DetectNucleiWorker.hh"
 #include "iRoCSFeatures.hh"
+#include "DetectorCascade.hh"
 
 #include <libArrayToolbox/LocalMaximumExtraction.hh>
 
+#include <algorithm>
+
 namespace iRoCS
 {
 
   void detectNuclei(
       atb::Array<double,3> const &data, std::vector<atb::Nucleus> &nuclei,
       std::string const &modelFileName, ptrdiff_t memoryLimit,
-      std::string const &cacheFileName, ProgressReporter *pr)
+      std::string const &cacheFileName, bool nonMaximumSuppression,
+      ProgressReporter *pr)
   {
     double sigmaMin = 0.5;
     double sigmaMax = 64.0;
@@ -68,8 +72,18 @@ namespace iRoCS
       return;
     }
 
-    if (pr != NULL && !pr->updateProgressMessage("Computing chunk size"))
-        return;
+    DetectorCascade cascade;
+    try
+    {
+      cascade.load(modelFileName);
+    }
+    catch (std::exception &e)
+    {
+      if (pr != NULL) pr->abortWithError(
+          "Could not load cascade stage from '" + modelFileName + "': " +
+          e.what());
+      return;
+    }
 
     blitz::TinyVector<ptrdiff_t,3> featureShape(
         blitz::TinyVector<double,3>(data.shape()) * data.elementSizeUm() /
@@ -81,17 +95,72 @@ namespace iRoCS
             for (int band = 0; band <= bandMax - 2 * laplace; ++band)
                 nFeatures++;
     nFeatures += 4; // The hough features
+    int houghIdxBase = nFeatures - 4;
 
     ptrdiff_t nVoxels = blitz::product(featureShape);
-    ptrdiff_t memNeeded = nVoxels * nFeatures * sizeof(double);
+
+    classification.resize(featureShape);
+    classification.setElementSizeUm(features.elementSizeUm());
+
+    // The voxels to sample features at and to classify with the SVM
+    std::vector<ptrdiff_t> candidates;
+    if (cascade.enabled())
+    {
+      if (pr != NULL && !pr->updateProgressMessage("Running cascade stage"))
+          return;
+
+      // The linear stage only needs the Hough features. They are kept for
+      // the first chunk below.
+      std::vector<double> score(nVoxels, cascade.offset());
+      for (size_t k = 0; k < cascade.weights().size(); ++k)
+      {
+        int feaIdx = cascade.featureIndices()[k];
+        if (feaIdx < houghIdxBase || feaIdx >= nFeatures)
+        {
+          if (pr != NULL) pr->abortWithError(
+              "The cascade stage in '" + modelFileName + "' uses features "
+              "other than the Hough features");
+          return;
+        }
+        atb::Array<double,3> &fea = features.houghFeature(
+            data, iRoCS::Features::PositiveMagnitude + feaIdx - houghIdxBase,
+            cacheFileName);
+        if (pr != NULL && pr->isAborted()) return;
+        double weight = cascade.weights()[k];
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (ptrdiff_t j = 0; j < nVoxels; ++j)
+            score[j] += weight * fea.data()[j];
+      }
+      for (ptrdiff_t j = 0; j < nVoxels; ++j)
+          if (score[j] >= 0.0) candidates.push_back(j);
+
+      // Rejected voxels get the decision value of clear background
+      classification = -1.0f;
+      std::cout << "Cascade stage passed " << candidates.size() << " of "
+                << nVoxels << " voxels" << std::endl;
+    }
+    else
+    {
+      candidates.resize(nVoxels);
+      for (ptrdiff_t j = 0; j < nVoxels; ++j) candidates[j] = j;
+    }
+
+    if (pr != NULL && !pr->updateProgressMessage("Computing chunk size"))
+        return;
+
+    ptrdiff_t nCandidates = static_cast<ptrdiff_t>(candidates.size());
+    ptrdiff_t memNeeded = nCandidates * nFeatures * sizeof(double);
     ptrdiff_t nChunks = (memoryLimit != 0) ?
         (memNeeded / memoryLimit + ((memNeeded % memoryLimit > 0) ? 1 : 0)) :
         1;
-    ptrdiff_t chunkSize = nVoxels / nChunks;
-    ptrdiff_t residualFeatures = nVoxels % nChunks;
+    if (nCandidates == 0) nChunks = 0;
+    ptrdiff_t chunkSize = (nChunks > 0) ? nCandidates / nChunks : 0;
+    ptrdiff_t residualFeatures = (nChunks > 0) ? nCandidates % nChunks : 0;
 
     std::cout << "Classifying in " << nChunks << " chunk"
-              << ((nChunks > 1) ? "s" : "") << " with chunksize "
+              << ((nChunks != 1) ? "s" : "") << " with chunksize "
               << chunkSize << " (" << chunkSize * nFeatures *
         sizeof(double) / 1024 / 1024 << " MB)" << std::endl;
 
@@ -104,12 +173,10 @@ namespace iRoCS
     for (size_t i = 0; i < testVectors.size(); ++i)
         testVectors[i].resize(nFeatures);
 
-    classification.resize(featureShape);
-    classification.setElementSizeUm(features.elementSizeUm());
-
     if (pr != NULL && pr->isAborted()) return;
 
-    double progressPerChunk = 100.0 / static_cast<double>(nChunks);
+    double progressPerChunk =
+        100.0 / static_cast<double>(std::max(nChunks, ptrdiff_t(1)));
     double progressLoadFeatures = progressPerChunk * 0.1;
     double progressStepPerFeatureLoad = progressLoadFeatures / nFeatures;
     double progressClassify = progressPerChunk - progressLoadFeatures;
@@ -119,6 +186,32 @@ namespace iRoCS
          ++chunk, currentPos += testVectors.size())
     {
       if (chunk != 0) testVectors.resize(chunkSize);
+      ptrdiff_t const *voxels = &candidates[currentPos];
+      int nLoaded = 0;
+
+      // Compute hough features first, the cascade stage may still hold them
+      for (int i = iRoCS::Features::PositiveMagnitude;
+           i <= iRoCS::Features::NegativeRadius; ++i, ++nLoaded)
+      {
+        int feaIdx = houghIdxBase + i - iRoCS::Features::PositiveMagnitude;
+        atb::Array<double,3> &fea =
+            features.houghFeature(data, i, cacheFileName);
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (ptrdiff_t j = 0; j < static_cast<ptrdiff_t>(testVectors.size());
+             ++j)
+            testVectors[j][feaIdx] = fea.data()[voxels[j]];
+
+        int progress = static_cast<int>(
+            static_cast<double>(chunk) * progressPerChunk +
+            static_cast<double>(nLoaded) * progressStepPerFeatureLoad);
+        if (pr != NULL &&
+            !pr->updateProgress(static_cast<int>(progress))) return;
+
+        features.deleteFeature(i);
+      }
 
       // Compute SD features
       int feaIdx = 0;
@@ -127,7 +220,7 @@ namespace iRoCS
         for (int laplace = 0; laplace <= bandMax / 2; ++laplace)
         {
           int maxBand = bandMax - 2 * laplace;
-          for (int band = 0; band <= maxBand; ++band, ++feaIdx)
+          for (int band = 0; band <= maxBand; ++band, ++feaIdx, ++nLoaded)
           {
             atb::Array<double,3> &fea = features.sdFeature(
                 data, atb::SDMagFeatureIndex(sigma, laplace, band), maxBand,
@@ -138,11 +231,11 @@ namespace iRoCS
 #endif
             for (ptrdiff_t j = 0;
                  j < static_cast<ptrdiff_t>(testVectors.size()); ++j)
-                testVectors[j][feaIdx] = fea.data()[currentPos + j];
+                testVectors[j][feaIdx] = fea.data()[voxels[j]];
 
             int progress = static_cast<int>(
                 static_cast<double>(chunk) * progressPerChunk +
-                static_cast<double>(feaIdx) * progressStepPerFeatureLoad);
+                static_cast<double>(nLoaded) * progressStepPerFeatureLoad);
             if (pr != NULL && !pr->updateProgress(progress)) return;
           }
           for (int band = 1; band <= bandMax - 2 * laplace; ++band)
@@ -155,29 +248,6 @@ namespace iRoCS
         features.deleteFeature(atb::SDMagFeatureIndex(sigma, 0, 0));
       }
     
-      // Compute hough features
-      for (int i = iRoCS::Features::PositiveMagnitude;
-           i <= iRoCS::Features::NegativeRadius; ++i, ++feaIdx)
-      {
-        atb::Array<double,3> &fea =
-            features.houghFeature(data, i, cacheFileName);
-
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-        for (ptrdiff_t j = 0; j < static_cast<ptrdiff_t>(testVectors.size());
-             ++j)
-            testVectors[j][feaIdx] = fea.data()[currentPos + j];
-
-        int progress = static_cast<int>(
-            static_cast<double>(chunk) * progressPerChunk +
-            static_cast<double>(feaIdx) * progressStepPerFeatureLoad);
-        if (pr != NULL &&
-            !pr->updateProgress(static_cast<int>(progress))) return;
-
-        features.deleteFeature(i);
-      }
-    
       if (pr != NULL && !pr->updateProgressMessage("Normalizing features"))
           return;
       features.normalizeFeatures(testVectors);
@@ -197,9 +267,12 @@ namespace iRoCS
 #pragma omp parallel for
 #endif
       for (ptrdiff_t j = 0; j < static_cast<ptrdiff_t>(testVectors.size()); ++j)
-          classification.data()[currentPos + j] =
+          classification.data()[voxels[j]] =
               static_cast<float>(testVectors[j].getLabel());
     }
+    // Hough features computed by the cascade stage but never sampled
+    for (int i = iRoCS::Features::PositiveMagnitude;
+         i <= iRoCS::Features::NegativeRadius; ++i) features.deleteFeature(i);
   
     if (pr != NULL) pr->updateProgressMessage(
         "Freeing memory used up by features");
@@ -224,47 +297,77 @@ namespace iRoCS
     if (pr != NULL && !pr->updateProgressMessage("Extracting local maxima"))
         return;
 
-    std::vector< blitz::TinyVector<ptrdiff_t,3> > lcMax;
-    atb::extractLocalMaxima(
-        classification, lcMax, 0.0f, atb::SIMPLE_NHOOD, pr);
-    std::cout << "  " << lcMax.size() << " local maxima extracted" << std::endl;
-
-    if (pr != NULL && pr->isAborted()) return;
-
-    // Remove overlapping detections
-    if (pr != NULL && !pr->updateProgressMessage("Removing overlapping nuclei"))
-        return;
-    std::vector<atb::Nucleus> ncTmp;
-    for (size_t i = 0; i < lcMax.size(); ++i)
+    double minDist = 3.0;
+    if (nonMaximumSuppression)
     {
+      // Non-maximum suppression over the 3x3x3 neighborhood, maxima closer
+      // than minDist to a stronger one are removed during extraction.
+      // Only interior voxels are candidates. In contrast to strict
+      // 6-neighborhood maxima, plateau voxels are candidates and are
+      // thinned out by minDist, and voxels with a stronger diagonal
+      // neighbor are no candidates.
+      std::vector< atb::LocalMaximum<float,3> > lcMax;
+      atb::extractLocalMaximaNMS(
+          classification, lcMax, blitz::TinyVector<atb::BlitzIndexT,3>(1),
+          0.0f, classification.elementSizeUm(), minDist, 0, false, true, pr);
+
       if (pr != NULL && pr->isAborted()) return;
-      atb::Nucleus nc;
-      nc.setPositionUm(
-          blitz::TinyVector<double,3>(
-              lcMax[i] * classification.elementSizeUm()));
-      nc.setRadiusUm(2.0);
-      nc.setValue(static_cast<double>(classification(lcMax[i])));
-      ncTmp.push_back(nc);
-    }
-    lcMax.clear();
 
-    std::sort(ncTmp.begin(), ncTmp.end());
-    std::reverse(ncTmp.begin(), ncTmp.end());
-    std::vector<atb::Nucleus>::const_iterator ncIt2;
-    double minDist = 3.0;
-    for (size_t i = 0; i < ncTmp.size(); ++i)
+      for (size_t i = 0; i < lcMax.size(); ++i)
+      {
+        atb::Nucleus nc;
+        nc.setPositionUm(
+            blitz::TinyVector<double,3>(
+                lcMax[i].position * classification.elementSizeUm()));
+        nc.setRadiusUm(2.0);
+        nc.setValue(static_cast<double>(lcMax[i].value));
+        nuclei.push_back(nc);
+      }
+      lcMax.clear();
+    }
+    else
     {
+      std::vector< blitz::TinyVector<ptrdiff_t,3> > lcMax;
+      atb::extractLocalMaxima(
+          classification, lcMax, 0.0f, atb::SIMPLE_NHOOD, pr);
+      std::cout << "  " << lcMax.size() << " local maxima extracted"
+                << std::endl;
+
       if (pr != NULL && pr->isAborted()) return;
-      size_t j = 0;
-      for (; j < nuclei.size(); ++j)
+
+      // Remove overlapping detections
+      if (pr != NULL &&
+          !pr->updateProgressMessage("Removing overlapping nuclei")) return;
+      std::vector<atb::Nucleus> ncTmp;
+      for (size_t i = 0; i < lcMax.size(); ++i)
       {
-        if (blitz::dot(ncTmp[i].positionUm() - nuclei[j].positionUm(),
-                       ncTmp[i].positionUm() - nuclei[j].positionUm()) <
-            blitz::pow2(minDist)) break;
+        if (pr != NULL && pr->isAborted()) return;
+        atb::Nucleus nc;
+        nc.setPositionUm(
+            blitz::TinyVector<double,3>(
+                lcMax[i] * classification.elementSizeUm()));
+        nc.setRadiusUm(2.0);
+        nc.setValue(static_cast<double>(classification(lcMax[i])));
+        ncTmp.push_back(nc);
+      }
+      lcMax.clear();
+
+      std::sort(ncTmp.begin(), ncTmp.end());
+      std::reverse(ncTmp.begin(), ncTmp.end());
+      for (size_t i = 0; i < ncTmp.size(); ++i)
+      {
+        if (pr != NULL && pr->isAborted()) return;
+        size_t j = 0;
+        for (; j < nuclei.size(); ++j)
+        {
+          if (blitz::dot(ncTmp[i].positionUm() - nuclei[j].positionUm(),
+                         ncTmp[i].positionUm() - nuclei[j].positionUm()) <
+              blitz::pow2(minDist)) break;
+        }
+        if (j == nuclei.size()) nuclei.push_back(ncTmp[i]);
       }
-      if (j == nuclei.size()) nuclei.push_back(ncTmp[i]);
+      ncTmp.clear();
     }
-    ncTmp.clear();
     std::cout << "  " << nuclei.size() << " nucleus candidates remaining"
               << std::endl;
   }
@@ -35,10 +35,16 @@
 namespace iRoCS
 {
   
+  // If nonMaximumSuppression is set, the candidates are extracted with
+  // atb::extractLocalMaximaNMS() (3x3x3 box, interior voxels only) instead
+  // of the 6-neighborhood maxima followed by the greedy 3um overlap
+  // removal. Both are close, but the candidate sets can differ on plateaus
+  // and next to stronger diagonal neighbors.
   void detectNuclei(
       atb::Array<double,3> const &data, std::vector<atb::Nucleus> &nuclei,
       std::string const &modelFileName, ptrdiff_t memoryLimit,
-      std::string const &cacheFileName = "", ProgressReporter *pr = NULL);
+      std::string const &cacheFileName = "",
+      bool nonMaximumSuppression = false, ProgressReporter *pr = NULL);
 
 }
 
@@ -0,0 +1,236 @@
+/**************************************************************************
+ *
+ * Copyright (C) 2015 Thorsten Falk
+ *
+ *        Image Analysis Lab, University of Freiburg, Germany
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ *
+ **************************************************************************/
+
+#include "DetectorCascade.hh"
+
+#include <algorithm>
+#include <cmath>
+
+#include <libsvmtl/StDataHdf5.hh>
+#include <libsvmtl/TwoClassSVMc.hh>
+#include <libsvmtl/Kernel_LINEAR.hh>
+#include <libsvmtl/Model.hh>
+#include <libsvmtl/ModelOptimizer_linearNormal.hh>
+
+namespace iRoCS
+{
+
+  DetectorCascade::DetectorCascade()
+          : _featureIndices(), _weights(), _offset(0.0), _targetRecall(1.0),
+            _rejectionRate(0.0)
+  {}
+
+  bool DetectorCascade::enabled() const
+  {
+    return _weights.size() != 0;
+  }
+
+  void DetectorCascade::train(
+      std::vector<svt::BasicFV> const &samples,
+      std::vector<int> const &featureIndices, double targetRecall,
+      ProgressReporter *pr)
+  {
+    _featureIndices.clear();
+    _weights.clear();
+    _offset = 0.0;
+    _targetRecall = std::min(1.0, std::max(0.0, targetRecall));
+    _rejectionRate = 0.0;
+
+    size_t nFeatures = featureIndices.size();
+    if (samples.size() == 0 || nFeatures == 0) return;
+
+    if (pr != NULL && !pr->updateProgressMessage("Training cascade stage"))
+        return;
+
+    // Standardize the stage features, so that the linear SVM is not
+    // dominated by the feature with the largest range
+    std::vector<double> mean(nFeatures, 0.0), stddev(nFeatures, 0.0);
+    for (size_t i = 0; i < samples.size(); ++i)
+        for (size_t k = 0; k < nFeatures; ++k)
+            mean[k] += samples[i][featureIndices[k]];
+    for (size_t k = 0; k < nFeatures; ++k)
+        mean[k] /= static_cast<double>(samples.size());
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+      for (size_t k = 0; k < nFeatures; ++k)
+      {
+        double d = samples[i][featureIndices[k]] - mean[k];
+        stddev[k] += d * d;
+      }
+    }
+    for (size_t k = 0; k < nFeatures; ++k)
+    {
+      stddev[k] = std::sqrt(stddev[k] / static_cast<double>(samples.size()));
+      if (stddev[k] == 0.0) stddev[k] = 1.0;
+    }
+
+    std::vector<svt::BasicFV> stageSamples(samples.size());
+    for (size_t i = 0; i < samples.size(); ++i)
+    {
+      stageSamples[i].resize(nFeatures);
+      for (size_t k = 0; k < nFeatures; ++k)
+          stageSamples[i][k] =
+              (samples[i][featureIndices[k]] - mean[k]) / stddev[k];
+      stageSamples[i].setLabel((samples[i].getLabel() > 0) ? 1 : -1);
+      stageSamples[i].setUniqueID(static_cast<unsigned int>(i));
+    }
+
+    svt::Model<svt::BasicFV> model;
+    svt::TwoClassSVMc<svt::Kernel_LINEAR> svm;
+    svm.setCost(1.0);
+    svm.updateKernelCache(
+        stageSamples.begin(), stageSamples.end(), svt::DirectAccessor());
+    svm.train(stageSamples.begin(), stageSamples.end(), model);
+    if (model.size() == 0) return;
+
+    // Collapse the expansion into its normal vector. The model does not own
+    // the normal, so it is released here.
+    svt::ModelOptimizer_linearNormal<svt::BasicFV> optimizer;
+    svt::BasicFV *normal = optimizer.optimizeTwoClassModel(model, 0);
+    std::vector<double> w(nFeatures);
+    for (size_t k = 0; k < nFeatures; ++k) w[k] = (*normal)[k];
+    delete normal;
+
+    // Lower the threshold until targetRecall of the positives pass
+    std::vector<double> positiveScores, negativeScores;
+    for (size_t i = 0; i < stageSamples.size(); ++i)
+    {
+      double s = 0.0;
+      for (size_t k = 0; k < nFeatures; ++k) s += w[k] * stageSamples[i][k];
+      if (stageSamples[i].getLabel() > 0) positiveScores.push_back(s);
+      else negativeScores.push_back(s);
+    }
+    if (positiveScores.size() == 0) return;
+    std::sort(positiveScores.begin(), positiveScores.end());
+    size_t nRejectedPositives = static_cast<size_t>(
+        std::floor((1.0 - _targetRecall) *
+                   static_cast<double>(positiveScores.size())));
+    nRejectedPositives = std::min(
+        nRejectedPositives, positiveScores.size() - 1);
+    // The margin keeps the threshold sample accepted after the weights are
+    // rescaled below
+    double threshold = positiveScores[nRejectedPositives];
+    threshold -= 1e-9 * (1.0 + std::abs(threshold));
+
+    size_t nRejectedNegatives = 0;
+    for (size_t i = 0; i < negativeScores.size(); ++i)
+        if (negativeScores[i] < threshold) nRejectedNegatives++;
+    _rejectionRate = (negativeScores.size() > 0) ?
+        static_cast<double>(nRejectedNegatives) /
+        static_cast<double>(negativeScores.size()) : 0.0;
+
+    // Fold standardization and threshold into weights and offset
+    _featureIndices = featureIndices;
+    _weights.resize(nFeatures);
+    _offset = -threshold;
+    for (size_t k = 0; k < nFeatures; ++k)
+    {
+      _weights[k] = w[k] / stddev[k];
+      _offset -= _weights[k] * mean[k];
+    }
+
+    std::cout << "Cascade stage rejects " << 100.0 * _rejectionRate
+              << "% of the negative training samples at "
+              << 100.0 * _targetRecall << "% target recall" << std::endl;
+  }
+
+  double DetectorCascade::score(svt::BasicFV const &fv) const
+  {
+    double s = _offset;
+    for (size_t k = 0; k < _weights.size(); ++k)
+        s += _weights[k] * fv[_featureIndices[k]];
+    return s;
+  }
+
+  bool DetectorCascade::accept(svt::BasicFV const &fv) const
+  {
+    return !enabled() || score(fv) >= 0.0;
+  }
+
+  std::vector<int> const &DetectorCascade::featureIndices() const
+  {
+    return _featureIndices;
+  }
+
+  std::vector<double> const &DetectorCascade::weights() const
+  {
+    return _weights;
+  }
+
+  double DetectorCascade::offset() const
+  {
+    return _offset;
+  }
+
+  double DetectorCascade::targetRecall() const
+  {
+    return _targetRecall;
+  }
+
+  double DetectorCascade::rejectionRate() const
+  {
+    return _rejectionRate;
+  }
+
+  void DetectorCascade::save(std::string const &modelFileName) const
+  {
+    if (!enabled()) return;
+    svt::StDataHdf5 modelMap(modelFileName.c_str(), H5F_ACC_RDWR);
+    modelMap.setExceptionFlag(true);
+    modelMap.setArray(
+        "cascade_featureIndices", _featureIndices.begin(),
+        _featureIndices.size());
+    modelMap.setArray("cascade_weights", _weights.begin(), _weights.size());
+    modelMap.setValue("cascade_offset", _offset);
+    modelMap.setValue("cascade_targetRecall", _targetRecall);
+    modelMap.setValue("cascade_rejectionRate", _rejectionRate);
+  }
+
+  bool DetectorCascade::load(std::string const &modelFileName)
+  {
+    _featureIndices.clear();
+    _weights.clear();
+    _offset = 0.0;
+    _targetRecall = 1.0;
+    _rejectionRate = 0.0;
+
+    svt::StDataHdf5 modelMap(modelFileName.c_str());
+    modelMap.setExceptionFlag(true);
+    if (!modelMap.valueExists("cascade_offset")) return false;
+
+    size_t nFeatures = modelMap.getArraySize("cascade_weights");
+    std::vector<int> featureIndices(nFeatures);
+    std::vector<double> weights(nFeatures);
+    modelMap.getArray(
+        "cascade_featureIndices", featureIndices.begin(),
+        static_cast<int>(nFeatures));
+    modelMap.getArray(
+        "cascade_weights", weights.begin(), static_cast<int>(nFeatures));
+    modelMap.getValue("cascade_offset", _offset);
+    modelMap.getValue("cascade_targetRecall", _targetRecall);
+    modelMap.getValue("cascade_rejectionRate", _rejectionRate);
+    _featureIndices = featureIndices;
+    _weights = weights;
+    return true;
+  }
+
+}
@@ -0,0 +1,148 @@
+/**************************************************************************
+ *
+ * Copyright (C) 2015 Thorsten Falk
+ *
+ *        Image Analysis Lab, University of Freiburg, Germany
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ *
+ **************************************************************************/
+
+#ifndef DETECTORCASCADE_HH
+#define DETECTORCASCADE_HH
+
+#ifdef HAVE_CONFIG_H
+#include <config.hh>
+#endif
+
+#include <string>
+#include <vector>
+
+#include <libProgressReporter/ProgressReporter.hh>
+
+#include <libsvmtl/BasicFV.hh>
+
+namespace iRoCS
+{
+
+/*======================================================================*/
+/*!
+ *  \class DetectorCascade DetectorCascade.hh "libIRoCS/DetectorCascade.hh"
+ *  \brief The DetectorCascade class is a cheap linear rejection stage run
+ *    before the RBF-SVM of the nucleus detector.
+ *
+ *  The stage scores a voxel with a linear function of a few raw features
+ *  (the Hough features in the detector). Its normal is obtained by
+ *  training a linear SVM on the standardized features and collapsing the
+ *  model with svt::ModelOptimizer_linearNormal. The threshold is then
+ *  lowered until the given fraction (the target recall) of the positive
+ *  training samples passes. Voxels scoring below the threshold are
+ *  rejected and need neither SD feature sampling nor RBF evaluation.
+ *
+ *  Standardization and threshold are folded into the stored weights, so a
+ *  voxel is accepted iff offset() + sum_k weights()[k] * x[featureIndices()[k]]
+ *  is non-negative.
+ */
+/*======================================================================*/
+  class DetectorCascade
+  {
+
+  public:
+
+    DetectorCascade();
+
+/*======================================================================*/
+/*!
+ *   Check whether a trained or loaded stage is available.
+ *
+ *   \return false if no stage is set, i.e. all voxels are accepted
+ */
+/*======================================================================*/
+    bool enabled() const;
+
+/*======================================================================*/
+/*!
+ *   Train the linear stage.
+ *
+ *   \param samples         The training samples with unnormalized
+ *     features. Samples with label > 0 are positive.
+ *   \param featureIndices  The feature vector components the stage uses
+ *   \param targetRecall    The fraction of positive training samples that
+ *     must pass the stage (in (0, 1])
+ *   \param pr              If given progress will be reported to this
+ *     ProgressReporter
+ */
+/*======================================================================*/
+    void train(
+        std::vector<svt::BasicFV> const &samples,
+        std::vector<int> const &featureIndices, double targetRecall,
+        ProgressReporter *pr = NULL);
+
+    double score(svt::BasicFV const &fv) const;
+
+    bool accept(svt::BasicFV const &fv) const;
+
+    std::vector<int> const &featureIndices() const;
+    std::vector<double> const &weights() const;
+    double offset() const;
+    double targetRecall() const;
+
+/*======================================================================*/
+/*!
+ *   Get the fraction of negative training samples the stage rejects.
+ *
+ *   \return The training rejection rate
+ */
+/*======================================================================*/
+    double rejectionRate() const;
+
+/*======================================================================*/
+/*!
+ *   Save the stage to the given svmtl model file. The file must exist.
+ *
+ *   \param modelFileName The hdf5 model file
+ *
+ *   \exception std::exception If the file cannot be written
+ */
+/*======================================================================*/
+    void save(std::string const &modelFileName) const;
+
+/*======================================================================*/
+/*!
+ *   Load the stage from the given svmtl model file. Models without
+ *   cascade leave the stage disabled.
+ *
+ *   \param modelFileName The hdf5 model file
+ *
+ *   \return true if a stage was loaded
+ *
+ *   \exception std::exception If the file or the stage cannot be read
+ */
+/*======================================================================*/
+    bool load(std::string const &modelFileName);
+
+  private:
+
+    std::vector<int> _featureIndices;
+    std::vector<double> _weights;
+    double _offset;
+    double _targetRecall;
+    double _rejectionRate;
+
+  };
+
+}
+
+#endif
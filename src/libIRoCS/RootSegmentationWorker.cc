@@ -29,6 +29,7 @@
 #include <libArrayToolbox/MedianFilter.hh>
 #include <libArrayToolbox/GaussianFilter.hh>
 #include <libArrayToolbox/AnisotropicDiffusionFilter.hh>
+#include <libArrayToolbox/HessianEigenFilter.hh>
 #include <libArrayToolbox/ATBLinAlg.hh>
 #include <libArrayToolbox/ATBMorphology.hh>
 #include <libArrayToolbox/algo/ltransform.hh> // For randomColorMapping
@@ -89,13 +90,45 @@ namespace iRoCS
     }
   }
 
+  // Stores the smallest hessian eigenvalue, its eigenvector and the
+  // magnitude of the eigenvector's z component
+  class SmallestHessianEigenvectorVisitor
+  {
+
+  public:
+
+    static bool const needsEigenvectors = true;
+
+    SmallestHessianEigenvectorVisitor(
+        double *l1, blitz::TinyVector<double,3> *v1, double *v1z)
+            : p_l1(l1), p_v1(v1), p_v1z(v1z)
+    {}
+
+    void operator()(
+        ptrdiff_t i, blitz::TinyVector<double,3> const &lambda,
+        blitz::TinyMatrix<double,3,3> const &U)
+    {
+      p_l1[i] = lambda(0);
+      p_v1[i] = U(0, 0), U(1, 0), U(2, 0);
+      p_v1z[i] = std::abs(U(0, 0));
+    }
+
+  private:
+
+    double *p_l1;
+    blitz::TinyVector<double,3> *p_v1;
+    double *p_v1z;
+
+  };
+
   void segmentCells(
       atb::Array<double,3> &data, atb::Array<int,3> &segmentation, double gamma,
       int normalizationType, int medianWidthPx, double processingElementSizeUm,
       double varSigmaUm, double varEpsilon, float sigmaHessianUm,
       bool preDiffusion, int nDiffusionIterations, float zCompensationFactor,
       double kappa, float deltaT, float l1Threshold, float volumeThresholdUm,
-      int boundaryThicknessPx, std::string const &debugFileName,
+      int boundaryThicknessPx, double diffusionMemoryLimitGB,
+      int watershedLevels, std::string const &debugFileName,
       iRoCS::ProgressReporter *pr)
   {
     double proc = (processingElementSizeUm <= 0.0) ?
@@ -388,15 +421,30 @@ namespace iRoCS
 
     if (preDiffusion)
     {
+      atb::AnisotropicDiffusionFilter<double,3> anisotropicDiffusionFilter(
+          kappa, sigmaHessianUm, deltaT, zCompensationFactor,
+          nDiffusionIterations, 4, atb::RepeatBT);
+      // Fall back to the single precision slab-wise mode if the default
+      // mode would exceed the memory limit
+      double gigabyte = 1024.0 * 1024.0 * 1024.0;
+      if (diffusionMemoryLimitGB > 0.0 &&
+          static_cast<double>(
+              anisotropicDiffusionFilter.peakMemoryBytes(data.shape())) >
+          diffusionMemoryLimitGB * gigabyte)
+          anisotropicDiffusionFilter.setLowMemory(true);
+      std::stringstream msg;
+      msg << mVec[pState] << " (peak memory "
+          << static_cast<double>(
+              anisotropicDiffusionFilter.peakMemoryBytes(data.shape())) /
+          gigabyte << " GB"
+          << (anisotropicDiffusionFilter.lowMemory() ? ", low memory" : "")
+          << ")";
       if (pr != NULL)
       {
-        if (!pr->updateProgressMessage(mVec[pState])) return;
+        if (!pr->updateProgressMessage(msg.str())) return;
         pr->setTaskProgressMin((pState > 0) ? pVec[pState - 1] : 0);
         pr->setTaskProgressMax(pVec[pState]);
       }
-      atb::AnisotropicDiffusionFilter<double,3> anisotropicDiffusionFilter(
-          kappa, sigmaHessianUm, deltaT, zCompensationFactor,
-          nDiffusionIterations, 4, atb::RepeatBT);
       anisotropicDiffusionFilter.apply(data, data, pr);
       pState++;
       if (debugFileName != "")
@@ -431,63 +479,33 @@ namespace iRoCS
         blitz::TinyVector<double,3>(sigmaHessianUm));
     gaussianFilter.apply(data, data);
 
-    atb::Array<blitz::TinyVector<double,6>,3> hessian(
-        data.shape(), data.elementSizeUm());
-    atb::CentralHessianUTFilter<double,3> hessianFilter(atb::MirrorBT);
-    hessianFilter.apply(data, hessian, pr);
-
     pState++;
 
-    if (pr != NULL && !pr->updateProgressMessage(mVec[pState])) return;
+    // Only the smallest eigenvalue and its eigenvector are needed, so the
+    // hessian is decomposed on the fly without storing it
+    if (pr != NULL)
+    {
+      if (!pr->updateProgressMessage(mVec[pState])) return;
+      pr->setTaskProgressMin((pState > 0) ? pVec[pState - 1] : 0);
+      pr->setTaskProgressMax(pVec[pState]);
+    }
     atb::Array<double,3> l1(data.shape(), data.elementSizeUm());
     atb::Array<blitz::TinyVector<double,3>,3> v1(
         data.shape(), data.elementSizeUm());
     atb::Array<double,3> v1z(data.shape(), data.elementSizeUm());
+    SmallestHessianEigenvectorVisitor visitor(
+        l1.data(), v1.data(), v1z.data());
+    atb::HessianEigenFilter<double,3> hessianFilter(atb::MirrorBT);
+    hessianFilter.decompose(data, data.elementSizeUm(), visitor, pr);
+    if (pr != NULL && pr->isAborted()) return;
+
     double varSum = 0.0;
-    int p = 0;
-    double prStart = (pState > 0) ? pVec[pState - 1] : 0;
-    double prScale = static_cast<double>(pVec[pState] - prStart) /
-        static_cast<double>(data.size() - 1);
 #ifdef _OPENMP
-#pragma omp parallel for
+#pragma omp parallel for reduction(+:varSum)
 #endif
-    for (ptrdiff_t i = 0; i < static_cast<ptrdiff_t>(data.size()); ++i)
-    {
-      if (pr != NULL)
-      {
-        if (pr->isAborted()) continue;
-        int progress = 0;
-#ifdef _OPENMP
-#pragma omp critical
-#endif
-        {
-          progress = p;
-          ++p;
-        }
-        if (progress % std::max(1, static_cast<int>(data.size() / 100)) == 0)
-            pr->updateProgress(
-                static_cast<int>(prStart + progress * prScale));
-      }
-      blitz::TinyMatrix<double,3,3> m;
-      blitz::TinyVector<double,3> lambda;
-      int k = 0;
-      for (int r = 0; r < 3; ++r)
-      {
-        m(r, r) = hessian.data()[i](k++);
-        for (int c = r + 1; c < 3; ++c)
-            m(r, c) = m(c, r) = hessian.data()[i](k++);
-      }
-      atb::eigenvalueDecompositionRealSymmetric(m, m, lambda, atb::Ascending);
-      l1.data()[i] = lambda(0);
-      v1.data()[i] = m(0, 0), m(1, 0), m(2, 0);
-      v1z.data()[i] = std::abs(m(0, 0));
-#ifdef _OPENMP
-#pragma omp critical
-#endif
-      varSum += blitz::pow2(lambda(0));      
-    }
-    if (pr != NULL && pr->isAborted()) return;
-    double stddevInv = 1.0 / std::sqrt(varSum / hessian.size());
+    for (ptrdiff_t i = 0; i < static_cast<ptrdiff_t>(l1.size()); ++i)
+        varSum += blitz::pow2(l1.data()[i]);
+    double stddevInv = 1.0 / std::sqrt(varSum / l1.size());
 
 #ifdef _OPENMP
 #pragma omp parallel for
@@ -585,7 +603,9 @@ namespace iRoCS
     l1 = -l1;
   
     if (pr != NULL && !pr->updateProgressMessage(mVec[pState])) return;
-    morphWatershed(l1, segmentation, 26);
+    if (watershedLevels > 0)
+        morphWatershedTiled(l1, segmentation, 26, watershedLevels);
+    else morphWatershed(l1, segmentation, 26);
     if (pr != NULL && !pr->updateProgress(pVec[pState])) return;
     pState++;
 
@@ -636,7 +656,9 @@ namespace iRoCS
     pState++;
 
     if (pr != NULL && !pr->updateProgressMessage(mVec[pState])) return;
-    morphWatershed(l1, marker, segmentation, 26);
+    if (watershedLevels > 0)
+        morphWatershedTiled(l1, marker, segmentation, 26, watershedLevels);
+    else morphWatershed(l1, marker, segmentation, 26);
     volume(segmentation, volumes);
     if (pr != NULL && !pr->updateProgress(pVec[pState])) return;
     pState++;
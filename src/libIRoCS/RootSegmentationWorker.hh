@@ -45,7 +45,8 @@ namespace iRoCS
       double varSigmaUm, double varEpsilon, float sigmaHessianUm,
       bool preDiffusion, int nDiffusionIterations, float zCompensationFactor,
       double kappa, float deltaT, float l1Threshold, float volumeThresholdUm,
-      int boundaryThicknessPx, std::string const &debugFileName = "",
+      int boundaryThicknessPx, double diffusionMemoryLimitGB,
+      int watershedLevels, std::string const &debugFileName = "",
       iRoCS::ProgressReporter *pr = NULL);
 
 }
@@ -34,6 +34,7 @@
 #include "TrainfileParameters.hh"
 
 #include "iRoCSFeatures.hh"
+#include "DetectorCascade.hh"
 
 namespace iRoCS
 {
@@ -280,6 +281,19 @@ namespace iRoCS
       return;
     }
 
+    // The cascade stage works on the raw Hough features, so that the
+    // detector can evaluate it before sampling and normalizing the SD
+    // features
+    DetectorCascade cascade;
+    if (parameters.cascadeTargetRecall() > 0.0)
+    {
+      std::vector<int> houghIndices;
+      for (int i = nFeatures - 4; i < nFeatures; ++i) houghIndices.push_back(i);
+      cascade.train(
+          trainingSet, houghIndices, parameters.cascadeTargetRecall(), pr);
+      if (pr != NULL && pr->isAborted()) return;
+    }
+
     // Normalize features
     if (pr != NULL && !pr->updateProgressMessage("Normalizing features"))
         return;
@@ -316,6 +330,17 @@ namespace iRoCS
     if (pr != NULL && pr->isAborted()) return;
 
     features.saveNormalizationParameters(parameters.modelFileName());
+    try
+    {
+      cascade.save(parameters.modelFileName());
+    }
+    catch (std::exception &e)
+    {
+      std::cout << "Could not save cascade stage: " << e.what() << std::endl;
+      if (pr != NULL) pr->abortWithError(
+          std::string("Could not save cascade stage: ") + e.what());
+      return;
+    }
 
     // Train svm
     if (pr != NULL)
@@ -29,7 +29,7 @@ TrainingParameters::TrainingParameters()
           _nOutRootSamples(0), _modelFileName("svmModel.h5"),
           _sdNormalization(iRoCS::Features::FeatureZeroMeanStddev),
           _houghNormalization(iRoCS::Features::FeatureZeroMeanStddev),
-          _cost(100.0), _gamma(0.01)
+          _cost(100.0), _gamma(0.01), _cascadeTargetRecall(0.0)
 {}
 
 TrainingParameters::~TrainingParameters()
@@ -141,6 +141,16 @@ double TrainingParameters::gamma() const
   return _gamma;
 }
 
+void TrainingParameters::setCascadeTargetRecall(double recall)
+{
+  _cascadeTargetRecall = recall;
+}
+
+double TrainingParameters::cascadeTargetRecall() const
+{
+  return _cascadeTargetRecall;
+}
+
 std::string TrainingParameters::check()
 {
   // Check input files
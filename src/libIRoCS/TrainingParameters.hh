@@ -74,6 +74,11 @@ public:
   virtual void setGamma(double gamma);
   virtual double gamma() const;
 
+  // Fraction of positive training samples the detector cascade stage must
+  // pass. 0 disables the cascade.
+  virtual void setCascadeTargetRecall(double recall);
+  virtual double cascadeTargetRecall() const;
+
   std::string check();
 
 private:
@@ -85,6 +90,7 @@ private:
   std::string _modelFileName;
   iRoCS::Features::NormalizationType _sdNormalization, _houghNormalization;
   double _cost, _gamma;
+  double _cascadeTargetRecall;
   
 };
 
@@ -29,6 +29,8 @@
 #include <libsvmtl/TwoClassSVMc.hh>
 #include <libsvmtl/Kernel_RBF.hh>
 #include <libsvmtl/Model.hh>
+#include <libsvmtl/BatchedRBFDecision.hh>
+#include <libsvmtl/RandomFourierRBFModel.hh>
 
 namespace iRoCS
 {
@@ -73,7 +75,8 @@ namespace iRoCS
   Features::Features(
       blitz::TinyVector<double,3> const &featureElementSizeUm,
       iRoCS::ProgressReporter *progress)
-          : p_progress(progress)
+          : p_progress(progress), _incrementalSmoothing(false),
+            p_scaleSpace(NULL)
   {
     std::cout << "Initializing iRoCS::Features... " << std::flush;
     _dataScaled.setElementSizeUm(featureElementSizeUm);
@@ -86,13 +89,27 @@ namespace iRoCS
   }
 
   Features::~Features()
-  {}
+  {
+    delete p_scaleSpace;
+  }
 
   blitz::TinyVector<double,3> const &Features::elementSizeUm() const
   {
     return _dataScaled.elementSizeUm();
   }
 
+  bool Features::incrementalSmoothing() const
+  {
+    return _incrementalSmoothing;
+  }
+
+  void Features::setIncrementalSmoothing(bool incremental)
+  {
+    if (incremental == _incrementalSmoothing) return;
+    _incrementalSmoothing = incremental;
+    _sdFeatures.clear();
+  }
+
   void Features::addFeatureToGroup(
       std::string const &groupName, std::string const &featureName)
   {
@@ -332,6 +349,8 @@ namespace iRoCS
           normalize[i] = int(_normalize[i]);
       modelMap.setArray("featureNormalization",
                         normalize.begin(), normalize.size());
+      modelMap.setValue(
+          "incrementalSmoothing", _incrementalSmoothing ? 1 : 0);
       for (size_t i = 0; i < _featureGroups.size(); ++i) 
       {
         std::string groupName = h5GroupName(_featureGroups[i]);
@@ -374,6 +393,11 @@ namespace iRoCS
           "featureNormalization", normalize.begin(), nFeatureGroups);
       for (int i = 0; i < nFeatureGroups; ++i)
           _normalize[i] = static_cast<NormalizationType>(normalize[i]);
+      // Models without this entry were trained on fully convolved data
+      int incremental = 0;
+      if (modelMap.valueExists("incrementalSmoothing"))
+          modelMap.getValue("incrementalSmoothing", incremental);
+      setIncrementalSmoothing(incremental != 0);
       _featureNames.resize(_featureGroups.size());
       _means.resize(_featureGroups.size());
       _stddevs.resize(_featureGroups.size());
@@ -413,6 +437,8 @@ namespace iRoCS
     svt::TwoClassSVMc<svt::Kernel_RBF> svm;
     svm.kernel().setGamma(gamma);
     svm.setCost(cost); 
+    // Use all cores, the trained model does not depend on the thread count
+    svm.setNThreads(0);
     svm.updateKernelCache(
         trainVectors.begin(), trainVectors.end(), svt::DirectAccessor());
     svm.train(trainVectors.begin(), trainVectors.end(), model);
@@ -431,21 +457,61 @@ namespace iRoCS
     std::cout << "Training finished" << std::endl;
   }
 
+  // Evaluates the decision function in chunks to report progress in
+  // between. Returns false if the progress reporter was aborted.
+  template<typename DecisionT>
+  static bool decideInChunks(
+      DecisionT const &decision, std::vector<svt::BasicFV> &testVectors,
+      std::vector<double> &decisionValues, iRoCS::ProgressReporter *pr)
+  {
+    size_t const chunkSize = 65536;
+    for (size_t first = 0; first < testVectors.size(); first += chunkSize)
+    {
+      if (pr != NULL)
+      {
+        if (pr->isAborted()) return false;
+        pr->updateProgress(
+            static_cast<int>(
+                static_cast<double>(pr->taskProgressMin()) +
+                static_cast<double>(first) *
+                static_cast<double>(
+                    pr->taskProgressMax() - pr->taskProgressMin()) /
+                static_cast<double>(testVectors.size())));
+      }
+      size_t last = std::min(first + chunkSize, testVectors.size());
+      decision.decisionValues(
+          testVectors.begin() + first, testVectors.begin() + last,
+          &decisionValues[first]);
+    }
+    return true;
+  }
+
   void Features::classifyTwoClassSVM(
       std::vector<svt::BasicFV> &testVectors,
-      std::string const &modelFileName)
+      std::string const &modelFileName, bool singlePrecision)
   {
     std::cout << "Classifying " << testVectors.size() << " test samples"
               << std::endl;
     svt::Model<svt::BasicFV> model;
     svt::TwoClassSVMc<svt::Kernel_RBF> svm;
+    svt::RandomFourierRBFModel randomFeatureModel;
 
+    // Models compressed with compressDetectorModel carry an approximation
+    // of the decision function under the "approx_" keys, which replaces
+    // the exact model
+    std::string approximationType;
     try
     {
       svt::StDataHdf5 modelMap(modelFileName.c_str());
       modelMap.setExceptionFlag(true);
-      model.loadParameters(modelMap);    
       svm.loadParameters(modelMap);
+      if (modelMap.valueExists("approx_model_type"))
+          modelMap.getValue("approx_model_type", approximationType);
+      if (approximationType == "random_fourier_features")
+          randomFeatureModel.loadParameters(modelMap, "approx_");
+      else if (approximationType != "")
+          model.loadParameters(modelMap, "approx_");
+      else model.loadParameters(modelMap);
     }
     catch (std::exception &e)
     {
@@ -453,41 +519,51 @@ namespace iRoCS
           "Could not load SVM model from '" + modelFileName + "': " + e.what());
       return;
     }
+    if (approximationType != "")
+        std::cout << "Using approximated model (" << approximationType << ")"
+                  << std::endl;
     
-    svm.clearKernelCache();
-    
-    double progressStepPerClassification = 0.0;
+    // The support vectors are packed once, the test vectors are classified
+    // in chunks to report progress in between
+    std::vector<double> decisionValues(testVectors.size());
+
     if (p_progress != NULL)
+        p_progress->updateProgressMessage("Classifying...");
+
+    try
     {
-      progressStepPerClassification =
-          static_cast<double>(
-              p_progress->taskProgressMax() - p_progress->taskProgressMin()) /
-          static_cast<double>(testVectors.size());
-      p_progress->updateProgressMessage("Classifying...");
+      if (approximationType == "random_fourier_features")
+      {
+        if (!decideInChunks(
+                randomFeatureModel, testVectors, decisionValues, p_progress))
+            return;
+      }
+      else if (singlePrecision)
+      {
+        svt::BatchedRBFDecision<float> decision(model, svm.kernel().gamma());
+        if (!decideInChunks(decision, testVectors, decisionValues, p_progress))
+            return;
+      }
+      else
+      {
+        svt::BatchedRBFDecision<double> decision(model, svm.kernel().gamma());
+        if (!decideInChunks(decision, testVectors, decisionValues, p_progress))
+            return;
+      }
+    }
+    catch (svt::SVMError &e)
+    {
+      if (p_progress != NULL) p_progress->abortWithError(
+          "Could not classify with SVM model from '" + modelFileName +
+          "': " + e.what());
+      return;
     }
 
-    int nClassified = 0;
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
     for (ptrdiff_t i = 0; i < static_cast<ptrdiff_t>(testVectors.size()); ++i)
-    {
-      if (p_progress != NULL)
-      {
-        if (p_progress->isAborted()) continue;
-#ifdef _OPENMP
-#pragma omp critical
-#endif
-        {
-          nClassified++;
-          int progress = static_cast<int>(
-              static_cast<double>(p_progress->taskProgressMin()) +
-              static_cast<double>(nClassified) * progressStepPerClassification);
-          p_progress->updateProgress(progress);
-        }
-      }
-      testVectors[i].setLabel(svm.classify(testVectors[i], model));
-    }
+        testVectors[i].setLabel(decisionValues[i]);
     std::cout << "Classification finished" << std::endl;
   }
 
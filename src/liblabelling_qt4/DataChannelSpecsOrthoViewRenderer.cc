@@ -27,6 +27,8 @@
 
 #include <QtGui/QFont>
 
+#include <vector>
+
 #include "DataChannelSpecsOrthoViewRenderer.hh"
 
 #include "MultiChannelModel.hh"
@@ -238,10 +240,16 @@ void DataChannelSpecsOrthoViewRenderer::updateCache(int direction) const
           blitz::TinyVector<double,3> srcPosPx;
           srcPosPx(direction) = zUm;
           srcPosPx(dims(0)) = s0 * y;
+          srcPosPx(dims(1)) = 0.0;
+          blitz::TinyVector<double,3> stepPx(0.0);
+          stepPx(dims(1)) = s1;
+          std::vector<float> values(_cache(direction).extent(1));
+          data->interpolator().getGrid(
+              *data, srcPosPx, blitz::TinyVector<double,3>(0.0), 1, stepPx,
+              values.size(), &values[0]);
           for (atb::BlitzIndexT x = 0; x < _cache(direction).extent(1); ++x)
           {
-            srcPosPx(dims(1)) = s1 * x;
-            float val = data->interpolator().get(*data, srcPosPx);
+            float val = values[x];
             float rawVal = val;
             val = (val - channel->displayMin()) / valueScale;
             if (val < 0.0f) val = 0.0f;
@@ -282,13 +290,19 @@ void DataChannelSpecsOrthoViewRenderer::updateCache(int direction) const
               (scaling(dims(0)) *
                (y * modelElSizeUm(dims(0)) + channelLbUm(dims(0))) +
                translation(dims(0))) / dataElSizeUm(dims(0));
+          srcPosPx(dims(1)) =
+              (scaling(dims(1)) * channelLbUm(dims(1)) +
+               translation(dims(1))) / dataElSizeUm(dims(1));
+          blitz::TinyVector<double,3> stepPx(0.0);
+          stepPx(dims(1)) = scaling(dims(1)) * modelElSizeUm(dims(1)) /
+              dataElSizeUm(dims(1));
+          std::vector<float> values(_cache(direction).extent(1));
+          data->interpolator().getGrid(
+              *data, srcPosPx, blitz::TinyVector<double,3>(0.0), 1, stepPx,
+              values.size(), &values[0]);
           for (atb::BlitzIndexT x = 0; x < _cache(direction).extent(1); ++x)
           {
-            srcPosPx(dims(1)) =
-                (scaling(dims(1)) *
-                 (x * modelElSizeUm(dims(1)) + channelLbUm(dims(1))) +
-                 translation(dims(1))) / dataElSizeUm(dims(1));
-            float val = data->interpolator().get(*data, srcPosPx);
+            float val = values[x];
             float rawVal = val;
             val = (val - channel->displayMin()) / valueScale;
             if (val < 0.0f) val = 0.0f;
@@ -319,29 +333,36 @@ void DataChannelSpecsOrthoViewRenderer::updateCache(int direction) const
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
-      for (ptrdiff_t i = 0;
-           i < static_cast<ptrdiff_t>(_cache(direction).size()); ++i)
+      for (atb::BlitzIndexT y = 0; y < _cache(direction).extent(0); ++y)
       {
-        blitz::TinyVector<atb::BlitzIndexT,2> pos(
-            i / _cache(direction).extent(1), i % _cache(direction).extent(1));
-        blitz::TinyVector<double,3> posUm;
-        posUm(dims(0)) = pos(0) * modelElSizeUm(dims(0)) + channelLbUm(dims(0));
-        posUm(dims(1)) = pos(1) * modelElSizeUm(dims(1)) + channelLbUm(dims(1));
-        posUm(direction) = zUm;
-        float val = data->valueAt(posUm);
-        float outVal = val;
-        outVal = (outVal - channel->displayMin()) / valueScale;
-        if (outVal < 0.0f) outVal = 0.0f;
-        if (outVal > 1.0f) outVal = 1.0f;
-        if (channel->gamma() != 1.0)
-            outVal = channel->gammaLUT(static_cast<int>(outVal * 65535.0f));
-        _cache(direction).data()[i] = channelColor * outVal;
-        if (channel->showExposureProblems())
+        // Sample the whole row with one interpolator call
+        std::vector< blitz::TinyVector<double,3> > posUm(
+            _cache(direction).extent(1));
+        for (atb::BlitzIndexT x = 0; x < _cache(direction).extent(1); ++x)
+        {
+          posUm[x](dims(0)) = y * modelElSizeUm(dims(0)) + channelLbUm(dims(0));
+          posUm[x](dims(1)) = x * modelElSizeUm(dims(1)) + channelLbUm(dims(1));
+          posUm[x](direction) = zUm;
+        }
+        std::vector<float> values(_cache(direction).extent(1));
+        data->valuesAt(&posUm[0], posUm.size(), &values[0]);
+        for (atb::BlitzIndexT x = 0; x < _cache(direction).extent(1); ++x)
         {
-          if (val <= channel->displayMin())
-              _cache(direction).data()[i] = underFlowColor;
-          if (val >= channel->displayMax())
-              _cache(direction).data()[i] = overFlowColor;          
+          float val = values[x];
+          float outVal = val;
+          outVal = (outVal - channel->displayMin()) / valueScale;
+          if (outVal < 0.0f) outVal = 0.0f;
+          if (outVal > 1.0f) outVal = 1.0f;
+          if (channel->gamma() != 1.0)
+              outVal = channel->gammaLUT(static_cast<int>(outVal * 65535.0f));
+          _cache(direction)(y, x) = channelColor * outVal;
+          if (channel->showExposureProblems())
+          {
+            if (val <= channel->displayMin())
+                _cache(direction)(y, x) = underFlowColor;
+            if (val >= channel->displayMax())
+                _cache(direction)(y, x) = overFlowColor;
+          }
         }
       }
     }
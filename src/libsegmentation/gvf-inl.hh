@@ -38,9 +38,285 @@
 namespace segmentation
 {
 
+  template<typename T>
+  GVFMultigridSolver<T>::GVFMultigridSolver(
+      blitz::Array<T,3> const &c, blitz::TinyVector<T,3> const &w, T mu)
+          : _mu(mu)
+  {
+    _c.push_back(blitz::Array<T,3>(c.shape()));
+    _c.back() = c;
+    _w.push_back(w);
+    _u.push_back(blitz::Array<T,3>());
+    _rhs.push_back(blitz::Array<T,3>());
+    _residual.push_back(blitz::Array<T,3>(c.shape()));
+
+    while (true)
+    {
+      blitz::TinyVector<atb::BlitzIndexT,3> shape(_c.back().shape());
+      blitz::TinyVector<atb::BlitzIndexT,3> coarseShape(shape);
+      blitz::TinyVector<T,3> coarseW(_w.back());
+      blitz::TinyVector<bool,3> coarsened(false);
+      bool anyCoarsened = false;
+      for (int d = 0; d < 3; ++d)
+      {
+        if (shape(d) < 5) continue;
+        // Coarse sample i coincides with fine sample 2i. For even extents
+        // the last coarse sample is a boundary sample one fine sample
+        // inside the fine boundary, the fine samples next to the fine
+        // boundary are then only corrected by the smoother.
+        coarsened(d) = true;
+        coarseShape(d) = (shape(d) + 1) / 2;
+        coarseW(d) /= 4;
+        anyCoarsened = true;
+      }
+      if (!anyCoarsened) break;
+
+      size_t level = _c.size() - 1;
+      _coarsened.push_back(coarsened);
+      _c.push_back(blitz::Array<T,3>(coarseShape));
+      _c.back() = T(0);
+      _restrict(level, _c[level], _c.back());
+      _w.push_back(coarseW);
+      _u.push_back(blitz::Array<T,3>(coarseShape));
+      _rhs.push_back(blitz::Array<T,3>(coarseShape));
+      _rhs.back() = T(0);
+      _residual.push_back(blitz::Array<T,3>(coarseShape));
+    }
+  }
+
+  template<typename T>
+  void GVFMultigridSolver<T>::vCycle(
+      blitz::Array<T,3> &u, blitz::Array<T,3> const &rhs)
+  {
+    _vCycle(0, u, rhs);
+  }
+
+  template<typename T>
+  double GVFMultigridSolver<T>::squaredResidualNorm(
+      blitz::Array<T,3> const &u, blitz::Array<T,3> const &rhs)
+  {
+    return _computeResidual(0, u, rhs);
+  }
+
+  template<typename T>
+  void GVFMultigridSolver<T>::_vCycle(
+      size_t level, blitz::Array<T,3> &u, blitz::Array<T,3> const &rhs)
+  {
+    if (level + 1 == _c.size())
+    {
+      // The coarsest grid has at most four samples per dimension that were
+      // coarsened, relaxation converges quickly there
+      _smooth(level, u, rhs, 32);
+      return;
+    }
+
+    _smooth(level, u, rhs, 2);
+    _computeResidual(level, u, rhs);
+    _restrict(level, _residual[level], _rhs[level + 1]);
+    _u[level + 1] = T(0);
+    _vCycle(level + 1, _u[level + 1], _rhs[level + 1]);
+    _prolongateAdd(level, _u[level + 1], u);
+    _smooth(level, u, rhs, 2);
+  }
+
+  template<typename T>
+  void GVFMultigridSolver<T>::_smooth(
+      size_t level, blitz::Array<T,3> &u, blitz::Array<T,3> const &rhs,
+      int nSweeps)
+  {
+    blitz::Array<T,3> const &c = _c[level];
+    blitz::TinyVector<T,3> const &w = _w[level];
+    T diag = 2 * _mu * (w(0) + w(1) + w(2));
+    blitz::TinyVector<atb::BlitzIndexT,3> shape(u.shape());
+    blitz::TinyVector<ptrdiff_t,3> s(u.stride());
+    ptrdiff_t cs = c.stride(2), rs = rhs.stride(2);
+
+    for (int sweep = 0; sweep < nSweeps; ++sweep)
+    {
+      // Voxels of one color only have neighbours of the other color, so
+      // all voxels of a color can be updated concurrently
+      for (int color = 0; color < 2; ++color)
+      {
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (atb::BlitzIndexT lev = 1; lev < shape(0) - 1; ++lev)
+        {
+          for (atb::BlitzIndexT row = 1; row < shape(1) - 1; ++row)
+          {
+            T *pu = &u(lev, row, 0);
+            T const *pc = &c(lev, row, 0);
+            T const *pr = &rhs(lev, row, 0);
+            for (atb::BlitzIndexT col = 1 + ((lev + row + 1 + color) & 1);
+                 col < shape(2) - 1; col += 2)
+            {
+              T *x = pu + col * s(2);
+              T nb = w(0) * (x[-s(0)] + x[s(0)]) +
+                  w(1) * (x[-s(1)] + x[s(1)]) +
+                  w(2) * (x[-s(2)] + x[s(2)]);
+              *x = (pr[col * rs] + _mu * nb) / (pc[col * cs] + diag);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  template<typename T>
+  double GVFMultigridSolver<T>::_computeResidual(
+      size_t level, blitz::Array<T,3> const &u, blitz::Array<T,3> const &rhs)
+  {
+    blitz::Array<T,3> const &c = _c[level];
+    blitz::Array<T,3> &r = _residual[level];
+    blitz::TinyVector<T,3> const &w = _w[level];
+    T diag = 2 * _mu * (w(0) + w(1) + w(2));
+    blitz::TinyVector<atb::BlitzIndexT,3> shape(u.shape());
+    blitz::TinyVector<ptrdiff_t,3> s(u.stride());
+    ptrdiff_t cs = c.stride(2), rs = rhs.stride(2), os = r.stride(2);
+
+    r = T(0);
+    double sqrNorm = 0.0;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:sqrNorm)
+#endif
+    for (atb::BlitzIndexT lev = 1; lev < shape(0) - 1; ++lev)
+    {
+      for (atb::BlitzIndexT row = 1; row < shape(1) - 1; ++row)
+      {
+        T const *pu = &u(lev, row, 0);
+        T const *pc = &c(lev, row, 0);
+        T const *pr = &rhs(lev, row, 0);
+        T *po = &r(lev, row, 0);
+        for (atb::BlitzIndexT col = 1; col < shape(2) - 1; ++col)
+        {
+          T const *x = pu + col * s(2);
+          T nb = w(0) * (x[-s(0)] + x[s(0)]) +
+              w(1) * (x[-s(1)] + x[s(1)]) +
+              w(2) * (x[-s(2)] + x[s(2)]);
+          T res = pr[col * rs] - (pc[col * cs] + diag) * *x + _mu * nb;
+          po[col * os] = res;
+          sqrNorm += static_cast<double>(res) * static_cast<double>(res);
+        }
+      }
+    }
+    return sqrNorm;
+  }
+
+  template<typename T>
+  void GVFMultigridSolver<T>::_restrict(
+      size_t level, blitz::Array<T,3> const &fine,
+      blitz::Array<T,3> &coarse) const
+  {
+    blitz::TinyVector<bool,3> const &coarsened = _coarsened[level];
+    blitz::TinyVector<atb::BlitzIndexT,3> shape(coarse.shape());
+
+    // Full weighting along coarsened dimensions
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (atb::BlitzIndexT lev = 1; lev < shape(0) - 1; ++lev)
+    {
+      blitz::TinyVector<atb::BlitzIndexT,3> pos;
+      atb::BlitzIndexT idx[3][3];
+      T wt[3][3];
+      int n[3];
+      pos(0) = lev;
+      for (pos(1) = 1; pos(1) < shape(1) - 1; ++pos(1))
+      {
+        for (pos(2) = 1; pos(2) < shape(2) - 1; ++pos(2))
+        {
+          for (int d = 0; d < 3; ++d)
+          {
+            if (coarsened(d))
+            {
+              n[d] = 3;
+              idx[d][0] = 2 * pos(d) - 1;
+              idx[d][1] = 2 * pos(d);
+              idx[d][2] = 2 * pos(d) + 1;
+              wt[d][0] = T(0.25);
+              wt[d][1] = T(0.5);
+              wt[d][2] = T(0.25);
+            }
+            else
+            {
+              n[d] = 1;
+              idx[d][0] = pos(d);
+              wt[d][0] = T(1);
+            }
+          }
+          T sum = T(0);
+          for (int i0 = 0; i0 < n[0]; ++i0)
+              for (int i1 = 0; i1 < n[1]; ++i1)
+                  for (int i2 = 0; i2 < n[2]; ++i2)
+                      sum += wt[0][i0] * wt[1][i1] * wt[2][i2] *
+                          fine(idx[0][i0], idx[1][i1], idx[2][i2]);
+          coarse(pos) = sum;
+        }
+      }
+    }
+  }
+
+  template<typename T>
+  void GVFMultigridSolver<T>::_prolongateAdd(
+      size_t level, blitz::Array<T,3> const &coarse,
+      blitz::Array<T,3> &fine) const
+  {
+    blitz::TinyVector<bool,3> const &coarsened = _coarsened[level];
+    blitz::TinyVector<atb::BlitzIndexT,3> shape(fine.shape());
+
+    // Trilinear interpolation along coarsened dimensions
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (atb::BlitzIndexT lev = 1; lev < shape(0) - 1; ++lev)
+    {
+      blitz::TinyVector<atb::BlitzIndexT,3> pos;
+      atb::BlitzIndexT idx[3][2];
+      T wt[3][2];
+      int n[3];
+      pos(0) = lev;
+      for (pos(1) = 1; pos(1) < shape(1) - 1; ++pos(1))
+      {
+        for (pos(2) = 1; pos(2) < shape(2) - 1; ++pos(2))
+        {
+          for (int d = 0; d < 3; ++d)
+          {
+            if (!coarsened(d))
+            {
+              n[d] = 1;
+              idx[d][0] = pos(d);
+              wt[d][0] = T(1);
+            }
+            else if (pos(d) % 2 == 0)
+            {
+              n[d] = 1;
+              idx[d][0] = pos(d) / 2;
+              wt[d][0] = T(1);
+            }
+            else
+            {
+              n[d] = 2;
+              idx[d][0] = (pos(d) - 1) / 2;
+              idx[d][1] = (pos(d) + 1) / 2;
+              wt[d][0] = T(0.5);
+              wt[d][1] = T(0.5);
+            }
+          }
+          T sum = T(0);
+          for (int i0 = 0; i0 < n[0]; ++i0)
+              for (int i1 = 0; i1 < n[1]; ++i1)
+                  for (int i2 = 0; i2 < n[2]; ++i2)
+                      sum += wt[0][i0] * wt[1][i1] * wt[2][i2] *
+                          coarse(idx[0][i0], idx[1][i1], idx[2][i2]);
+          fine(pos) += sum;
+        }
+      }
+    }
+  }
+
 /**
  * Solve Euler-Lagrange equation for gradient vector flow using
- * successive over-relaxation
+ * red-black successive over-relaxation
  * \f[
  * 0 = \mu \Delta u_i - \|\nabla f\|^2 ( u_i - \frac{\partial f}{\partial i} )
  * \f]
@@ -59,22 +335,31 @@ namespace segmentation
 
     T max_norm_sq = T(0);
 #ifdef _OPENMP
-#pragma omp parallel for
+#pragma omp parallel
+#endif
+    {
+      // Thread-local maximum, merged once per thread
+      T local_max_norm_sq = T(0);
+#ifdef _OPENMP
+#pragma omp for
 #endif
 #if defined _OPENMP && defined _WIN32
-    for (ptrdiff_t i = 0; i < static_cast<ptrdiff_t>(gradient.size()); ++i) {
+      for (ptrdiff_t i = 0; i < static_cast<ptrdiff_t>(gradient.size());
+           ++i) {
 #else
-    for (size_t i = 0; i < gradient.size(); ++i) {
+      for (size_t i = 0; i < gradient.size(); ++i) {
 #endif
-      gradient_norm_sq.data()[i] =
-          gradient.data()[i](0) * gradient.data()[i](0)
-          + gradient.data()[i](1) * gradient.data()[i](1)
-          + gradient.data()[i](2) * gradient.data()[i](2);
+        gradient_norm_sq.data()[i] =
+            gradient.data()[i](0) * gradient.data()[i](0)
+            + gradient.data()[i](1) * gradient.data()[i](1)
+            + gradient.data()[i](2) * gradient.data()[i](2);
+        if (gradient_norm_sq.data()[i] > local_max_norm_sq)
+            local_max_norm_sq = gradient_norm_sq.data()[i];
+      }
 #ifdef _OPENMP
 #pragma omp critical
 #endif
-      if (gradient_norm_sq.data()[i] > max_norm_sq)
-          max_norm_sq = gradient_norm_sq.data()[i];
+      if (local_max_norm_sq > max_norm_sq) max_norm_sq = local_max_norm_sq;
     }
 
 #ifdef _OPENMP
@@ -110,39 +395,106 @@ namespace segmentation
               static_cast<double>(iter) / static_cast<double>(max_iter) *
               progress->taskProgressMax() - progress->taskProgressMin()) +
           progress->taskProgressMin()) break;
+      // Red-black ordering: voxels of one color only have neighbours of
+      // the other color and can be updated concurrently without locks
+      for (int color = 0; color < 2; ++color)
+      {
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
-      for (int lev = 1; lev < shape(0) - 1; ++lev)
-      {
-        for (int row = 1; row < shape(1) - 1; ++row)
+        for (int lev = 1; lev < shape(0) - 1; ++lev)
         {
-          for (int col = 1; col < shape(2) - 1; ++col)
+          for (int row = 1; row < shape(1) - 1; ++row)
           {
-            // own coefficients
-            // laplacian - squared gradient magnitude
-            T a_ii = -6 - gradient_norm_sq(lev, row, col)/mu;
-            // const part
-            const blitz::TinyVector<T, 3>& b =  -b_arr(lev, row, col)/mu;
-
-            // other coefficients * x
-            // this is just the finite-difference laplacian
-            blitz::TinyVector<T, 3> a_ij_x =
-                (x(lev - 1, row, col) +
-                 x(lev + 1, row, col)) * normalizer(0) +
-                (x(lev, row - 1, col) +
-                 x(lev, row + 1, col)) * normalizer(1) +
-                (x(lev, row, col - 1) +
-                 x(lev, row, col + 1)) * normalizer(2);
-            // SOR iteration
-            x(lev, row, col) = (1. - nu) * x(lev, row, col) +
-                nu/a_ii * (b - a_ij_x);
+            for (int col = 1 + ((lev + row + 1 + color) & 1);
+                 col < shape(2) - 1; col += 2)
+            {
+              // own coefficients
+              // laplacian - squared gradient magnitude
+              T a_ii = -6 - gradient_norm_sq(lev, row, col)/mu;
+              // const part
+              const blitz::TinyVector<T, 3>& b =  -b_arr(lev, row, col)/mu;
+
+              // other coefficients * x
+              // this is just the finite-difference laplacian
+              blitz::TinyVector<T, 3> a_ij_x =
+                  (x(lev - 1, row, col) +
+                   x(lev + 1, row, col)) * normalizer(0) +
+                  (x(lev, row - 1, col) +
+                   x(lev, row + 1, col)) * normalizer(1) +
+                  (x(lev, row, col - 1) +
+                   x(lev, row, col + 1)) * normalizer(2);
+              // SOR iteration
+              x(lev, row, col) = (1. - nu) * x(lev, row, col) +
+                  nu/a_ii * (b - a_ij_x);
+            }
           }
         }
       }
     } // for maxiter
   }
 
+  template<typename T>
+  void gradientVectorFlowMultigrid(
+      blitz::Array<blitz::TinyVector<T, 3>, 3> &gradient,
+      blitz::TinyVector<T,3> const &el_size_um, T mu, int max_cycles,
+      T tolerance, iRoCS::ProgressReporter *progress)
+  {
+    blitz::TinyVector<atb::BlitzIndexT,3> shape(gradient.shape());
+    // normalize gradient and gradient magnitude
+    blitz::Array<T,3> gradient_norm_sq(shape);
+    gradient_norm_sq =
+        blitz::pow2(gradient[0]) + blitz::pow2(gradient[1]) +
+        blitz::pow2(gradient[2]);
+    T max_norm_sq = blitz::max(gradient_norm_sq);
+    if (max_norm_sq == T(0)) return;
+    gradient_norm_sq /= max_norm_sq;
+
+    // The laplacian is given in units of the smallest element size, for
+    // isotropic data this is the discretization of gradientVectorFlowSOR()
+    T min_el_size = blitz::min(el_size_um);
+    blitz::TinyVector<T,3> w;
+    for (int d = 0; d < 3; ++d)
+        w(d) = (min_el_size / el_size_um(d)) * (min_el_size / el_size_um(d));
+    GVFMultigridSolver<T> solver(gradient_norm_sq, w, mu);
+
+    blitz::Array<T,3> u[3], rhs[3];
+    double rhsSqrNorm = 0.0;
+    for (int d = 0; d < 3; ++d)
+    {
+      u[d].resize(shape);
+      u[d] = gradient[d] / std::sqrt(max_norm_sq);
+      rhs[d].resize(shape);
+      rhs[d] = gradient_norm_sq * u[d];
+      rhsSqrNorm += blitz::sum(blitz::pow2(rhs[d]));
+    }
+
+    int cycle = 0;
+    double relativeResidual = 0.0;
+    while (cycle < max_cycles)
+    {
+      if (progress != NULL && !progress->updateProgress(
+              static_cast<double>(cycle) / static_cast<double>(max_cycles) *
+              (progress->taskProgressMax() - progress->taskProgressMin()) +
+              progress->taskProgressMin())) return;
+      ++cycle;
+      double residualSqrNorm = 0.0;
+      for (int d = 0; d < 3; ++d)
+      {
+        solver.vCycle(u[d], rhs[d]);
+        residualSqrNorm += solver.squaredResidualNorm(u[d], rhs[d]);
+      }
+      relativeResidual = (rhsSqrNorm > 0.0) ?
+          std::sqrt(residualSqrNorm / rhsSqrNorm) : 0.0;
+      if (relativeResidual < tolerance) break;
+    }
+    std::cout << "GVF - multigrid stopped after " << cycle
+              << " V-cycles with relative residual " << relativeResidual
+              << std::endl;
+
+    for (int d = 0; d < 3; ++d) gradient[d] = u[d];
+  }
+
   template<typename T>
   void msGradientVectorFlow(
       blitz::Array<blitz::TinyVector<T, 3>, 3> &gradient,
@@ -202,7 +554,6 @@ namespace segmentation
     c2 = b * dy2;
     blitz::Array<T,3> c3(ShapeL);
     c3 = b * dz2;
-    b = static_cast<T>(1) - b;
     blitz::Array<blitz::TinyVector<T,3>,3> ms_f(ShapeL);
     ms_f[0]=0;
     ms_f[1]=0;
@@ -212,6 +563,12 @@ namespace segmentation
     scaling *= scaling;
     T invscaling = static_cast<T>(1.0) / scaling;
 
+    // The diffusion step solves b u - mu L u = c with one V-cycle per
+    // iteration instead of one explicit time step
+    GVFMultigridSolver<T> solver(
+        b, blitz::TinyVector<T,3>(scaling, T(1), T(1)), mu);
+    b.free();
+
     std::cout << "MSGVF - Running" << std::endl;
 
     int count;
@@ -230,6 +587,9 @@ namespace segmentation
       //    /******** V: Update GVF ************/
       //    u = (1-b) * u + mu * Lu + c1;
       //    v = (1-b) * v + mu * Lv + c2;
+      //
+      // The update is now the implicit steady state equation
+      // b * u - mu * Lu = c1, improved by one V-cycle per iteration
 
 #ifdef _OPENMP
 #pragma omp parallel for
@@ -301,81 +661,15 @@ namespace segmentation
       if (progress != NULL && progress->isAborted()) return;
 
       dx2 = ms_f[0];
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-      for(atb::BlitzIndexT lev = 1; lev < ShapeL(0) - 1; ++lev)
-      {
-        if (progress != NULL && progress->isAborted()) continue;
-        for(atb::BlitzIndexT row = 1; row < ShapeL(1) - 1; ++row)
-        {
-          for(atb::BlitzIndexT col = 1; col < ShapeL(2) - 1; ++col)
-          {
-            dx2(lev, row, col) =
-                ((b(lev, row, col)) * dx2(lev, row, col) +
-                 mu * ((dx2(lev - 1, row, col) +
-                        dx2(lev + 1, row, col) -
-                        2 * dx2(lev, row, col)) * scaling +
-                       dx2(lev, row - 1, col) +
-                       dx2(lev, row + 1, col) +
-                       dx2(lev, row, col - 1) +
-                       dx2(lev, row, col + 1) -
-                       4 * dx2(lev, row, col)) + c1(lev, row, col));
-          }
-        }
-      }
+      solver.vCycle(dx2, c1);
       if (progress != NULL && progress->isAborted()) return;
 
       dy2 = ms_f[1];
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-      for(atb::BlitzIndexT lev = 1; lev < ShapeL(0) - 1; ++lev)
-      {
-        if (progress != NULL && progress->isAborted()) continue;
-        for(atb::BlitzIndexT row = 1; row < ShapeL(1) - 1; ++row)
-        {
-          for(atb::BlitzIndexT col = 1; col < ShapeL(2) - 1; ++col)
-          {
-            dy2(lev, row, col) =
-                ((b(lev, row, col)) * dy2(lev, row, col) +
-                 mu * ((dy2(lev - 1, row, col) +
-                        dy2(lev + 1, row, col) -
-                        2 * dy2(lev, row, col)) * scaling +
-                       dy2(lev, row - 1, col) +
-                       dy2(lev, row + 1, col) +
-                       dy2(lev, row, col - 1) +
-                       dy2(lev, row, col + 1) -
-                       4 * dy2(lev, row, col)) + c2(lev, row, col));
-          }
-        }
-      }
+      solver.vCycle(dy2, c2);
       if (progress != NULL && progress->isAborted()) return;
 
       dz2 = ms_f[2];
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-      for(atb::BlitzIndexT lev = 1; lev < ShapeL(0) - 1; ++lev)
-      {
-        if (progress != NULL && progress->isAborted()) continue;
-        for(atb::BlitzIndexT row = 1; row < ShapeL(1) - 1; ++row)
-        {
-          for(atb::BlitzIndexT col = 1; col < ShapeL(2) - 1; ++col)
-          {
-            dz2(lev, row, col) =
-                ((b(lev, row, col)) * dz2(lev, row, col) +
-                 mu * ((dz2(lev - 1, row, col) +
-                        dz2(lev + 1, row, col) -
-                        2 * dz2(lev, row, col)) * scaling +
-                       dz2(lev, row - 1, col) +
-                       dz2(lev, row + 1, col) +
-                       dz2(lev, row, col - 1) +
-                       dz2(lev, row, col + 1) -
-                       4 * dz2(lev, row, col)) + c3(lev, row, col));
-          }
-        }
-      }
+      solver.vCycle(dz2, c3);
     }
     if (progress != NULL && progress->isAborted()) return;
 
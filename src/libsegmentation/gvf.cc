@@ -27,6 +27,9 @@
 namespace segmentation
 {
 
+  template class GVFMultigridSolver<float>;
+  template class GVFMultigridSolver<double>;
+
   template
   void gradientVectorFlowSOR(
       blitz::Array<blitz::TinyVector<float, 3>, 3> &gradient,
@@ -39,6 +42,18 @@ namespace segmentation
       blitz::TinyVector<double,3> const &el_size_um, double mu, double nu,
       int max_iter, iRoCS::ProgressReporter *progress);
 
+  template
+  void gradientVectorFlowMultigrid(
+      blitz::Array<blitz::TinyVector<float, 3>, 3> &gradient,
+      blitz::TinyVector<float,3> const &el_size_um, float mu, int max_cycles,
+      float tolerance, iRoCS::ProgressReporter *progress);
+
+  template
+  void gradientVectorFlowMultigrid(
+      blitz::Array<blitz::TinyVector<double, 3>, 3> &gradient,
+      blitz::TinyVector<double,3> const &el_size_um, double mu,
+      int max_cycles, double tolerance, iRoCS::ProgressReporter *progress);
+
   template
   void msGradientVectorFlow(
       blitz::Array<blitz::TinyVector<float, 3>, 3> &gradient,
@@ -27,6 +27,7 @@
 #include <config.hh>
 #endif
 
+#include <vector>
 #include <blitz/array.h>
 
 #include <libProgressReporter/ProgressReporter.hh>
@@ -34,9 +35,80 @@
 namespace segmentation
 {
 
+/**
+ * Geometric multigrid solver for the scalar linear equations
+ * \f[
+ * c u - \mu \sum_d w_d \partial_d^2 u = r
+ * \f]
+ * arising in gradient vector flow computations. The equation is
+ * discretized with finite differences on the interior of the Array, the
+ * boundary voxels of u are kept fixed (Dirichlet boundary).
+ *
+ * Each V-cycle smoothes with red-black Gauss-Seidel sweeps, restricts the
+ * residual with full weighting and prolongates the coarse grid correction
+ * trilinearly. Dimensions with less than five samples are not coarsened
+ * any further.
+ * */
+  template<typename T>
+  class GVFMultigridSolver
+  {
+
+  public:
+
+    /**
+     * Build the grid hierarchy.
+     * @param c: voxel-wise coefficient c (non-negative)
+     * @param w: per dimension weights of the second derivatives
+     * @param mu: regularization weight
+     * */
+    GVFMultigridSolver(
+        blitz::Array<T,3> const &c, blitz::TinyVector<T,3> const &w, T mu);
+
+    /**
+     * Improve the solution u of the equation with right hand side rhs by
+     * one V-cycle.
+     * */
+    void vCycle(blitz::Array<T,3> &u, blitz::Array<T,3> const &rhs);
+
+    /**
+     * Compute the squared L2 norm of the residual on the interior.
+     * */
+    double squaredResidualNorm(
+        blitz::Array<T,3> const &u, blitz::Array<T,3> const &rhs);
+
+  private:
+
+    void _vCycle(
+        size_t level, blitz::Array<T,3> &u, blitz::Array<T,3> const &rhs);
+
+    void _smooth(
+        size_t level, blitz::Array<T,3> &u, blitz::Array<T,3> const &rhs,
+        int nSweeps);
+
+    void _restrict(
+        size_t level, blitz::Array<T,3> const &fine,
+        blitz::Array<T,3> &coarse) const;
+
+    void _prolongateAdd(
+        size_t level, blitz::Array<T,3> const &coarse,
+        blitz::Array<T,3> &fine) const;
+
+    // Computes the residual of the given level into _residual[level] and
+    // returns its squared L2 norm
+    double _computeResidual(
+        size_t level, blitz::Array<T,3> const &u,
+        blitz::Array<T,3> const &rhs);
+
+    std::vector< blitz::Array<T,3> > _c, _u, _rhs, _residual;
+    std::vector< blitz::TinyVector<T,3> > _w;
+    std::vector< blitz::TinyVector<bool,3> > _coarsened;
+    T _mu;
+
+  };
+
 /**
  * Solve Euler-Lagrange equation for gradient vector flow using
- * successive over-relaxation
+ * red-black successive over-relaxation
  * \f[
  * 0 = \mu \Delta u_i - \|\nabla f\|^2 ( u_i - \frac{\partial f}{\partial i} )
  * \f]
@@ -49,6 +121,25 @@ namespace segmentation
       blitz::TinyVector<T,3> const &el_size_um, T mu, T nu, int max_iter,
       iRoCS::ProgressReporter *progress = NULL);
 
+/**
+ * Solve the same equation as gradientVectorFlowSOR() with multigrid
+ * V-cycles. Iteration stops after max_cycles V-cycles or when the L2 norm
+ * of the residual relative to the norm of the right hand side drops
+ * below tolerance. Unlike gradientVectorFlowSOR() the laplacian respects
+ * the element size, second derivatives are given in units of the smallest
+ * element size. For isotropic data both solve the same discrete equation.
+ * */
+  template<typename T>
+  void gradientVectorFlowMultigrid(
+      blitz::Array<blitz::TinyVector<T, 3>, 3> &gradient,
+      blitz::TinyVector<T,3> const &el_size_um, T mu, int max_cycles,
+      T tolerance, iRoCS::ProgressReporter *progress = NULL);
+
+/**
+ * Mean shift gradient vector flow. Every iteration mean shift filters the
+ * vector field and then performs one multigrid V-cycle of the gradient
+ * vector flow diffusion on the filtered field.
+ * */
   template<typename T>
   void msGradientVectorFlow(
       blitz::Array<blitz::TinyVector<T, 3>, 3> &gradient,
@@ -245,6 +245,26 @@ namespace svt
     /*======================================================================*/
     virtual int doFullCV( const std::vector<int>& subsetIndexByUID,
                           std::vector<double>& predictedClassLabelByUID) = 0;
+
+
+    /*======================================================================*/
+    /*! 
+     *   cross validation on the subsets firstSubset...endSubset-1
+     *   only, see CrossValidator::doCVOnSubsets()
+     */
+    /*======================================================================*/
+    virtual int doCVOnSubsets( 
+        int firstSubset, int endSubset,
+        const std::vector<int>& subsetIndexByUID,
+        std::vector<double>& predictedClassLabelByUID) = 0;
+
+    /*======================================================================*/
+    /*! 
+     *   set the number of threads for the cross validation, see
+     *   CrossValidator::setNThreads()
+     */
+    /*======================================================================*/
+    virtual void setNThreads( int n) = 0;
     
 
     
@@ -136,6 +136,21 @@ namespace svt
           {
             return _cv.doFullCV( subsetIndexByUID, predictedClassLabelByUID);
           }
+
+    virtual int doCVOnSubsets( 
+        int firstSubset, int endSubset,
+        const std::vector<int>& subsetIndexByUID,
+        std::vector<double>& predictedClassLabelByUID)
+          {
+            return _cv.doCVOnSubsets( firstSubset, endSubset,
+                                      subsetIndexByUID,
+                                      predictedClassLabelByUID);
+          }
+
+    virtual void setNThreads( int n)
+          {
+            _cv.setNThreads( n);
+          }
     
     virtual void setClassificationDelta( double d)
           {
@@ -100,6 +100,7 @@
 #include <config.hh>
 #endif
 
+#include <algorithm>
 #include <list>
 #include <string>
 #include <vector>
@@ -282,11 +283,9 @@ namespace svt
 #ifdef _OPENMP
             omp_set_lock(&_pSquareMutexLock);
 #endif
-            for (iterator p=begin(); p!=end(); )
-            {
-              *p=0.;
-              ++p;
-            }
+            // pFeatures is accessed directly, begin() and end() would try
+            // to acquire the lock again
+            std::fill(pFeatures.begin(), pFeatures.end(), 0.);
             pSquareValid=false;
 #ifdef _OPENMP
             omp_unset_lock(&_pSquareMutexLock);
@@ -413,7 +412,7 @@ namespace svt
             omp_set_lock(&_pSquareMutexLock);
 #endif
             size_t n = size();
-            BasicFV::iterator resultP = begin();
+            BasicFV::iterator resultP = pFeatures.begin();
             BasicFV::const_iterator fvP = fv.begin();
             for( size_t i = 0; i < n; ++i)
             {
@@ -433,7 +432,7 @@ namespace svt
             omp_set_lock(&_pSquareMutexLock);
 #endif
             size_t n = size();
-            BasicFV::iterator resultP = begin();
+            BasicFV::iterator resultP = pFeatures.begin();
             for( size_t i = 0; i < n; ++i)
             {
               *resultP *= factor;
@@ -0,0 +1,231 @@
+/**************************************************************************
+ *
+ * Copyright (C) 2015 Thorsten Falk
+ *
+ *        Image Analysis Lab, University of Freiburg, Germany
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ *
+ **************************************************************************/
+
+/**************************************************************************
+**       Title: batched evaluation of RBF decision functions
+**    $RCSfile$
+**   $Revision$$Name$
+**       $Date$
+**   Copyright: GPL $Author$
+** Description:
+**
+**    Evaluates the decision function of a two class RBF-SVM for many
+**    test vectors at once using blocked matrix products
+**
+**************************************************************************/
+
+#ifndef BATCHEDRBFDECISION_HH
+#define BATCHEDRBFDECISION_HH
+
+#ifdef HAVE_CONFIG_H
+#include <config.hh>
+#endif
+
+// std includes
+#include <cstddef>
+#include <vector>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <stdint.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// libsvmtl includes
+#include "Model.hh"
+#include "SVMError.hh"
+
+namespace svt
+{
+  /*======================================================================*/
+  /*!
+   *  \class BatchedRBFDecision BatchedRBFDecision.hh
+   *  \brief The BatchedRBFDecision class evaluates the decision function
+   *         of a two class SVM with Kernel_RBF for blocks of test vectors.
+   *
+   *  SVMBase::classify() evaluates exp(-gamma*|x-y|^2) one support
+   *  vector at a time on the feature vector objects. This class copies
+   *  the support vectors of a Model once into a contiguous row-major
+   *  matrix of ValueT and precomputes their squared norms. Test vectors
+   *  are packed into blocks of the same layout. For every block the dot
+   *  products with a block of support vectors are computed with a blocked
+   *  matrix product, where four test vectors share every load of a
+   *  support vector. The squared distances |x|^2 - 2 x.y + |y|^2 are
+   *  passed through a vectorizable exponential and summed with the
+   *  alphas. The blocks of test vectors are processed in parallel.
+   *
+   *  The decision values equal the ones of SVMBase::classify() up to the
+   *  rounding error of ValueT, so float halves the memory traffic and
+   *  doubles the SIMD width at about 1e-6 relative accuracy.
+   *
+   *  \param ValueT  float or double
+   */
+  /*======================================================================*/
+  template<typename ValueT>
+  class BatchedRBFDecision
+  {
+  public:
+
+    /*====================================================================*/
+    /*!
+     *   Default Constructor. The decision function is -rho = 0 until a
+     *   model is set.
+     */
+    /*====================================================================*/
+    BatchedRBFDecision();
+
+    /*====================================================================*/
+    /*!
+     *   Constructor copying the support vectors of the given model.
+     *
+     *   \param model  two class model with support vectors, alphas and
+     *                 rho
+     *   \param gamma  gamma of the RBF kernel, e.g. svm.kernel().gamma()
+     *
+     *   \exception WrongParameterError if the support vectors differ in
+     *              size
+     */
+    /*====================================================================*/
+    template<typename FV>
+    BatchedRBFDecision( const Model<FV>& model, double gamma);
+
+    /*====================================================================*/
+    /*!
+     *   Copy the support vectors, alphas and rho of the given model into
+     *   the packed representation.
+     *
+     *   \param model  two class model with support vectors, alphas and
+     *                 rho
+     *   \param gamma  gamma of the RBF kernel, e.g. svm.kernel().gamma()
+     *
+     *   \exception WrongParameterError if the support vectors differ in
+     *              size
+     */
+    /*====================================================================*/
+    template<typename FV>
+    void setModel( const Model<FV>& model, double gamma);
+
+    size_t nSupportVectors() const  { return _nSV; }
+    size_t featureVectorDim() const { return _dim; }
+    double gamma() const            { return _gamma; }
+    double rho() const              { return _rho; }
+
+    /*====================================================================*/
+    /*!
+     *   set the number of test vectors and support vectors per block
+     *   (default: 64 and 256). The defaults keep the support vector block
+     *   in the L2 cache for feature vectors with some hundred components.
+     *
+     *   \param testBlockSize  test vectors per block (and parallel task)
+     *   \param svBlockSize    support vectors per block
+     */
+    /*====================================================================*/
+    void setBlockSizes( size_t testBlockSize, size_t svBlockSize);
+
+    /*====================================================================*/
+    /*!
+     *   compute the decision values of the given feature vectors
+     *
+     *   \param fvBegin  random access iterator to the first feature
+     *                   vector (not pointer)
+     *   \param fvEnd    random access iterator behind the last feature
+     *                   vector
+     *   \param decisionValues  (output) one decision value per feature
+     *                   vector. Must have room for fvEnd - fvBegin values.
+     *
+     *   \exception WrongParameterError if a feature vector differs in
+     *              size from the support vectors
+     */
+    /*====================================================================*/
+    template<typename RandomAccessIter>
+    void decisionValues( const RandomAccessIter& fvBegin,
+                         const RandomAccessIter& fvEnd,
+                         double* decisionValues) const;
+
+    /*====================================================================*/
+    /*!
+     *   compute the decision values of test vectors stored as rows of a
+     *   contiguous row-major matrix with featureVectorDim() columns
+     *
+     *   \param testVectors     the test vector matrix
+     *   \param nTestVectors    number of rows
+     *   \param decisionValues  (output) one decision value per row
+     */
+    /*====================================================================*/
+    void decisionValues( const ValueT* testVectors, size_t nTestVectors,
+                         double* decisionValues) const;
+
+  private:
+
+    template<typename FV>
+    void _pack( const FV& fv, ValueT* row) const;
+
+    void _evaluateBlock( const ValueT* block, size_t nRows,
+                         ValueT* dots, ValueT* norms,
+                         double* decisionValues) const;
+
+    size_t _nSV;
+    size_t _dim;
+    size_t _dimPadded;
+    double _gamma;
+    double _rho;
+    size_t _testBlockSize;
+    size_t _svBlockSize;
+
+    std::vector<ValueT> _sv;
+    std::vector<ValueT> _svSquare;
+    std::vector<ValueT> _alpha;
+  };
+
+  /*======================================================================*/
+  /*!
+   *  \class BatchedRBFExp BatchedRBFDecision.hh
+   *  \brief Vectorizable in-place exponential of non-positive arguments
+   *         for float and double arrays.
+   *
+   *  The argument is split into n * ln(2) + r with |r| <= ln(2) / 2,
+   *  exp(r) is evaluated by its Taylor polynomial and 2^n is assembled in
+   *  the exponent bits. Arguments below the smallest normal result are
+   *  clamped, so the result never is denormal.
+   */
+  /*======================================================================*/
+  template<typename ValueT>
+  struct BatchedRBFExp;
+
+  template<>
+  struct BatchedRBFExp<double>
+  {
+    static void apply( double* x, size_t n);
+  };
+
+  template<>
+  struct BatchedRBFExp<float>
+  {
+    static void apply( float* x, size_t n);
+  };
+}
+
+#include "BatchedRBFDecision.icc"
+
+#endif
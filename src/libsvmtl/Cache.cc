@@ -75,6 +75,9 @@ svt::Cache::Cache(long l_,long size_):l(l_),size(size_)
 	    err << "Cache is to small! Size: "<< size_ << " but "<< l * sizeof(head_t)  << " bytes needed. use -cs flag to set cache size.\n";
 	    throw err;
 	}
+#ifdef _OPENMP
+	omp_init_lock(&lock);
+#endif
 }
 
 
@@ -83,6 +86,9 @@ svt::Cache::~Cache()
 	for(head_t *h = lru_head.next; h != &lru_head; h=h->next)
 		free(h->data);
 	free(head);
+#ifdef _OPENMP
+	omp_destroy_lock(&lock);
+#endif
 }
 
 void svt::Cache::lru_delete(head_t *h)
@@ -103,6 +109,9 @@ void svt::Cache::lru_insert(head_t *h)
 
 long svt::Cache::get_data(const long index, Qfloat **data, long len)
 {
+#ifdef _OPENMP
+	omp_set_lock(&lock);
+#endif
 	head_t *h = &head[index];
 	if(h->len) lru_delete(h);
 	long more = len - h->len;
@@ -128,6 +137,9 @@ long svt::Cache::get_data(const long index, Qfloat **data, long len)
 
 	lru_insert(h);
 	*data = h->data;
+#ifdef _OPENMP
+	omp_unset_lock(&lock);
+#endif
 	return len;
 }
 
@@ -135,6 +147,9 @@ void svt::Cache::swap_index(long i, long j)
 {
 	if(i==j) return;
 
+#ifdef _OPENMP
+	omp_set_lock(&lock);
+#endif
 	if(head[i].len) lru_delete(&head[i]);
 	if(head[j].len) lru_delete(&head[j]);
 	std::swap(head[i].data,head[j].data);
@@ -160,5 +175,8 @@ void svt::Cache::swap_index(long i, long j)
 			}
 		}
 	}
+#ifdef _OPENMP
+	omp_unset_lock(&lock);
+#endif
 }
 
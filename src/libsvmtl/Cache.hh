@@ -67,6 +67,10 @@
 #include "svm_defines.hh"
 #include "SVMError.hh"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace svt
 {
   //
@@ -75,6 +79,12 @@ namespace svt
   // l is the number of total data items
   // size is the cache size limit in bytes
   //
+  // get_data() and swap_index() are serialized by a lock, so several
+  // threads may request columns. A returned column stays valid until the
+  // next call that modifies the cache, the parallel solver therefore
+  // requests columns from one thread only and lets all threads read and
+  // fill the returned column.
+  //
   class Cache
   {
   public:
@@ -106,6 +116,9 @@ namespace svt
 	head_t lru_head;
 	void lru_delete(head_t *h);
 	void lru_insert(head_t *h);
+#ifdef _OPENMP
+	omp_lock_t lock;
+#endif
   };
 }
 
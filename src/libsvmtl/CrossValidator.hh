@@ -61,6 +61,12 @@
 #include "GroupedTrainingData.hh"
 #include "ProgressReporter.hh"
 #include "StDataASCII.hh"
+#include "SVMError.hh"
+#include "SquaredNorms.hh"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 // requirements of template parameters
 #include "svt_check/RequireFeatureVectorUniqueID.hh"
@@ -135,7 +141,8 @@ namespace svt
               _sum_nSV(0),
               _sum_nFV(0),
               _sum_nBSV(0),
-              _storeClassificationDetailsFlag( false)
+              _storeClassificationDetailsFlag( false),
+              _nThreads( 1)
 
           {
             if( _svm == 0)
@@ -299,6 +306,58 @@ namespace svt
     int doFullCV( const std::vector<int>& subsetIndexByUID,
                   std::vector<double>& predictedClassLabelByUID);
 
+    /*======================================================================*/
+    /*! 
+     *   like doFullCV(), but only the subsets
+     *   firstSubset...endSubset-1 are left out and classified. The
+     *   statistics of saveStatistics() refer to these subsets
+     *   only. This is used by the GridSearch to stop the evaluation
+     *   of clearly inferior grid points early, and to evaluate the
+     *   remaining grid points on further subsets without repeating
+     *   the already evaluated ones.
+     *
+     *   \param firstSubset      first subset to evaluate
+     *   \param endSubset        one past the last subset to evaluate
+     *   \param subsetIndexByUID see doFullCV()
+     *   \param predictedClassLabelByUID (output) stores the
+     *                           predicted class label for each
+     *                           feature vector of the evaluated
+     *                           subsets, other entries are left
+     *                           unchanged. Will be resized to same
+     *                           size as subsetIndexByUID
+     *
+     *   \return number of correct classifications in the evaluated
+     *           subsets
+     */
+    /*======================================================================*/
+    int doCVOnSubsets( int firstSubset, int endSubset,
+                       const std::vector<int>& subsetIndexByUID,
+                       std::vector<double>& predictedClassLabelByUID);
+
+    /*======================================================================*/
+    /*! 
+     *   set the number of OpenMP threads that retrain and classify
+     *   the subsets concurrently in doFullCV() (default: 1). Every
+     *   subset is retrained with its own solver and kernel cache, so
+     *   the memory for the cache_size of the SVM is needed once per
+     *   thread. The results do not depend on the number of threads.
+     *   The kernel function must be thread-safe for more than one
+     *   thread. The SVM's progress reporter is not used during the
+     *   concurrent retraining.
+     *
+     *   \param n number of threads, 0 = all available threads
+     */
+    /*======================================================================*/
+    void setNThreads( int n)
+          {
+            _nThreads = n;
+          }
+
+    int nThreads() const
+          {
+            return _nThreads;
+          }
+
     
     /*======================================================================*/
     /*! 
@@ -453,6 +512,7 @@ namespace svt
     unsigned int      _sum_nFV;
     unsigned int      _sum_nBSV;
     bool              _storeClassificationDetailsFlag;
+    int               _nThreads;
     std::vector< StDataASCII > _classificationDetailsByUID;
     
   };
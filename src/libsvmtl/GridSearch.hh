@@ -49,7 +49,15 @@
 #endif
 
 #include <iomanip>
+#include <vector>
+#include <string>
+#include <algorithm>
 #include "ClassificationStatistics.hh"
+#include "SquaredNorms.hh"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace svt
 {
@@ -59,7 +67,10 @@ namespace svt
     
     GridSearch()
             :_pr(0),
-             _printGridLevel(0)
+             _printGridLevel(0),
+             _nThreads(1),
+             _memoryLimitMB(0),
+             _halvingRate(0)
           {}
     
     
@@ -117,6 +128,63 @@ namespace svt
      *              properly 
      */
     /*======================================================================*/
+    /*======================================================================*/
+    /*! 
+     *   set the number of OpenMP threads for the search (default 1). The
+     *   threads are distributed over concurrently evaluated grid points
+     *   and the subsets of their cross validations. Every thread trains
+     *   with its own solver and kernel cache. The kernel function must
+     *   be thread-safe if more than one thread is used.
+     *
+     *   \param n  number of threads, 0 = all available threads
+     */
+    /*======================================================================*/
+    void setNThreads( int n)
+          {
+            _nThreads = n;
+          }
+
+    /*======================================================================*/
+    /*! 
+     *   limit the memory used by the kernel caches of concurrent
+     *   trainings (default 0 = no limit). Every training needs the
+     *   cache_size of the SVM, so at most memoryLimitMB / cache_size
+     *   trainings run concurrently.
+     *
+     *   \param memoryLimitMB  memory limit in MB, 0 = no limit
+     */
+    /*======================================================================*/
+    void setMemoryLimitMB( double memoryLimitMB)
+          {
+            _memoryLimitMB = memoryLimitMB;
+          }
+
+    /*======================================================================*/
+    /*! 
+     *   enable successive halving (default 0 = disabled). The grid
+     *   points are first cross validated on few subsets only, then only
+     *   the best 1/halvingRate of them is evaluated on
+     *   halvingRate-times as many subsets, until the remaining grid
+     *   points are evaluated on all subsets. The results of the
+     *   subsets evaluated in earlier rounds are kept, so each round
+     *   only trains on the additional subsets, and the grid points
+     *   that survive all rounds are trained exactly once per subset
+     *   like without successive halving. The predictions of the
+     *   active grid points are kept in memory meanwhile (one double
+     *   per feature vector and grid point). Grid points that were
+     *   terminated early get the key "terminatedEarly" in their grid
+     *   point infos, and "nCorrect" and the other statistics only
+     *   refer to the "nEvaluatedSubsets" evaluated subsets.
+     *
+     *   \param halvingRate  reduction factor per round, values <= 1
+     *                       disable successive halving
+     */
+    /*======================================================================*/
+    void setHalvingRate( double halvingRate)
+          {
+            _halvingRate = halvingRate;
+          }
+
     template< typename CROSSVALIDATOR>
     void search2D( const GridAxis& row, const GridAxis& col, 
                    CROSSVALIDATOR* cv, 
@@ -124,10 +192,68 @@ namespace svt
                    std::vector<svt::StDataASCII>& gridPointInfos,
                    unsigned int& bestGridPointIndex,
                    std::vector<svt::SingleClassResult>& bestResultTable);
+
+    /*======================================================================*/
+    /*! 
+     *   search on a 2D grid, evaluating grid points concurrently.
+     *   Every given cross validator is used by one thread, so you
+     *   should pass as many identically configured cross validators
+     *   (with training data set) as grid points shall be evaluated
+     *   concurrently. The number of threads, the memory limit and
+     *   successive halving are set with setNThreads(),
+     *   setMemoryLimitMB() and setHalvingRate(). Without successive
+     *   halving the results are the same as with the serial search2D().
+     *
+     *   If more than one cross validator is used, they must not have
+     *   progress reporters, progress is only reported by the GridSearch.
+     *   The number of threads of the cross validators is set by the
+     *   search.
+     *
+     *   With successive halving all grid point infos get the key
+     *   "nEvaluatedSubsets", and the grid points that were terminated
+     *   early additionally the key "terminatedEarly".
+     *
+     *   \param row  parameter name and its values along the grids row
+     *   \param col  parameter name and its values along the grids column
+     *   \param cvs  one cross validator per concurrent grid point
+     *   \param subsetIndexByUID see serial search2D()
+     *   \param gridPointInfos (output) see serial search2D()
+     *   \param bestGridPointIndex (output) index of the gridpoint with
+     *              best result over all subsets
+     *   \param bestResultTable per class results. vector will be resized
+     *              properly 
+     */
+    /*======================================================================*/
+    template< typename CROSSVALIDATOR>
+    void search2D( const GridAxis& row, const GridAxis& col, 
+                   const std::vector<CROSSVALIDATOR*>& cvs, 
+                   const std::vector<int>& subsetIndexByUID,
+                   std::vector<svt::StDataASCII>& gridPointInfos,
+                   unsigned int& bestGridPointIndex,
+                   std::vector<svt::SingleClassResult>& bestResultTable);
     
   private:
+    void checkAxes( const GridAxis& row, const GridAxis& col) const;
+
+    // state of a grid point during the concurrent search
+    enum { PENDING, EVALUATED, TERMINATED };
+    void printGrid( const GridAxis& row, const GridAxis& col,
+                    const std::vector<svt::StDataASCII>& gridPointInfos,
+                    const std::vector<char>& gridPointStates,
+                    size_t bestGridPointIndex,
+                    const std::string& bestResultTableString,
+                    int gridCellSize) const;
+
+    // add the cross validation statistics of the previous rounds of
+    // successive halving to the statistics of the current round
+    void addPreviousStatistics( const svt::StDataASCII& previousInfo,
+                                svt::StDataASCII& info) const;
+
     ProgressReporter* _pr;
     int               _printGridLevel;
+    int               _nThreads;
+    double            _memoryLimitMB;
+    double            _halvingRate;
     
   };
 }
@@ -53,6 +53,8 @@
 #include <config.hh>
 #endif
 
+#include "SquaredNorms.hh"
+
 //
 // Kernel evaluation
 //
@@ -63,7 +65,8 @@
 // libsvm -> libsvmtl:
 // - svm_node is replaced by FV template class
 // - kernel evaluation is done in given KF template class
-// - caching of square_x for RBF-kernels is done in BasicFV class
+// - caching of square_x for RBF-kernels is done in BasicFV class, kernels
+//   with KernelTraits<KF>::usesSquaredNorms get them precomputed here
 //
 namespace svt
 {
@@ -86,17 +89,40 @@ namespace svt
     virtual void swap_index(int i, int j) const	// no so const...
           {
             std::swap(x[i],x[j]);
+            if( x_square != 0) std::swap(x_square[i],x_square[j]);
           }
   protected:
     
     double kernel_function(int i, int j) const
         {
-          return _kernel.k_function( *(x[i]), *(x[j]));
+          return evaluate( *(x[i]), *(x[j]), i, j,
+                           SquaredNormsTag<
+                           KernelTraits<KF>::usesSquaredNorms>());
         }
     
     
   private:
+    template< bool USESQUAREDNORMS>
+    struct SquaredNormsTag
+    {};
+
+    void initSquaredNorms( int l, SquaredNormsTag<false>);
+    void initSquaredNorms( int l, SquaredNormsTag<true>);
+
+    double evaluate( const FV& xi, const FV& xj, int, int,
+                     SquaredNormsTag<false>) const
+        {
+          return _kernel.k_function( xi, xj);
+        }
+    
+    double evaluate( const FV& xi, const FV& xj, int i, int j,
+                     SquaredNormsTag<true>) const
+        {
+          return _kernel.k_function( xi, xj, x_square[i], x_square[j]);
+        }
+    
     const FV** x; // array of pointers to feature vectors
+    double* x_square; // squared norms, if the kernel uses them
     const KF&    _kernel;
     
 
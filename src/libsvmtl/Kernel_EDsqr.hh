@@ -55,6 +55,7 @@
 
 // libsvmtl includes
 #include "ProgressReporter.hh"
+#include "SquaredNorms.hh"
 
 // requirements of template parameters
 #include "svt_check/RequireStData.hh"
@@ -113,6 +114,14 @@ namespace svt
             return x.square() - 2*x.dotProduct(y) + y.square();
           };
 
+    // variant for precomputed squares, see KernelTraits
+    template< typename FV>
+    double k_function( const FV& x, const FV& y,
+                       double xSquare, double ySquare) const
+          {
+            return xSquare - 2*x.dotProduct(y) + ySquare;
+          };
+
     template<typename STDATA>
     void loadParameters( STDATA& stData)
           {
@@ -150,6 +159,12 @@ namespace svt
           {
           }    
   };
+
+  template<>
+  struct KernelTraits<Kernel_EDsqr>
+  {
+    static const bool usesSquaredNorms = true;
+  };
 }
 
 #endif
@@ -101,6 +101,7 @@
 
 // libsvmtl includes
 #include "ProgressReporter.hh"
+#include "SquaredNorms.hh"
 
 // requirements of template parameters
 #include "svt_check/RequireStData.hh"
@@ -163,6 +164,14 @@ namespace svt
             return exp(-p_gamma*(x.square() - 2*x.dotProduct(y) + y.square()));
           }
 
+    // variant for precomputed squares, see KernelTraits
+    template< typename FV>
+    double k_function( const FV& x, const FV& y,
+                       double xSquare, double ySquare) const
+          {
+            return exp(-p_gamma*(xSquare - 2*x.dotProduct(y) + ySquare));
+          }
+
     template< typename FV, typename FVGradient>
     void gradient_of_k_function( const FV& x, const FV& y,
                                 FVGradient& gradient) const
@@ -227,6 +236,12 @@ namespace svt
   protected:
     double p_gamma;
   };
+
+  template<>
+  struct KernelTraits<Kernel_RBF>
+  {
+    static const bool usesSquaredNorms = true;
+  };
 }
 
 #endif
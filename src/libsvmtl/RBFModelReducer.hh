@@ -0,0 +1,196 @@
+/**************************************************************************
+ *
+ * Copyright (C) 2015 Thorsten Falk
+ *
+ *        Image Analysis Lab, University of Freiburg, Germany
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ *
+ **************************************************************************/
+
+/**************************************************************************
+**       Title: reduced set approximation of RBF models
+**    $RCSfile$
+**   $Revision$$Name$
+**       $Date$
+**   Copyright: GPL $Author$
+** Description:
+**
+**    Approximates the expansion of a two class RBF-SVM by a smaller
+**    expansion using pre-images or Nystroem landmarks
+**
+**************************************************************************/
+
+#ifndef RBFMODELREDUCER_HH
+#define RBFMODELREDUCER_HH
+
+#ifdef HAVE_CONFIG_H
+#include <config.hh>
+#endif
+
+// std includes
+#include <cstddef>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// libsvmtl includes
+#include "Model.hh"
+#include "SVMError.hh"
+
+namespace svt
+{
+  /*======================================================================*/
+  /*!
+   *  \class RBFModelReducer RBFModelReducer.hh
+   *  \brief The RBFModelReducer class approximates a two class RBF model
+   *         by an expansion over fewer vectors.
+   *
+   *  The decision function sum_i alpha_i k(x_i, x) - rho of a model with
+   *  n support vectors is replaced by sum_j beta_j k(z_j, x) - rho with
+   *  m << n vectors z_j, so classification cost drops by n / m. For given
+   *  z_j the coefficients beta are chosen optimally, i.e. they minimize
+   *  the feature space distance between both expansions, which means
+   *  solving K_zz beta = K_zx alpha.
+   *
+   *  reducePreImage() implements the greedy reduced set method of Burges
+   *  and Schoelkopf: every new z_j is the pre-image of the residual
+   *  expansion found by the RBF fixed-point iteration, started at the
+   *  support vector with the largest residual decision value.
+   *
+   *  reduceNystroem() selects m support vectors as landmarks by pivoted
+   *  incomplete Cholesky decomposition of the kernel matrix. The linear
+   *  decision function on the Nystroem feature map
+   *  phi(x) = K_mm^(-1/2) k_m(x) with weights w = sum_i alpha_i phi(x_i)
+   *  equals the landmark expansion with the optimal beta, so the result
+   *  is stored and evaluated like any other RBF model.
+   *
+   *  The support vectors must be dense feature vectors providing size()
+   *  and operator[], e.g. BasicFV.
+   */
+  /*======================================================================*/
+  template<typename FV>
+  class RBFModelReducer
+  {
+  public:
+
+    /*====================================================================*/
+    /*!
+     *   Constructor. The support vectors of the model are copied and the
+     *   squared feature space norm of the expansion is computed, which
+     *   costs one evaluation of the full kernel matrix.
+     *
+     *   \param model  two class model with support vectors, alphas and
+     *                 rho
+     *   \param gamma  gamma of the RBF kernel
+     *
+     *   \exception WrongParameterError if the support vectors differ in
+     *              size
+     */
+    /*====================================================================*/
+    RBFModelReducer( const Model<FV>& model, double gamma);
+
+    /*====================================================================*/
+    /*!
+     *   greedy reduced set approximation using pre-images
+     *
+     *   \param nVectors       number of vectors of the reduced expansion.
+     *                         Fewer are returned if the residual vanishes.
+     *   \param reduced        (output) the reduced model. It owns its
+     *                         support vectors.
+     *   \param maxIterations  maximum number of fixed-point iterations per
+     *                         pre-image
+     */
+    /*====================================================================*/
+    void reducePreImage( size_t nVectors, Model<FV>& reduced,
+                         unsigned int maxIterations = 100);
+
+    /*====================================================================*/
+    /*!
+     *   Nystroem approximation with landmarks chosen from the support
+     *   vectors
+     *
+     *   \param nLandmarks  number of landmarks. Fewer are returned if the
+     *                      kernel matrix has lower numerical rank.
+     *   \param reduced     (output) the reduced model. It owns its
+     *                      support vectors.
+     */
+    /*====================================================================*/
+    void reduceNystroem( size_t nLandmarks, Model<FV>& reduced);
+
+    /*====================================================================*/
+    /*!
+     *   relative feature space error |Psi - Psi'| / |Psi| of the last
+     *   reduction, where Psi is the expansion of the original model and
+     *   Psi' the reduced one
+     *
+     *   \return relative approximation error
+     */
+    /*====================================================================*/
+    double relativeError() const
+          {
+            return _relativeError;
+          }
+
+    size_t nSupportVectors() const
+          {
+            return _n;
+          }
+
+  private:
+
+    double _kernel( const double* a, double aSquare,
+                    const double* b, double bSquare) const;
+
+    void _kernelColumn( const double* z, double zSquare,
+                        std::vector<double>& column) const;
+
+    // Appends the kernel values of the new vector with the previous ones to
+    // the Cholesky factor of K_zz. Returns false if the new vector is
+    // numerically in the span of the previous ones.
+    bool _appendCholesky( const std::vector<double>& kzz);
+
+    void _solveCoefficients( std::vector<double>& beta) const;
+
+    void _setModel( const std::vector< std::vector<double> >& vectors,
+                    const std::vector<double>& beta,
+                    Model<FV>& reduced);
+
+    size_t _n;
+    size_t _dim;
+    double _gamma;
+    double _rho;
+    std::vector<double> _x;
+    std::vector<double> _xSquare;
+    std::vector<double> _alpha;
+    // decision values sum_k alpha_k k(x_k, x_i) at the support vectors
+    std::vector<double> _f;
+    double _psiSquare;
+
+    // Cholesky factor of K_zz (row-major, lower triangular, growing) and
+    // the projections K_zx alpha of the current reduction
+    std::vector< std::vector<double> > _cholesky;
+    std::vector<double> _projection;
+    double _relativeError;
+  };
+}
+
+#include "RBFModelReducer.icc"
+
+#endif
@@ -0,0 +1,179 @@
+/**************************************************************************
+ *
+ * Copyright (C) 2015 Thorsten Falk
+ *
+ *        Image Analysis Lab, University of Freiburg, Germany
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ *
+ **************************************************************************/
+
+/**************************************************************************
+**       Title: random Fourier feature approximation of RBF models
+**    $RCSfile$
+**   $Revision$$Name$
+**       $Date$
+**   Copyright: GPL $Author$
+** Description:
+**
+**    Approximates the decision function of a two class RBF-SVM by a
+**    linear function on random Fourier features
+**
+**************************************************************************/
+
+#ifndef RANDOMFOURIERRBFMODEL_HH
+#define RANDOMFOURIERRBFMODEL_HH
+
+#ifdef HAVE_CONFIG_H
+#include <config.hh>
+#endif
+
+// std includes
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <stdint.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// libsvmtl includes
+#include "Model.hh"
+#include "SVMError.hh"
+
+namespace svt
+{
+  /*======================================================================*/
+  /*!
+   *  \class RandomFourierRBFModel RandomFourierRBFModel.hh
+   *  \brief The RandomFourierRBFModel class approximates a two class RBF
+   *         model by a linear function on random Fourier features.
+   *
+   *  By Bochner's theorem exp(-gamma*|x-y|^2) = E[2 cos(w.x+b) cos(w.y+b)]
+   *  for w ~ N(0, 2*gamma*I) and b ~ U[0, 2*pi). With D samples (w_j, b_j)
+   *  the decision function of the model becomes
+   *
+   *    f(x) = sum_j v_j cos(w_j.x + b_j) - rho,
+   *    v_j  = 2 / D sum_i alpha_i cos(w_j.x_i + b_j),
+   *
+   *  whose cost is D * (dim + 1) per test vector independent of the number
+   *  of support vectors. The error decreases like 1 / sqrt(D), so this
+   *  only pays off for models with many support vectors.
+   */
+  /*======================================================================*/
+  class RandomFourierRBFModel
+  {
+  public:
+
+    RandomFourierRBFModel()
+            : _nFeatures( 0),
+              _dim( 0),
+              _gamma( 1.0),
+              _rho( 0.0)
+          {}
+
+    /*====================================================================*/
+    /*!
+     *   sample the random features and project the given model onto them
+     *
+     *   \param model      two class model with support vectors, alphas
+     *                     and rho. The support vectors must provide
+     *                     size() and operator[].
+     *   \param gamma      gamma of the RBF kernel
+     *   \param nFeatures  number of random features D
+     *   \param seed       seed of the random number generator, the same
+     *                     seed gives the same features
+     *
+     *   \exception WrongParameterError if the support vectors differ in
+     *              size
+     */
+    /*====================================================================*/
+    template<typename FV>
+    void approximate( const Model<FV>& model, double gamma,
+                      size_t nFeatures, unsigned int seed = 1);
+
+    size_t nFeatures() const        { return _nFeatures; }
+    size_t featureVectorDim() const { return _dim; }
+    double gamma() const            { return _gamma; }
+    double rho() const              { return _rho; }
+
+    /*====================================================================*/
+    /*!
+     *   compute the approximated decision values of the given feature
+     *   vectors
+     *
+     *   \param fvBegin  random access iterator to the first feature
+     *                   vector (not pointer)
+     *   \param fvEnd    random access iterator behind the last feature
+     *                   vector
+     *   \param decisionValues  (output) one decision value per feature
+     *                   vector. Must have room for fvEnd - fvBegin values.
+     *
+     *   \exception WrongParameterError if a feature vector differs in
+     *              size from the support vectors
+     */
+    /*====================================================================*/
+    template<typename RandomAccessIter>
+    void decisionValues( const RandomAccessIter& fvBegin,
+                         const RandomAccessIter& fvEnd,
+                         double* decisionValues) const;
+
+    /*====================================================================*/
+    /*!
+     *   save the approximation to the given structured data. The keys
+     *   are prefix + "model_type" ("random_fourier_features"), "gamma",
+     *   "rho", "n_features", "feature_vector_dim", "projection",
+     *   "offsets" and "weights".
+     *
+     *   \param stData  structured data (e.g. StDataASCII, StDataHdf5)
+     *   \param prefix  prefix for all keys
+     */
+    /*====================================================================*/
+    template<typename STDATA>
+    void saveParameters( STDATA& stData,
+                         const std::string& prefix = "") const;
+
+    /*====================================================================*/
+    /*!
+     *   load an approximation stored with saveParameters()
+     *
+     *   \param stData  structured data (e.g. StDataASCII, StDataHdf5)
+     *   \param prefix  prefix for all keys
+     *
+     *   \exception WrongParameterError if the stored model type differs
+     *              or the array sizes do not match
+     */
+    /*====================================================================*/
+    template<typename STDATA>
+    void loadParameters( STDATA& stData, const std::string& prefix = "");
+
+  private:
+
+    size_t _nFeatures;
+    size_t _dim;
+    double _gamma;
+    double _rho;
+    // row-major nFeatures x dim matrix of the frequencies w_j
+    std::vector<double> _projection;
+    std::vector<double> _offsets;
+    std::vector<double> _weights;
+  };
+}
+
+#include "RandomFourierRBFModel.icc"
+
+#endif
@@ -91,9 +91,13 @@ namespace svt
   { 
   public:
     
+    // nThreads > 1 computes missing column entries in parallel, the
+    // kernel function must then be thread-safe. The squares of the
+    // feature vectors are computed by the Kernel base class before.
     SVC_Q( const KF& kernel, const SVM_Problem<FV>& prob, float cacheSizeMB,
-           const schar *y_)
-            :Kernel<FV,KF>( kernel, prob.l, prob.x)
+           const schar *y_, int nThreads = 1)
+            :Kernel<FV,KF>( kernel, prob.l, prob.x),
+             _nThreads( nThreads)
 	{
 		clone(y,y_,prob.l);
 		cache = new Cache(prob.l,(int)(cacheSizeMB*(1<<20)));
@@ -111,6 +115,9 @@ namespace svt
 		if((start = static_cast<int>(cache->get_data(i,&data,len))) <
                    len)
 		{
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(_nThreads) if(_nThreads > 1)
+#endif
                   for(int j = start; j < len; j++)
                       data[j] = static_cast<Qfloat>(
                           y[i] * y[j] * this->kernel_function(i,j));
@@ -133,6 +140,7 @@ namespace svt
 private:
 	schar *y;
 	Cache *cache;
+	int _nThreads;
   };
 }
 
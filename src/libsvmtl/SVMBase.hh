@@ -86,6 +86,7 @@ namespace svt
   static const double TERMINATION_EPSILON_DEFAULT = 0.001;
   static const float  CACHE_SIZE_MB_DEFAULT       = 40;
   static const bool   SHRINKING_FLAG_DEFAULT      = true;
+  static const int    N_THREADS_DEFAULT           = 1;
   
 
   /*======================================================================*/
@@ -120,6 +121,7 @@ namespace svt
             : _terminationEpsilon( TERMINATION_EPSILON_DEFAULT),
               _cacheSizeMB( CACHE_SIZE_MB_DEFAULT),
               _shrinkingFlag( SHRINKING_FLAG_DEFAULT),
+              _nThreads( N_THREADS_DEFAULT),
               _pr( 0)
           {}
     
@@ -139,6 +141,7 @@ namespace svt
               _terminationEpsilon( TERMINATION_EPSILON_DEFAULT),
               _cacheSizeMB( CACHE_SIZE_MB_DEFAULT),
               _shrinkingFlag( SHRINKING_FLAG_DEFAULT),
+              _nThreads( N_THREADS_DEFAULT),
               _pr( 0)
           {}
 
@@ -280,6 +283,27 @@ namespace svt
           {
             return _shrinkingFlag;
           }
+
+    /*======================================================================*/
+    /*! 
+     *   set the number of OpenMP threads used by the solver (default: 1).
+     *   The trained model is identical for any number of threads. The
+     *   kernel function must be thread-safe if more than one thread is
+     *   used.
+     *
+     *   \param n number of threads, 0 = all available threads
+     *
+     */
+    /*======================================================================*/
+    void setNThreads( int n)
+          {
+            _nThreads = n;
+          }
+
+    int nThreads() const
+          {
+            return _nThreads;
+          }
   
     /*======================================================================*/
     /*!
@@ -295,6 +319,10 @@ namespace svt
             stData.getValue( "epsilon", _terminationEpsilon);
             stData.getValue( "cache_size", _cacheSizeMB);
             stData.getValue( "shrinking", _shrinkingFlag);
+            if( stData.valueExists( "n_threads"))
+            {
+              stData.getValue( "n_threads", _nThreads);
+            }
           }
     
     /*======================================================================*/
@@ -311,6 +339,7 @@ namespace svt
             stData.setValue( "epsilon", terminationEpsilon());
             stData.setValue( "cache_size", cacheSizeMB());
             stData.setValue( "shrinking", shrinkingFlag());
+            stData.setValue( "n_threads", nThreads());
           }
 
     /*======================================================================*/
@@ -336,6 +365,10 @@ namespace svt
             p.back().addAlternative("0", "don't use the shrinking heuristics");
             p.back().addAlternative("1", "use the shrinking heuristics "
                                     "(default)");
+            p.push_back(
+                ParamInfo( "n_threads", "nt", "number",
+                           "number of solver threads, 0 = all available "
+                           "(default 1)"));
           }
     
     
@@ -367,6 +400,7 @@ namespace svt
     double _terminationEpsilon;   // epsilon as termination criterium
     float  _cacheSizeMB; // cache size in Mega-Bytes
     bool   _shrinkingFlag; // flag, wether to do shrinking during training
+    int    _nThreads; // number of solver threads
     ProgressReporter* _pr;
   };
     
@@ -87,6 +87,9 @@
 #include "Kernel.hh"
 #include "ProgressReporter.hh"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace svt
 {
@@ -108,11 +111,17 @@ namespace svt
   //
   // solution will be put in \alpha, objective value will be put in obj
   //
+  // With setNThreads() the gradient updates and the working set selection
+  // are distributed over OpenMP threads. Every gradient entry is updated
+  // with the same operations in the same order and the working set
+  // selection resolves ties to the smallest index like the serial loop,
+  // so the solution is bit-identical to the serial one.
+  //
   template< typename FV, typename KF>
   class Solver 
   {
   public:
-    Solver() {};
+    Solver() : _nThreads(1) {};
     virtual ~Solver() {};
 
   private:
@@ -128,6 +137,14 @@ namespace svt
                SolutionInfo* si, int shrinking,
                ProgressReporter* progressReporter);
 
+    // nThreads <= 0 uses all available OpenMP threads. Without OpenMP
+    // the solver always runs serially.
+    void setNThreads( int nThreads);
+    int nThreads() const
+          {
+            return _nThreads;
+          }
+
   protected:
     int active_size;
     schar *y;
@@ -143,6 +160,14 @@ namespace svt
     double *G_bar;		// gradient, if we treat free variables as 0
     int l;
     bool unshrinked;	// XXX
+    int _nThreads;
+
+    // Loops shorter than this are not worth the thread team start-up
+    enum { PARALLEL_MIN_LENGTH = 1024 };
+    bool parallel( int len) const
+          {
+            return _nThreads > 1 && len >= PARALLEL_MIN_LENGTH;
+          }
     
     double get_C(int i)
           {
@@ -161,6 +186,10 @@ namespace svt
     bool is_free(int i) { return alpha_status[i] == FREE; }
     void swap_index(int i, int j);
     void reconstruct_gradient();
+    // Scan [begin, end) for the maximal violating pair like
+    // select_working_set() but without the stopping test
+    void scan_working_set(int begin, int end, double &Gmax1, int &Gmax1_idx,
+                          double &Gmax2, int &Gmax2_idx);
     virtual int select_working_set(int &i, int &j);
     virtual double calculate_rho();
     virtual void do_shrinking();
@@ -0,0 +1,110 @@
+/**************************************************************************
+ *
+ * Copyright (C) 2004-2015 Olaf Ronneberger, Florian Pigorsch, Jörg Mechnich,
+ *                         Thorsten Falk
+ *
+ *        Image Analysis Lab, University of Freiburg, Germany
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ *
+ **************************************************************************/
+
+#ifndef SQUAREDNORMS_HH
+#define SQUAREDNORMS_HH
+
+#ifdef HAVE_CONFIG_H
+#include <config.hh>
+#endif
+
+namespace svt
+{
+  /*======================================================================*/
+  /*!
+   *  \class KernelTraits
+   *  \brief The KernelTraits class tells the Kernel base class, whether
+   *         a kernel function can be evaluated from precomputed squared
+   *         norms
+   *
+   *  Kernels that set usesSquaredNorms provide
+   *  k_function( x, y, xSquare, ySquare), which gets x.square() and
+   *  y.square() as arguments instead of calling them. The Kernel base
+   *  class then computes the squared norms of all training vectors once
+   *  (like x_square in libsvm), so the kernel columns can be computed
+   *  concurrently without taking the lock of BasicFV::square().
+   */
+  /*======================================================================*/
+  template< typename KF>
+  struct KernelTraits
+  {
+    static const bool usesSquaredNorms = false;
+  };
+
+
+  /*======================================================================*/
+  /*!
+   *  \class HasSquare
+   *  \brief The HasSquare class checks whether the feature vector class
+   *         FV has a method double square() const
+   */
+  /*======================================================================*/
+  template< typename FV>
+  class HasSquare
+  {
+    typedef char Yes;
+    typedef char No[2];
+    template< typename T, double (T::*)() const> struct Check;
+    template< typename T> static Yes& test( Check<T, &T::square>*);
+    template< typename T> static No& test( ...);
+  public:
+    static const bool value = (sizeof( test<FV>( 0)) == sizeof( Yes));
+  };
+
+  template< bool HASSQUARE>
+  struct SquareUpdater
+  {
+    template< typename FV>
+    static void update( const FV&)
+          {}
+  };
+
+  template<>
+  struct SquareUpdater<true>
+  {
+    template< typename FV>
+    static void update( const FV& fv)
+          {
+            fv.square();
+          }
+  };
+
+  /*======================================================================*/
+  /*!
+   *   compute the lazily cached square of the given feature vector, if
+   *   its class has a square() method. SparseFV fills this cache
+   *   without lock, so call this for all shared feature vectors before
+   *   several threads train or classify with them. Afterwards
+   *   square() only reads the cached value.
+   *
+   *   \param fv  the feature vector
+   */
+  /*======================================================================*/
+  template< typename FV>
+  inline void updateSquare( const FV& fv)
+  {
+    SquareUpdater<HasSquare<FV>::value>::update( fv);
+  }
+}
+
+#endif
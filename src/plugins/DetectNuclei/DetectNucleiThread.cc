@@ -68,7 +68,8 @@ void DetectNucleiThread::run()
 
   detectNuclei(
       data, nuclei, _parameters.modelFileName(),
-      _parameters.memoryLimit(), _parameters.cacheFileName(), p_progress);
+      _parameters.memoryLimit(), _parameters.cacheFileName(), false,
+      p_progress);
   
   if (nuclei.size() > 0)
   {
@@ -93,5 +93,5 @@ void RootSegmentationThread::run()
       _parameters.nDiffusionIterations(), _parameters.zCompensationFactor(),
       _parameters.kappa(), _parameters.tau(), _parameters.edgeThreshold(),
       _parameters.minimumCellVolumeUm3(), _parameters.boundaryThicknessPx(),
-      _parameters.debugFileName(), p_progress);
+      0.0, 0, _parameters.debugFileName(), p_progress);
 }
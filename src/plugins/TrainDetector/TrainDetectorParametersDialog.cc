@@ -110,6 +110,14 @@ TrainDetectorParametersDialog::TrainDetectorParametersDialog(
   p_gammaControlElement = new DoubleControlElement(tr("gamma:"), 0.01);
   p_gammaControlElement->setRange(0.0, std::numeric_limits<double>::infinity());
   kernelParameterGroupLayout->addWidget(p_gammaControlElement);
+  p_cascadeRecallControlElement = new DoubleControlElement(
+      tr("Cascade recall:"), 0.0);
+  p_cascadeRecallControlElement->setRange(0.0, 1.0);
+  p_cascadeRecallControlElement->setToolTip(
+      tr("Fraction of the nuclei in the training set that pass the linear "
+         "pre-selection stage. Voxels rejected by this stage are not "
+         "classified by the SVM. Set to 0 to disable the cascade."));
+  kernelParameterGroupLayout->addWidget(p_cascadeRecallControlElement);
   parameterLayout->addWidget(kernelParameterGroup);
 
   parameterPanel->setLayout(parameterLayout);
@@ -151,6 +159,9 @@ TrainDetectorParametersDialog::TrainDetectorParametersDialog(
       settings.value("iRoCSPipeline/TrainDetector/cost", 10.0).toDouble());
   p_gammaControlElement->setValue(
       settings.value("iRoCSPipeline/TrainDetector/gamma", 0.01).toDouble());  
+  p_cascadeRecallControlElement->setValue(
+      settings.value(
+          "iRoCSPipeline/TrainDetector/cascadeRecall", 0.0).toDouble());
 
   setLayout(mainLayout);
 }
@@ -264,6 +275,16 @@ double TrainDetectorParametersDialog::gamma() const
   return p_gammaControlElement->value();
 }
 
+void TrainDetectorParametersDialog::setCascadeTargetRecall(double recall)
+{
+  p_cascadeRecallControlElement->setValue(recall);
+}
+
+double TrainDetectorParametersDialog::cascadeTargetRecall() const
+{
+  return p_cascadeRecallControlElement->value();
+}
+
 void TrainDetectorParametersDialog::checkAndAccept()
 {
   // Check input files
@@ -370,6 +391,8 @@ void TrainDetectorParametersDialog::checkAndAccept()
       int(houghFeatureNormalization()));  
   settings.setValue("iRoCSPipeline/TrainDetector/cost", cost());
   settings.setValue("iRoCSPipeline/TrainDetector/gamma", gamma());  
+  settings.setValue(
+      "iRoCSPipeline/TrainDetector/cascadeRecall", cascadeTargetRecall());
 
   accept();
 }
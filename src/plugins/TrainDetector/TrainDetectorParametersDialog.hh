@@ -86,6 +86,9 @@ public:
   void setGamma(double gamma);
   double gamma() const;
 
+  void setCascadeTargetRecall(double recall);
+  double cascadeTargetRecall() const;
+
 private slots:
   
   void checkAndAccept();
@@ -106,6 +109,7 @@ private:
   StringSelectionControlElement *p_houghNormalizationControl;
   DoubleControlElement* p_costControlElement;
   DoubleControlElement* p_gammaControlElement;
+  DoubleControlElement* p_cascadeRecallControlElement;
   
 };
 
@@ -0,0 +1,454 @@
+/**************************************************************************
+ *
+ * Copyright (C) 2015 Thorsten Falk
+ *
+ *        Image Analysis Lab, University of Freiburg, Germany
+ * 
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+ *
+ **************************************************************************/
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#endif
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <cmath>
+
+#include <libcmdline/CmdLine.hh>
+#include <libcmdline/ArgvIter.hh>
+
+#include <libArrayToolbox/ATBTiming.hh>
+
+#include <libsvmtl/BasicFV.hh>
+#include <libsvmtl/Model.hh>
+#include <libsvmtl/TwoClassSVMc.hh>
+#include <libsvmtl/Kernel_RBF.hh>
+#include <libsvmtl/StDataHdf5.hh>
+#include <libsvmtl/BatchedRBFDecision.hh>
+#include <libsvmtl/RBFModelReducer.hh>
+#include <libsvmtl/RandomFourierRBFModel.hh>
+
+#include <libIRoCS/iRoCSFeatures.hh>
+
+#include <libProgressReporter/ProgressReporterStream.hh>
+
+class CmdLineVersionError: public CmdLineError {};
+class CmdLineLicenseError: public CmdLineError {};
+
+struct Evaluation
+{
+  double accuracy;
+  double agreement;
+  double meanAbsDifference;
+  double secondsPerVector;
+};
+
+// Approximates the model with the given method and size. Expansion methods
+// return the reduced model, random Fourier features the feature model.
+static void approximate(
+    std::string const &method, size_t size, double gamma,
+    svt::Model<svt::BasicFV> const &model,
+    svt::RBFModelReducer<svt::BasicFV> &reducer,
+    svt::Model<svt::BasicFV> &reduced,
+    svt::RandomFourierRBFModel &randomFeatureModel)
+{
+  if (method == "reduced_set") reducer.reducePreImage(size, reduced);
+  else if (method == "nystroem") reducer.reduceNystroem(size, reduced);
+  else randomFeatureModel.approximate(model, gamma, size);
+}
+
+template<typename DecisionT>
+static Evaluation evaluate(
+    DecisionT const &decision, std::vector<svt::BasicFV> const &testVectors,
+    std::vector<double> const &exactDecisionValues,
+    std::vector<double> &decisionValues)
+{
+  decisionValues.resize(testVectors.size());
+  long long start = atb::MyDateTime::time_us();
+  decision.decisionValues(
+      testVectors.begin(), testVectors.end(), &decisionValues[0]);
+  long long stop = atb::MyDateTime::time_us();
+
+  Evaluation result;
+  result.accuracy = 0.0;
+  result.agreement = 0.0;
+  result.meanAbsDifference = 0.0;
+  for (size_t i = 0; i < testVectors.size(); ++i)
+  {
+    if ((testVectors[i].getLabel() > 0) == (decisionValues[i] > 0))
+        result.accuracy += 1.0;
+    if (exactDecisionValues.size() == 0) continue;
+    if ((exactDecisionValues[i] > 0) == (decisionValues[i] > 0))
+        result.agreement += 1.0;
+    result.meanAbsDifference +=
+        std::abs(decisionValues[i] - exactDecisionValues[i]);
+  }
+  double n = static_cast<double>(testVectors.size());
+  result.accuracy /= n;
+  result.agreement /= n;
+  result.meanAbsDifference /= n;
+  result.secondsPerVector = 1.0e-6 * static_cast<double>(stop - start) / n;
+  return result;
+}
+
+int main(int argc, char **argv)
+{
+  CmdArgThrow<CmdLineVersionError> versionArg(
+      0, "version", "Display version information.");
+  CmdArgThrow<CmdLineLicenseError> licenseArg(
+      0, "license", "Display licensing information.");
+
+  CmdArgType<std::string> inFileName(
+      "<hdf5 svmtl model file>",
+      "The two-class detector model to compress as generated by the "
+      "'Train Detector' plugin in 'labelling'", CmdArg::isREQ);
+  CmdArgType<std::string> outFileName(
+      'o', "outfile", "<hdf5 file>", "The compressed model is written to a "
+      "copy of the input model with this name. The exact model is kept, the "
+      "approximation is stored under the 'approx_' keys and used by the "
+      "detector instead of the exact model.", CmdArg::isREQ);
+  CmdArgType<std::string> testFileName(
+      't', "testset", "<ascii file>", "Held-out feature vectors to measure "
+      "the accuracy-versus-speed curve on. One vector per line, the label "
+      "(> 0 for positive samples) followed by the features.", CmdArg::isREQ);
+  CmdArgSwitch normalize(
+      'n', "normalize", "If this flag is given the held-out feature vectors "
+      "are normalized using the normalization parameters of the model. Give "
+      "it if the vectors contain raw feature values.");
+  CmdArgType<std::string> method(
+      'a', "approximation", "<reduced_set|nystroem|random_fourier_features>",
+      "The approximation method. 'reduced_set' computes pre-images of the "
+      "kernel expansion, 'nystroem' selects landmarks among the support "
+      "vectors, 'random_fourier_features' uses a linear decision function "
+      "on random Fourier features.");
+  method.setDefaultValue("reduced_set");
+  CmdArgType<std::string> sizes(
+      's', "sizes", "<n1,n2,...>", "Comma-separated list of the number of "
+      "vectors (or random features) to try.");
+  sizes.setDefaultValue("50,100,200,500,1000");
+  CmdArgType<double> minAgreement(
+      0, "minAgreement", "<double in [0,1]>", "The smallest size whose "
+      "classifications agree with the exact model on at least this fraction "
+      "of the held-out vectors is stored. If no size reaches it, the largest "
+      "one is stored.");
+  minAgreement.setDefaultValue(0.99);
+
+  CmdLine cmd(argv[0], "Detector model compression");
+  cmd.description("Approximate a two-class RBF detector model with fewer "
+                  "kernel evaluations and report the accuracy-versus-speed "
+                  "curve on a held-out set");
+  
+  try
+  {
+    cmd.append(&versionArg);
+    cmd.append(&licenseArg);
+
+    cmd.append(&inFileName);
+    cmd.append(&outFileName);
+    cmd.append(&testFileName);
+    cmd.append(&normalize);
+    cmd.append(&method);
+    cmd.append(&sizes);
+    cmd.append(&minAgreement);
+    
+    ArgvIter argvIter(--argc, ++argv);
+    cmd.parse(argvIter);
+
+    if (method.value() != "reduced_set" && method.value() != "nystroem" &&
+        method.value() != "random_fourier_features")
+    {
+      std::cerr << "Unknown approximation method '" << method.value() << "'"
+                << std::endl;
+      exit(-2);
+    }
+
+    std::vector<size_t> sizeList;
+    std::istringstream sizeStream(sizes.value());
+    std::string token;
+    while (std::getline(sizeStream, token, ','))
+    {
+      int size = atoi(token.c_str());
+      if (size > 0) sizeList.push_back(static_cast<size_t>(size));
+    }
+    if (sizeList.size() == 0)
+    {
+      std::cerr << "No valid size given" << std::endl;
+      exit(-2);
+    }
+
+    iRoCS::ProgressReporterStream pr(std::cout, 0, 0, 100, "\r ");
+
+    /*---------------------------------------------------------------------
+     *  Load exact model
+     *---------------------------------------------------------------------*/
+    svt::Model<svt::BasicFV> model;
+    svt::TwoClassSVMc<svt::Kernel_RBF> svm;
+    try
+    {
+      svt::StDataHdf5 modelMap(inFileName.value().c_str());
+      modelMap.setExceptionFlag(true);
+      if (modelMap.valueExists("approx_model_type"))
+      {
+        std::cerr << "'" << inFileName.value() << "' already contains an "
+                  << "approximated model. Please compress the original "
+                  << "model." << std::endl;
+        exit(-2);
+      }
+      model.loadParameters(modelMap);
+      svm.loadParameters(modelMap);
+    }
+    catch (std::exception &e)
+    {
+      std::cerr << "Could not load SVM model from '" << inFileName.value()
+                << "': " << e.what() << std::endl;
+      exit(-2);
+    }
+    double gamma = svm.kernel().gamma();
+
+    /*---------------------------------------------------------------------
+     *  Load held-out set
+     *---------------------------------------------------------------------*/
+    std::vector<svt::BasicFV> testVectors;
+    std::ifstream testFile(testFileName.value().c_str());
+    if (!testFile.good())
+    {
+      std::cerr << "Could not open '" << testFileName.value() << "'"
+                << std::endl;
+      exit(-2);
+    }
+    std::string line;
+    while (std::getline(testFile, line))
+    {
+      if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+      std::istringstream lineStream(line);
+      svt::BasicFV fv;
+      lineStream >> fv;
+      testVectors.push_back(fv);
+    }
+    if (testVectors.size() == 0)
+    {
+      std::cerr << "'" << testFileName.value() << "' contains no feature "
+                << "vectors" << std::endl;
+      exit(-2);
+    }
+    if (normalize.given())
+    {
+      iRoCS::Features features(blitz::TinyVector<double,3>(1.0), &pr);
+      features.loadNormalizationParameters(inFileName.value());
+      features.normalizeFeatures(testVectors);
+      if (pr.isAborted()) return -1;
+    }
+
+    /*---------------------------------------------------------------------
+     *  Measure accuracy-versus-speed curve
+     *---------------------------------------------------------------------*/
+    std::vector<double> exactDecisionValues, decisionValues;
+    svt::BatchedRBFDecision<double> exactDecision(model, gamma);
+    Evaluation exact;
+    try
+    {
+      exact = evaluate(
+          exactDecision, testVectors, std::vector<double>(),
+          exactDecisionValues);
+    }
+    catch (svt::SVMError &e)
+    {
+      std::cerr << "Could not classify the held-out vectors: " << e.what()
+                << std::endl;
+      exit(-2);
+    }
+
+    svt::RBFModelReducer<svt::BasicFV> reducer(model, gamma);
+    std::vector<int> curveSizes;
+    std::vector<double> curveAccuracy, curveAgreement, curveSeconds;
+
+    std::cout << std::endl << "Held-out vectors: " << testVectors.size()
+              << ", support vectors: " << model.size() << std::endl
+              << std::setw(10) << "size" << std::setw(12) << "accuracy"
+              << std::setw(12) << "agreement" << std::setw(14) << "mean |d f|"
+              << std::setw(14) << "us/vector" << std::setw(10) << "speedup"
+              << std::endl
+              << std::setw(10) << "exact" << std::setw(12) << exact.accuracy
+              << std::setw(12) << 1.0 << std::setw(14) << 0.0
+              << std::setw(14) << 1.0e6 * exact.secondsPerVector
+              << std::setw(10) << 1.0 << std::endl;
+
+    size_t selected = sizeList.size() - 1;
+    bool found = false;
+    for (size_t i = 0; i < sizeList.size(); ++i)
+    {
+      svt::Model<svt::BasicFV> reduced;
+      svt::RandomFourierRBFModel randomFeatureModel;
+      approximate(method.value(), sizeList[i], gamma, model, reducer,
+                  reduced, randomFeatureModel);
+
+      Evaluation eval;
+      if (method.value() == "random_fourier_features")
+      {
+        curveSizes.push_back(
+            static_cast<int>(randomFeatureModel.nFeatures()));
+        eval = evaluate(randomFeatureModel, testVectors,
+                        exactDecisionValues, decisionValues);
+      }
+      else
+      {
+        curveSizes.push_back(static_cast<int>(reduced.size()));
+        svt::BatchedRBFDecision<double> decision(reduced, gamma);
+        eval = evaluate(decision, testVectors, exactDecisionValues,
+                        decisionValues);
+      }
+      curveAccuracy.push_back(eval.accuracy);
+      curveAgreement.push_back(eval.agreement);
+      curveSeconds.push_back(eval.secondsPerVector);
+
+      std::cout << std::setw(10) << curveSizes.back()
+                << std::setw(12) << eval.accuracy
+                << std::setw(12) << eval.agreement
+                << std::setw(14) << eval.meanAbsDifference
+                << std::setw(14) << 1.0e6 * eval.secondsPerVector
+                << std::setw(10)
+                << exact.secondsPerVector / eval.secondsPerVector
+                << std::endl;
+      if (!found && eval.agreement >= minAgreement.value())
+      {
+        selected = i;
+        found = true;
+      }
+    }
+    if (!found)
+        std::cout << "No size reaches an agreement of "
+                  << minAgreement.value() << ", storing the largest one"
+                  << std::endl;
+
+    /*---------------------------------------------------------------------
+     *  Save compressed model
+     *---------------------------------------------------------------------*/
+    pr.updateProgressMessage("Saving '" + outFileName.value() + "'");
+    {
+      std::ifstream in(inFileName.value().c_str(), std::ios::binary);
+      std::ofstream out(outFileName.value().c_str(), std::ios::binary);
+      out << in.rdbuf();
+      if (!out.good())
+      {
+        std::cerr << "Could not copy '" << inFileName.value() << "' to '"
+                  << outFileName.value() << "'" << std::endl;
+        exit(-2);
+      }
+    }
+    try
+    {
+      // The approximations are deterministic, so the selected one is
+      // recomputed instead of keeping all of them in memory
+      svt::Model<svt::BasicFV> reduced;
+      svt::RandomFourierRBFModel randomFeatureModel;
+      approximate(method.value(), sizeList[selected], gamma, model, reducer,
+                  reduced, randomFeatureModel);
+
+      svt::StDataHdf5 modelMap(outFileName.value().c_str(), H5F_ACC_RDWR);
+      modelMap.setExceptionFlag(true);
+      if (method.value() == "random_fourier_features")
+          randomFeatureModel.saveParameters(modelMap, "approx_");
+      else
+      {
+        modelMap.setValue("approx_model_type", method.value());
+        reduced.saveParameters(modelMap, "approx_");
+      }
+      modelMap.setArray(
+          "approx_curve_sizes", curveSizes.begin(), curveSizes.size());
+      modelMap.setArray(
+          "approx_curve_accuracy", curveAccuracy.begin(),
+          curveAccuracy.size());
+      modelMap.setArray(
+          "approx_curve_agreement", curveAgreement.begin(),
+          curveAgreement.size());
+      modelMap.setArray(
+          "approx_curve_seconds_per_vector", curveSeconds.begin(),
+          curveSeconds.size());
+      std::cout << "Stored " << method.value() << " approximation of size "
+                << curveSizes[selected] << " in '" << outFileName.value()
+                << "'" << std::endl;
+    }
+    catch (std::exception &e)
+    {
+      std::cerr << "Could not save compressed model to '"
+                << outFileName.value() << "': " << e.what() << std::endl;
+      exit(-2);
+    }
+  }
+  catch (CmdLineUsageError &e)
+  {
+    cmd.usage();
+    exit(-1);
+  }
+  catch (CmdLineVersionError e)
+  {
+    std::cout << PACKAGE_STRING << std::endl;
+    exit(0);
+  }
+  catch (CmdLineLicenseError e)
+  {
+    std::cout << PACKAGE_STRING << std::endl << std::endl
+              << "URL: " << PACKAGE_URL << std::endl << std::endl
+              << "Copyright (C) 2012-2015 Thorsten Falk ("
+              << PACKAGE_BUGREPORT << ")" << std::endl << std::endl
+              << "Address:" << std::endl
+              << "   Image Analysis Lab" << std::endl
+              << "   Albert-Ludwigs-Universitaet" << std::endl
+              << "   Georges-Koehler-Allee Geb. 52" << std::endl
+              << "   79110 Freiburg" << std::endl
+              << "   Germany" << std::endl << std::endl
+              << "This program is free software: you can redistribute it and/or"
+              << std::endl
+              << "modify it under the terms of the GNU General Public License"
+              << std::endl
+              << "Version 3 as published by the Free Software Foundation."
+              << std::endl << std::endl
+              << "This program is distributed in the hope that it will be "
+              << "useful," << std::endl
+              << "but WITHOUT ANY WARRANTY; without even the implied warranty "
+              << "of " << std::endl
+              << "MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the "
+              << std::endl
+              << "GNU General Public License for more details."
+              << std::endl << std::endl
+              << "You should have received a copy of the GNU General Public "
+              << "License" << std::endl
+              << "along with this program. If not, see " << std::endl
+              << "<http://www.gnu.org/licenses/>." << std::endl;
+    exit(0);
+  }
+  catch (CmdLineUsageHTMLError &e)
+  {
+    cmd.usageHTML(std::cout);
+    exit(-1);
+  }
+  catch (CmdLineUsageXMLError &e)
+  {
+    cmd.usageXML(std::cout);
+    exit(-1);
+  }
+  catch (CmdLineSyntaxError &e)
+  {
+    cmd.error() << e.str() << std::endl;
+    cmd.usage(std::cerr);
+    exit(-2);
+  }    
+}
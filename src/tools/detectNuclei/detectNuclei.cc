@@ -71,6 +71,12 @@ int main(int argc, char **argv)
       0, "memoryLimit", "[0-9]+[kKmMgG]*", "If given, the RAM used to store "
       "the feature vectors is restricted to the given amount. This leads to "
       "chunked classification and feature recomputation for each chunk.");
+  CmdArgSwitch nonMaximumSuppression(
+      0, "nonMaximumSuppression", "Extract the nucleus candidates with a "
+      "3x3x3 block non-maximum suppression that removes maxima closer than "
+      "3um to a stronger one during extraction, instead of 6-neighborhood "
+      "local maxima with subsequent overlap removal. This is faster, but "
+      "can yield slightly different candidates.");
 
   CmdLine cmd(argv[0], "Nucleus detector");
   cmd.description("Detect cell nuclei in an hdf5 dataset of an Arabidopsis "
@@ -88,6 +94,7 @@ int main(int argc, char **argv)
     cmd.append(&modelFileName);
     cmd.append(&outFileName);
     cmd.append(&memoryLimit);
+    cmd.append(&nonMaximumSuppression);
     
     ArgvIter argvIter(--argc, ++argv);
     cmd.parse(argvIter);
@@ -150,7 +157,8 @@ int main(int argc, char **argv)
      *  Run detector
      *---------------------------------------------------------------------*/
     iRoCS::detectNuclei(
-        data, nuclei, modelFileName.value(), mem, cacheFileName.value(), &pr);
+        data, nuclei, modelFileName.value(), mem, cacheFileName.value(),
+        nonMaximumSuppression.given(), &pr);
     if (pr.isAborted()) return -1;
     
     /*---------------------------------------------------------------------
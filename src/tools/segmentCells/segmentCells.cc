@@ -116,6 +116,13 @@ int main(int argc, char *argv[])
   CmdArgType<int> nDiffusionIterations(
       0, "nDiffusionIterations", "<int>", "Number of diffusion iterations");
   nDiffusionIterations.setDefaultValue(10);
+  CmdArgType<double> diffusionMemoryLimitGB(
+      0, "diffusionMemoryLimitGB", "<double>", "If the diffusion would "
+      "need more working memory than this (in GB), it switches to single "
+      "precision and recomputes the diffusion tensors slab-wise. The result "
+      "then differs by single precision rounding errors. Values <= 0 "
+      "disable the low memory mode.");
+  diffusionMemoryLimitGB.setDefaultValue(0.0);
 
   //watershed
   CmdArgType<float> hessianSigmaUm(
@@ -140,6 +147,13 @@ int main(int argc, char *argv[])
       'c', "minimumCellVolumeUm3", "<float>", "specify the minimum volume "
       "acceptable as a cell (in um^3)");
   minimumVolumeUm3.setDefaultValue(60);
+  CmdArgType<int> watershedLevels(
+      0, "watershedLevels", "<int>", "Quantize the edge map to this number "
+      "of flooding levels and use the faster tiled parallel bucket queue "
+      "watershed. Values <= 0 use the exact priority queue watershed. The "
+      "quantization and the tile borders can shift segment boundaries "
+      "slightly.");
+  watershedLevels.setDefaultValue(0);
 
   CmdLine cmd(
       argv[0], "Apply a watershed segmentation to extract the cells in the "
@@ -171,11 +185,13 @@ int main(int argc, char *argv[])
     cmd.append(&tau);
     cmd.append(&zCompensationFactor);
     cmd.append(&nDiffusionIterations);
+    cmd.append(&diffusionMemoryLimitGB);
 
     cmd.append(&hessianSigmaUm);
     cmd.append(&edgeThreshold);
     cmd.append(&boundaryThicknessPx);
     cmd.append(&minimumVolumeUm3);
+    cmd.append(&watershedLevels);
 
     cmd.description("apply segmentation on data");
 
@@ -223,6 +239,8 @@ int main(int argc, char *argv[])
               << std::endl;
     std::cout << "nDiffusionIterations = " << nDiffusionIterations.value()
               << std::endl;
+    std::cout << "diffusionMemoryLimitGB = " << diffusionMemoryLimitGB.value()
+              << " GB" << std::endl;
 
     std::cout << "hessianSigmaUm = " << hessianSigmaUm.value() << " um"
               << std::endl;
@@ -231,6 +249,7 @@ int main(int argc, char *argv[])
               << " px" << std::endl;
     std::cout << "minimumVolumeUm3 = " << minimumVolumeUm3.value()
               << " um^3" << std::endl;
+    std::cout << "watershedLevels = " << watershedLevels.value() << std::endl;
 
     iRoCS::ProgressReporterStream pr(std::cout, 0, 0, 100, "\r   ");
     pr.setTaskProgressMin(0);
@@ -261,7 +280,8 @@ int main(int argc, char *argv[])
         applyDiffusion.given(), nDiffusionIterations.value(),
         zCompensationFactor.value(), kappa.value(), tau.value(),
         edgeThreshold.value(), minimumVolumeUm3.value(),
-        boundaryThicknessPx.value(), debugFile, &pr);
+        boundaryThicknessPx.value(), diffusionMemoryLimitGB.value(),
+        watershedLevels.value(), debugFile, &pr);
 
     pr.updateProgressMessage(
         "Saving segmentation result to '" + ofName + ":" +
@@ -300,6 +320,9 @@ int main(int argc, char *argv[])
       outFile.writeAttribute(tau.value(), "tau", markerGroup);
       outFile.writeAttribute(
           nDiffusionIterations.value(), "nDiffusionIterations", markerGroup);
+      outFile.writeAttribute(
+          diffusionMemoryLimitGB.value(), "diffusionMemoryLimitGB",
+          markerGroup);
       outFile.writeAttribute(
           hessianSigmaUm.value(), "hessianSigmaUm", markerGroup);
       outFile.writeAttribute(
@@ -310,6 +333,8 @@ int main(int argc, char *argv[])
           minimumVolumeUm3.value(), "minimumVolumeUm3", markerGroup);
       outFile.writeAttribute(
           boundaryThicknessPx.value(), "boundaryThicknessPx", markerGroup);
+      outFile.writeAttribute(
+          watershedLevels.value(), "watershedLevels", markerGroup);
     }
     catch (BlitzH5Error& e)
     {
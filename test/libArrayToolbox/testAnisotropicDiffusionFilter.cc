@@ -0,0 +1,92 @@
+#include "lmbunit.hh"
+
+#include <cmath>
+
+#include <libArrayToolbox/TypeTraits.hh>
+#include <libArrayToolbox/AnisotropicDiffusionFilter.hh>
+
+// Bright random spheres on a noisy background, values within [0, 1]
+static void fillRandomStructure(blitz::Array<double,3> &data)
+{
+  data = 0.0;
+  for (int s = 0; s < 8; ++s)
+  {
+    blitz::TinyVector<double,3> center;
+    for (int d = 0; d < 3; ++d)
+        center(d) = data.extent(d) * static_cast<double>(std::rand()) /
+            static_cast<double>(RAND_MAX);
+    double radius = 2.0 + 4.0 * static_cast<double>(std::rand()) /
+        static_cast<double>(RAND_MAX);
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+      blitz::TinyVector<double,3> pos;
+      size_t tmp = i;
+      for (int d = 2; d >= 0; --d)
+      {
+        pos(d) = static_cast<double>(tmp % data.extent(d));
+        tmp /= data.extent(d);
+      }
+      if (std::sqrt(blitz::dot(pos - center, pos - center)) <= radius)
+          data.dataFirst()[i] = 0.7;
+    }
+  }
+  for (size_t i = 0; i < data.size(); ++i)
+      data.dataFirst()[i] += 0.3 * static_cast<double>(std::rand()) /
+          static_cast<double>(RAND_MAX);
+}
+
+static void testLowMemoryMatchesDefaultMode(
+    int nIterations, int hessianUpdateStepWidth)
+{
+  // More slices than one slab to cover the slab borders and a partial
+  // last slab
+  blitz::Array<double,3> data(37, 21, 18);
+  fillRandomStructure(data);
+  blitz::TinyVector<double,3> elementSizeUm(1.5, 1.0, 1.0);
+
+  atb::AnisotropicDiffusionFilter<double,3> filter(
+      0.5, 1.0, 0.0625, 1.0, nIterations, hessianUpdateStepWidth,
+      atb::RepeatBT);
+  LMBUNIT_ASSERT(!filter.lowMemory());
+  blitz::Array<double,3> expected;
+  filter.apply(data, elementSizeUm, expected);
+  size_t defaultMemory = filter.peakMemoryBytes(data.shape());
+
+  filter.setLowMemory(true);
+  LMBUNIT_ASSERT(filter.lowMemory());
+  blitz::Array<double,3> result;
+  filter.apply(data, elementSizeUm, result);
+  LMBUNIT_ASSERT(blitz::all(result.shape() == data.shape()));
+  LMBUNIT_ASSERT(filter.peakMemoryBytes(data.shape()) < defaultMemory);
+
+  // The working volumes are single precision, the differences must stay
+  // at the level of accumulated float rounding errors
+  double maxDiff = 0.0, sumDiff = 0.0;
+  for (size_t i = 0; i < data.size(); ++i)
+  {
+    double diff = std::abs(result.dataFirst()[i] - expected.dataFirst()[i]);
+    maxDiff = std::max(maxDiff, diff);
+    sumDiff += diff;
+  }
+  LMBUNIT_ASSERT(maxDiff < 1e-3);
+  LMBUNIT_ASSERT(sumDiff / data.size() < 1e-5);
+
+  // The filter must actually have changed the data
+  LMBUNIT_ASSERT(blitz::max(blitz::abs(expected - data)) > 1e-2);
+
+  // In-place filtering must give the same result
+  filter.apply(data, elementSizeUm, data);
+  LMBUNIT_ASSERT(blitz::all(data == result));
+}
+
+int main(int, char**)
+{
+  LMBUNIT_WRITE_HEADER();
+
+  LMBUNIT_RUN_TEST(testLowMemoryMatchesDefaultMode(8, 4));
+  LMBUNIT_RUN_TEST(testLowMemoryMatchesDefaultMode(5, 2));
+  LMBUNIT_RUN_TEST(testLowMemoryMatchesDefaultMode(3, 1));
+
+  LMBUNIT_WRITE_STATISTICS();
+  return _nFails;
+}
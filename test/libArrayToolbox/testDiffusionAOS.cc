@@ -0,0 +1,237 @@
+#include "lmbunit.hh"
+
+#include <cmath>
+#include <vector>
+
+#include <libArrayToolbox/algo/ldiffusion.hh>
+
+static double randomValue(double minValue, double maxValue)
+{
+  return minValue + (maxValue - minValue) *
+      static_cast<double>(std::rand()) / static_cast<double>(RAND_MAX);
+}
+
+template<typename DataT>
+static void fillRandom(
+    blitz::Array<DataT,3> &data, double minValue, double maxValue)
+{
+  for (size_t i = 0; i < data.size(); ++i)
+      data.dataFirst()[i] = static_cast<DataT>(randomValue(minValue, maxValue));
+}
+
+// The batched and scalar solvers perform the same operations per line, the
+// results may only differ by contracted multiply-adds in the vectorized
+// loops
+static void testBatchedThomasMatchesScalar(unsigned long N, int nBatch)
+{
+  // Diagonally dominant systems, lines stored interleaved
+  std::vector<double> alpha(N * nBatch), beta(N * nBatch, 0.0),
+      gamma(N * nBatch, 0.0), d(N * nBatch);
+  for (unsigned long i = 0; i < N * nBatch; ++i)
+  {
+    alpha[i] = randomValue(2.0, 3.0);
+    if (i < (N - 1) * nBatch)
+    {
+      beta[i] = randomValue(-0.5, 0.5);
+      gamma[i] = randomValue(-0.5, 0.5);
+    }
+    d[i] = randomValue(-1.0, 1.0);
+  }
+
+  std::vector<double> l(N * nBatch), m(N * nBatch), r(N * nBatch),
+      y(N * nBatch);
+  tridiagonal_Thomas_decomposition_batch(
+      &alpha[0], &beta[0], &gamma[0], &l[0], &m[0], &r[0], N, nBatch);
+  tridiagonal_Thomas_solution_batch(
+      &l[0], &m[0], &r[0], &d[0], &y[0], N, nBatch);
+
+  // The solution may overwrite the right hand side
+  std::vector<double> yInPlace(d);
+  tridiagonal_Thomas_solution_batch(
+      &l[0], &m[0], &r[0], &yInPlace[0], &yInPlace[0], N, nBatch);
+
+  for (int b = 0; b < nBatch; ++b)
+  {
+    std::vector<double> alphaL(N), betaL(N), gammaL(N), dL(N);
+    for (unsigned long i = 0; i < N; ++i)
+    {
+      alphaL[i] = alpha[i * nBatch + b];
+      betaL[i] = beta[i * nBatch + b];
+      gammaL[i] = gamma[i * nBatch + b];
+      dL[i] = d[i * nBatch + b];
+    }
+    std::vector<double> lL(N), mL(N), rL(N), yL(N);
+    if (N == 1) yL[0] = dL[0] / alphaL[0];
+    else
+    {
+      tridiagonal_Thomas_decomposition(
+          &alphaL[0], &betaL[0], &gammaL[0], &lL[0], &mL[0], &rL[0], N);
+      tridiagonal_Thomas_solution(&lL[0], &mL[0], &rL[0], &dL[0], &yL[0], N);
+    }
+    for (unsigned long i = 0; i < N; ++i)
+    {
+      LMBUNIT_ASSERT_EQUAL_DELTA(y[i * nBatch + b], yL[i], 1e-12);
+      LMBUNIT_ASSERT_EQUAL(yInPlace[i * nBatch + b], y[i * nBatch + b]);
+    }
+  }
+}
+
+static void testBatchedAOSCoefficientsMatchScalar(
+    unsigned long len, int nBatch)
+{
+  double const deltaT = 0.8;
+  std::vector<double> p(len * nBatch);
+  for (unsigned long i = 0; i < len * nBatch; ++i)
+      p[i] = randomValue(0.0, 1.0);
+
+  std::vector<double> alpha(len * nBatch), beta(len * nBatch),
+      gamma(len * nBatch), L(len * nBatch), M(len * nBatch),
+      R(len * nBatch);
+  get1DAOS_batch(
+      &p[0], deltaT, len, 3, nBatch, &alpha[0], &beta[0], &gamma[0], &L[0],
+      &M[0], &R[0]);
+
+  for (int b = 0; b < nBatch; ++b)
+  {
+    blitz::Array<double,1> pL(len);
+    for (unsigned long i = 0; i < len; ++i) pL(i) = p[i * nBatch + b];
+    std::vector<double> alphaL(len), betaL(len), gammaL(len), LL(len),
+        ML(len), RL(len);
+    get1DAOS_blitz(
+        pL, deltaT, len, 3, &alphaL[0], &betaL[0], &gammaL[0], &LL[0],
+        &ML[0], &RL[0]);
+    for (unsigned long i = 0; i < len; ++i)
+    {
+      LMBUNIT_ASSERT_EQUAL_DELTA(M[i * nBatch + b], ML[i], 1e-12);
+      if (i + 1 < len)
+      {
+        LMBUNIT_ASSERT_EQUAL_DELTA(L[i * nBatch + b], LL[i], 1e-12);
+        LMBUNIT_ASSERT_EQUAL_DELTA(R[i * nBatch + b], RL[i], 1e-12);
+      }
+    }
+  }
+}
+
+// Solves one line with the scalar functions. The scalar coefficient setup
+// needs at least two samples, a single sample line reduces to u / m.
+template<typename DataT>
+static void scalarAOSLine(
+    blitz::Array<DataT,1> u, blitz::Array<DataT,1> g,
+    blitz::Array<DataT,1> uNew, double deltaT, bool accumulate)
+{
+  int len = u.extent(0);
+  std::vector<double> out(len);
+  if (len == 1) out[0] = static_cast<double>(u(0)) / 3.0;
+  else
+  {
+    std::vector<double> alpha(len), beta(len), gamma(len), L(len), M(len),
+        R(len);
+    get1DAOS_blitz(
+        g, deltaT, len, 3, &alpha[0], &beta[0], &gamma[0], &L[0], &M[0],
+        &R[0]);
+    tridiagonal_Thomas_solution_blitz(&L[0], &M[0], &R[0], u, &out[0], len);
+  }
+  for (int i = 0; i < len; ++i)
+  {
+    if (accumulate) uNew(i) += out[i];
+    else uNew(i) = out[i];
+  }
+}
+
+// The previous line by line AOS step
+template<typename DataT>
+static void scalarAOS3D(
+    blitz::Array<DataT,3> &u, blitz::Array<DataT,3> &g,
+    blitz::Array<DataT,3> &uNew, double deltaT)
+{
+  blitz::Range all = blitz::Range::all();
+  for (int j = 0; j < u.extent(1); ++j)
+      for (int k = 0; k < u.extent(2); ++k)
+          scalarAOSLine<DataT>(
+              u(all, j, k), g(all, j, k), uNew(all, j, k), deltaT, false);
+  for (int j = 0; j < u.extent(0); ++j)
+      for (int k = 0; k < u.extent(2); ++k)
+          scalarAOSLine<DataT>(
+              u(j, all, k), g(j, all, k), uNew(j, all, k), deltaT, true);
+  for (int j = 0; j < u.extent(0); ++j)
+      for (int k = 0; k < u.extent(1); ++k)
+          scalarAOSLine<DataT>(
+              u(j, k, all), g(j, k, all), uNew(j, k, all), deltaT, true);
+}
+
+template<typename DataT>
+static void testBatchedAOS3DMatchesScalar(
+    int extent0, int extent1, int extent2, double tolerance)
+{
+  // Extents that are no multiples of the batch size give partial batches
+  double const deltaT = 1.0;
+  blitz::Array<DataT,3> u(extent0, extent1, extent2);
+  fillRandom(u, 0.0, 1.0);
+  blitz::Array<DataT,3> g(u.shape());
+  fillRandom(g, 0.01, 1.0);
+
+  blitz::Array<DataT,3> expected(u.shape());
+  scalarAOS3D(u, g, expected, deltaT);
+
+  blitz::Array<DataT,3> result(u.shape());
+  result = -1;
+  AOS_3D_blitz(u, g, result, deltaT);
+
+  for (size_t i = 0; i < u.size(); ++i)
+      LMBUNIT_ASSERT_EQUAL_DELTA(
+          result.dataFirst()[i], expected.dataFirst()[i], tolerance);
+
+  // The step must actually have smoothed the data
+  LMBUNIT_ASSERT(blitz::max(blitz::abs(result - u)) > 1e-3);
+}
+
+// u, g and u_new with different memory layouts: g is stored transposed and
+// u_new is a view with reversed first dimension
+static void testBatchedAOS3DWithMixedLayouts()
+{
+  double const deltaT = 1.0;
+  blitz::Array<double,3> u(9, 10, 11);
+  fillRandom(u, 0.0, 1.0);
+  blitz::Array<double,3> gStorage(11, 10, 9);
+  fillRandom(gStorage, 0.01, 1.0);
+  blitz::Array<double,3> g(gStorage.transpose(2, 1, 0));
+
+  blitz::Array<double,3> expected(u.shape());
+  scalarAOS3D(u, g, expected, deltaT);
+
+  blitz::Array<double,3> resultStorage(u.shape());
+  resultStorage = -1;
+  blitz::Range all = blitz::Range::all();
+  blitz::Array<double,3> result(
+      resultStorage(blitz::Range(u.extent(0) - 1, 0, -1), all, all));
+  AOS_3D_blitz(u, g, result, deltaT);
+
+  LMBUNIT_ASSERT(blitz::all(blitz::abs(result - expected) < 1e-12));
+}
+
+int main(int, char**)
+{
+  LMBUNIT_WRITE_HEADER();
+
+  unsigned long N[] = { 1, 2, 3, 17 };
+  int nBatch[] = { 1, 3, AOS_BATCH_SIZE };
+  for (int i = 0; i < 4; ++i)
+  {
+    for (int j = 0; j < 3; ++j)
+    {
+      LMBUNIT_RUN_TEST(testBatchedThomasMatchesScalar(N[i], nBatch[j]));
+      if (N[i] > 1)
+          LMBUNIT_RUN_TEST(
+              testBatchedAOSCoefficientsMatchScalar(N[i], nBatch[j]));
+    }
+  }
+
+  LMBUNIT_RUN_TEST((testBatchedAOS3DMatchesScalar<double>(13, 11, 19, 1e-12)));
+  LMBUNIT_RUN_TEST((testBatchedAOS3DMatchesScalar<double>(5, 16, 8, 1e-12)));
+  LMBUNIT_RUN_TEST((testBatchedAOS3DMatchesScalar<double>(1, 9, 7, 1e-12)));
+  LMBUNIT_RUN_TEST((testBatchedAOS3DMatchesScalar<float>(7, 10, 21, 1e-5)));
+  LMBUNIT_RUN_TEST(testBatchedAOS3DWithMixedLayouts());
+
+  LMBUNIT_WRITE_STATISTICS();
+  return _nFails;
+}
@@ -0,0 +1,182 @@
+#include "lmbunit.hh"
+
+#include <vector>
+
+#include <libArrayToolbox/TypeTraits.hh>
+#include <libArrayToolbox/FastCorrelationBank.hh>
+#include <libArrayToolbox/FastNormalizedCorrelationFilter.hh>
+#include <libArrayToolbox/FastPhaseOnlyCorrelationFilter.hh>
+
+template<typename DataT, int Dim>
+static void fillRandom(blitz::Array<DataT,Dim> &array)
+{
+  for (size_t i = 0; i < array.size(); ++i)
+      array.dataFirst()[i] = static_cast<DataT>(
+          static_cast<double>(std::rand()) / static_cast<double>(RAND_MAX));
+}
+
+template<typename DataT>
+static void testBankMatchesNormalizedCorrelationFilter(
+    atb::BoundaryTreatmentType btType)
+{
+  blitz::Array<DataT,3> data(11, 16, 13);
+  fillRandom(data);
+  blitz::TinyVector<atb::BlitzIndexT,3> maxKernelShape(5, 6, 5);
+  blitz::TinyVector<double,3> elSize(1.0);
+
+  std::vector< blitz::Array<DataT,3> > kernels;
+  kernels.push_back(blitz::Array<DataT,3>(3, 3, 3));
+  kernels.push_back(blitz::Array<DataT,3>(5, 4, 3));
+  kernels.push_back(blitz::Array<DataT,3>(5, 6, 5));
+  for (size_t k = 0; k < kernels.size(); ++k) fillRandom(kernels[k]);
+
+  atb::FastCorrelationBank<DataT,3> bank(
+      atb::FastCorrelationBank<DataT,3>::NormalizedCorrelation, btType);
+  bank.setData(data, maxKernelShape);
+
+  std::vector< blitz::Array<DataT,3> > expected(kernels.size());
+  blitz::Array<DataT,3> result;
+  for (size_t k = 0; k < kernels.size(); ++k)
+  {
+    atb::FastNormalizedCorrelationFilter<DataT,3> filter(kernels[k], btType);
+    filter.apply(data, elSize, expected[k]);
+    bank.correlate(kernels[k], result);
+    LMBUNIT_ASSERT(blitz::all(result.shape() == data.shape()));
+    for (size_t i = 0; i < data.size(); ++i)
+        LMBUNIT_ASSERT_EQUAL_DELTA(
+            result.dataFirst()[i], expected[k].dataFirst()[i], 1e-3);
+  }
+
+  blitz::Array<DataT,3> response;
+  blitz::Array<int,3> bestTemplate;
+  bank.correlateMaximum(kernels, response, bestTemplate);
+  for (size_t i = 0; i < data.size(); ++i)
+  {
+    int best = bestTemplate.dataFirst()[i];
+    LMBUNIT_ASSERT(best >= 0 && best < static_cast<int>(kernels.size()));
+    for (size_t k = 0; k < kernels.size(); ++k)
+        LMBUNIT_ASSERT(
+            expected[k].dataFirst()[i] <=
+            expected[best].dataFirst()[i] + 1e-3);
+    LMBUNIT_ASSERT_EQUAL_DELTA(
+        response.dataFirst()[i], expected[best].dataFirst()[i], 1e-3);
+  }
+}
+
+template<typename DataT>
+static void testBankMatchesPhaseOnlyCorrelationFilter(
+    atb::BoundaryTreatmentType btType)
+{
+  blitz::Array<DataT,3> data(12, 15, 9);
+  fillRandom(data);
+  blitz::Array<DataT,3> kernel(4, 5, 3);
+  fillRandom(kernel);
+  blitz::TinyVector<double,3> elSize(1.0);
+
+  atb::FastPhaseOnlyCorrelationFilter<DataT,3> filter(kernel, btType);
+  blitz::Array<DataT,3> expected;
+  filter.apply(data, elSize, expected);
+
+  atb::FastCorrelationBank<DataT,3> bank(
+      atb::FastCorrelationBank<DataT,3>::PhaseOnlyCorrelation, btType);
+  bank.setData(data, kernel.shape());
+  blitz::Array<DataT,3> result;
+  bank.correlate(kernel, result);
+  for (size_t i = 0; i < data.size(); ++i)
+      LMBUNIT_ASSERT_EQUAL_DELTA(
+          result.dataFirst()[i], expected.dataFirst()[i], 1e-3);
+}
+
+// A reversed and strided view of the data must give the same responses as
+// a contiguous copy
+static void testBankHandlesStridedData()
+{
+  blitz::Array<double,3> full(22, 16, 13);
+  fillRandom(full);
+  blitz::Array<double,3> view(
+      full(blitz::Range(20, 0, -2), blitz::Range::all(),
+           blitz::Range(12, 0, -1)));
+  blitz::Array<double,3> copy(view.shape());
+  copy = view;
+  blitz::Array<double,3> kernel(3, 5, 3);
+  fillRandom(kernel);
+
+  atb::FastCorrelationBank<double,3> viewBank(
+      atb::FastCorrelationBank<double,3>::NormalizedCorrelation,
+      atb::MirrorBT);
+  viewBank.setData(view, kernel.shape());
+  atb::FastCorrelationBank<double,3> copyBank(
+      atb::FastCorrelationBank<double,3>::NormalizedCorrelation,
+      atb::MirrorBT);
+  copyBank.setData(copy, kernel.shape());
+
+  blitz::Array<double,3> result, expected;
+  viewBank.correlate(kernel, result);
+  copyBank.correlate(kernel, expected);
+  LMBUNIT_ASSERT(blitz::all(result.shape() == copy.shape()));
+  LMBUNIT_ASSERT(blitz::all(blitz::abs(result - expected) < 1e-10));
+}
+
+static bool correlateThrows(
+    atb::FastCorrelationBank<double,2> &bank,
+    blitz::Array<double,2> const &kernel)
+{
+  blitz::Array<double,2> result;
+  try
+  {
+    bank.correlate(kernel, result);
+  }
+  catch (atb::RuntimeError &)
+  {
+    return true;
+  }
+  return false;
+}
+
+static void testBankRejectsInvalidInput()
+{
+  blitz::Array<double,2> data(10, 10);
+  fillRandom(data);
+  blitz::Array<double,2> kernel(5, 5);
+  fillRandom(kernel);
+
+  atb::FastCorrelationBank<double,2> cropBank(
+      atb::FastCorrelationBank<double,2>::NormalizedCorrelation, atb::CropBT);
+  bool thrown = false;
+  try
+  {
+    cropBank.setData(data, kernel.shape());
+  }
+  catch (atb::RuntimeError &)
+  {
+    thrown = true;
+  }
+  LMBUNIT_ASSERT(thrown);
+
+  atb::FastCorrelationBank<double,2> bank;
+  LMBUNIT_ASSERT(correlateThrows(bank, kernel));
+  bank.setData(data, blitz::TinyVector<atb::BlitzIndexT,2>(3, 5));
+  LMBUNIT_ASSERT(correlateThrows(bank, kernel));
+}
+
+int main(int, char**)
+{
+  LMBUNIT_WRITE_HEADER();
+
+  atb::BoundaryTreatmentType btTypes[] = {
+      atb::ValueBT, atb::CyclicBT, atb::RepeatBT, atb::MirrorBT };
+  for (int i = 0; i < 4; ++i)
+  {
+    LMBUNIT_RUN_TEST(
+        (testBankMatchesNormalizedCorrelationFilter<double>(btTypes[i])));
+    LMBUNIT_RUN_TEST(
+        (testBankMatchesNormalizedCorrelationFilter<float>(btTypes[i])));
+    LMBUNIT_RUN_TEST(
+        (testBankMatchesPhaseOnlyCorrelationFilter<double>(btTypes[i])));
+  }
+  LMBUNIT_RUN_TEST(testBankHandlesStridedData());
+  LMBUNIT_RUN_TEST(testBankRejectsInvalidInput());
+
+  LMBUNIT_WRITE_STATISTICS();
+  return _nFails;
+}
@@ -0,0 +1,222 @@
+#include "lmbunit.hh"
+
+#include <cmath>
+#include <limits>
+
+#include <libArrayToolbox/TypeTraits.hh>
+#include <libArrayToolbox/BoundaryTreatment.hh>
+#include <libArrayToolbox/GaussianFilter.hh>
+
+template<typename DataT>
+static void fillRandom(blitz::Array<DataT,2> &data)
+{
+  for (size_t i = 0; i < data.size(); ++i)
+      data.dataFirst()[i] = static_cast<DataT>(
+          static_cast<double>(std::rand()) / static_cast<double>(RAND_MAX));
+}
+
+// Compares the given filter result with the FIR result. The inputs are
+// within [0, 1], so the errors are absolute. Only elements at least
+// margin pixels away from the Array boundaries are checked. All filters
+// use 0.3 as boundary value for ValueBT.
+template<typename DataT>
+static void checkMatchesFIR(
+    blitz::Array<DataT,2> const &data,
+    blitz::TinyVector<double,2> const &elementSizeUm,
+    atb::GaussianFilter<DataT,2> const &filter,
+    blitz::Array<DataT,2> const &result,
+    blitz::TinyVector<atb::BlitzIndexT,2> const &margin, double tolerance)
+{
+  atb::GaussianFilter<DataT,2> firFilter(
+      filter.standardDeviationUm(), filter.minimumKernelShapePx(),
+      filter.boundaryTreatment().type(), static_cast<DataT>(0.3));
+  LMBUNIT_ASSERT_EQUAL(firFilter.implementation(), atb::FIRGaussian);
+  blitz::Array<DataT,2> expected;
+  firFilter.apply(data, elementSizeUm, expected);
+
+  LMBUNIT_ASSERT(blitz::all(result.shape() == data.shape()));
+  for (atb::BlitzIndexT y = margin(0); y < data.extent(0) - margin(0); ++y)
+      for (atb::BlitzIndexT x = margin(1); x < data.extent(1) - margin(1);
+           ++x)
+          LMBUNIT_ASSERT_EQUAL_DELTA(
+              result(y, x), expected(y, x), tolerance);
+}
+
+template<typename DataT>
+static void testFFTGaussianMatchesFIR(
+    atb::BoundaryTreatmentType btType, double tolerance)
+{
+  blitz::Array<DataT,2> data(23, 31);
+  fillRandom(data);
+  blitz::TinyVector<double,2> elementSizeUm(1.0, 0.5);
+
+  atb::GaussianFilter<DataT,2> filter(
+      blitz::TinyVector<double,2>(2.0, 1.5), atb::BlitzIndexT(0), btType,
+      static_cast<DataT>(0.3));
+  filter.setImplementation(atb::FFTGaussian);
+  blitz::TinyVector<atb::GaussianFilterImplementation,2> implementation(
+      filter.selectImplementation(data.shape(), elementSizeUm));
+  LMBUNIT_ASSERT_EQUAL(implementation(0), atb::FFTGaussian);
+  LMBUNIT_ASSERT_EQUAL(implementation(1), atb::FFTGaussian);
+
+  blitz::Array<DataT,2> result;
+  filter.apply(data, elementSizeUm, result);
+  checkMatchesFIR(
+      data, elementSizeUm, filter, result,
+      blitz::TinyVector<atb::BlitzIndexT,2>(0), tolerance);
+}
+
+template<typename DataT>
+static void testIIRGaussianMatchesFIR(atb::BoundaryTreatmentType btType)
+{
+  blitz::Array<DataT,2> data(70, 80);
+  fillRandom(data);
+  blitz::TinyVector<double,2> elementSizeUm(1.0, 0.5);
+  blitz::TinyVector<double,2> sigmaUm(4.0, 3.0);
+
+  atb::GaussianFilter<DataT,2> filter(
+      sigmaUm, atb::BlitzIndexT(0), btType, static_cast<DataT>(0.3));
+  filter.setImplementation(atb::IIRGaussian);
+  blitz::TinyVector<atb::GaussianFilterImplementation,2> implementation(
+      filter.selectImplementation(data.shape(), elementSizeUm));
+  LMBUNIT_ASSERT_EQUAL(implementation(0), atb::IIRGaussian);
+  LMBUNIT_ASSERT_EQUAL(implementation(1), atb::IIRGaussian);
+
+  blitz::Array<DataT,2> result;
+  filter.apply(data, elementSizeUm, result);
+
+  // The L1 distances of the 1-D impulse responses to the sampled Gaussian
+  // bound the difference, the boundary handling of the recursion is not
+  // covered by the bound
+  double tolerance = 1e-5;
+  blitz::TinyVector<atb::BlitzIndexT,2> margin;
+  for (int d = 0; d < 2; ++d)
+  {
+    tolerance += 1.1 * (
+        atb::GaussianFilter<DataT,2>::errorBound(
+            atb::IIRGaussian, sigmaUm(d), elementSizeUm(d)) +
+        atb::GaussianFilter<DataT,2>::errorBound(
+            atb::FIRGaussian, sigmaUm(d), elementSizeUm(d)));
+    margin(d) = static_cast<atb::BlitzIndexT>(
+        std::ceil(5.0 * sigmaUm(d) / elementSizeUm(d))) + 3;
+  }
+  LMBUNIT_ASSERT(tolerance < 0.2);
+  checkMatchesFIR(data, elementSizeUm, filter, result, margin, tolerance);
+
+  // In-place filtering must give the same result
+  blitz::Array<DataT,2> inPlace(data.shape());
+  inPlace = data;
+  filter.apply(inPlace, elementSizeUm, inPlace);
+  LMBUNIT_ASSERT(blitz::all(inPlace == result));
+}
+
+template<typename DataT>
+static void testAutoGaussianMatchesFIR(
+    atb::BoundaryTreatmentType btType, double sigmaUm0, double sigmaUm1)
+{
+  blitz::Array<DataT,2> data(90, 100);
+  fillRandom(data);
+  blitz::TinyVector<double,2> elementSizeUm(1.0, 1.0);
+  blitz::TinyVector<double,2> sigmaUm(sigmaUm0, sigmaUm1);
+
+  atb::GaussianFilter<DataT,2> filter(
+      sigmaUm, atb::BlitzIndexT(0), btType, static_cast<DataT>(0.3));
+  filter.setImplementation(atb::AutoGaussian);
+  blitz::TinyVector<atb::GaussianFilterImplementation,2> implementation(
+      filter.selectImplementation(data.shape(), elementSizeUm));
+  for (int d = 0; d < 2; ++d)
+  {
+    LMBUNIT_ASSERT(implementation(d) != atb::AutoGaussian);
+    if (btType == atb::CropBT || std::numeric_limits<DataT>::is_integer)
+        LMBUNIT_ASSERT_EQUAL(implementation(d), atb::FIRGaussian);
+  }
+  LMBUNIT_ASSERT(
+      (implementation(0) == atb::FFTGaussian) ==
+      (implementation(1) == atb::FFTGaussian));
+  double errorBound = filter.errorBound(data.shape(), elementSizeUm);
+  LMBUNIT_ASSERT(errorBound <= 2.0 * filter.maximumError());
+
+  blitz::Array<DataT,2> result;
+  filter.apply(data, elementSizeUm, result);
+
+  double tolerance = 1e-5 + 1.1 * errorBound;
+  blitz::TinyVector<atb::BlitzIndexT,2> margin;
+  for (int d = 0; d < 2; ++d)
+  {
+    tolerance += 1.1 * atb::GaussianFilter<DataT,2>::errorBound(
+        atb::FIRGaussian, sigmaUm(d), elementSizeUm(d));
+    margin(d) = static_cast<atb::BlitzIndexT>(
+        std::ceil(5.0 * sigmaUm(d) / elementSizeUm(d))) + 3;
+  }
+  checkMatchesFIR(data, elementSizeUm, filter, result, margin, tolerance);
+}
+
+// Integer data have no FFT implementation, FIR is used instead
+static void testFFTGaussianFallsBackForIntegerData()
+{
+  blitz::Array<unsigned char,2> data(40, 50);
+  for (size_t i = 0; i < data.size(); ++i)
+      data.dataFirst()[i] = static_cast<unsigned char>(std::rand() % 256);
+  blitz::TinyVector<double,2> elementSizeUm(1.0, 1.0);
+
+  atb::GaussianFilter<unsigned char,2> filter(
+      blitz::TinyVector<double,2>(3.0, 2.0), atb::BlitzIndexT(0),
+      atb::MirrorBT);
+  filter.setImplementation(atb::FFTGaussian);
+  blitz::TinyVector<atb::GaussianFilterImplementation,2> implementation(
+      filter.selectImplementation(data.shape(), elementSizeUm));
+  LMBUNIT_ASSERT_EQUAL(implementation(0), atb::FIRGaussian);
+  LMBUNIT_ASSERT_EQUAL(implementation(1), atb::FIRGaussian);
+
+  blitz::Array<unsigned char,2> result, expected;
+  filter.apply(data, elementSizeUm, result);
+  filter.setImplementation(atb::FIRGaussian);
+  filter.apply(data, elementSizeUm, expected);
+  LMBUNIT_ASSERT(blitz::all(result == expected));
+}
+
+static void testAutoGaussianCountsUnfilteredDimensions()
+{
+  // A small kernel along one dimension only is cheapest as FIR. The FFT
+  // still has to transform the whole Array including the unfiltered
+  // dimension.
+  atb::GaussianFilter<float,2> filter(
+      blitz::TinyVector<double,2>(0.0, 1.0));
+  filter.setImplementation(atb::AutoGaussian);
+  blitz::TinyVector<atb::GaussianFilterImplementation,2> implementation(
+      filter.selectImplementation(
+          blitz::TinyVector<atb::BlitzIndexT,2>(200, 200),
+          blitz::TinyVector<double,2>(1.0)));
+  LMBUNIT_ASSERT_EQUAL(implementation(0), atb::FIRGaussian);
+  LMBUNIT_ASSERT_EQUAL(implementation(1), atb::FIRGaussian);
+}
+
+int main(int, char**)
+{
+  LMBUNIT_WRITE_HEADER();
+
+  atb::BoundaryTreatmentType btTypes[] = {
+      atb::ValueBT, atb::CyclicBT, atb::RepeatBT, atb::MirrorBT };
+  for (int i = 0; i < 4; ++i)
+  {
+    LMBUNIT_RUN_TEST((testFFTGaussianMatchesFIR<float>(btTypes[i], 1e-4)));
+    LMBUNIT_RUN_TEST((testFFTGaussianMatchesFIR<double>(btTypes[i], 1e-10)));
+    LMBUNIT_RUN_TEST((testIIRGaussianMatchesFIR<float>(btTypes[i])));
+    LMBUNIT_RUN_TEST((testIIRGaussianMatchesFIR<double>(btTypes[i])));
+    LMBUNIT_RUN_TEST(
+        (testAutoGaussianMatchesFIR<double>(btTypes[i], 1.0, 1.0)));
+    LMBUNIT_RUN_TEST(
+        (testAutoGaussianMatchesFIR<double>(btTypes[i], 8.0, 0.0)));
+    LMBUNIT_RUN_TEST(
+        (testAutoGaussianMatchesFIR<float>(btTypes[i], 6.0, 10.0)));
+  }
+  LMBUNIT_RUN_TEST(
+      (testAutoGaussianMatchesFIR<double>(atb::CropBT, 6.0, 10.0)));
+  LMBUNIT_RUN_TEST(
+      (testAutoGaussianMatchesFIR<unsigned char>(atb::ValueBT, 6.0, 10.0)));
+  LMBUNIT_RUN_TEST(testAutoGaussianCountsUnfilteredDimensions());
+  LMBUNIT_RUN_TEST(testFFTGaussianFallsBackForIntegerData());
+
+  LMBUNIT_WRITE_STATISTICS();
+  return _nFails;
+}
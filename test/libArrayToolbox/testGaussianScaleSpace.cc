@@ -0,0 +1,127 @@
+#include "lmbunit.hh"
+
+#include <vector>
+
+#include <libArrayToolbox/Array.hh>
+#include <libArrayToolbox/GaussianFilter.hh>
+#include <libArrayToolbox/GaussianScaleSpace.hh>
+
+static void fillRandom(atb::Array<double,3> &data)
+{
+  for (size_t i = 0; i < data.size(); ++i)
+      data.dataFirst()[i] =
+          static_cast<double>(std::rand()) / static_cast<double>(RAND_MAX);
+}
+
+static void directSmoothing(
+    atb::Array<double,3> const &data, double sigmaUm,
+    atb::Array<double,3> &result)
+{
+  atb::GaussianFilter<double,3> filter(
+      blitz::TinyVector<double,3>(sigmaUm), atb::BlitzIndexT(0),
+      atb::CyclicBT);
+  filter.apply(data, data.elementSizeUm(), result);
+  result.setElementSizeUm(data.elementSizeUm());
+}
+
+// With cyclic boundary treatment the incremental and direct smoothing
+// only differ by the deviation of the cascaded sampled kernels from the
+// sampled Gaussian, which is below 2e-3 per dimension for the standard
+// deviations used here. The data are within [0, 1].
+static void testIncrementalLevelsMatchDirectSmoothing(
+    std::vector<double> const &sigmasUm, size_t maximumCachedLevels)
+{
+  atb::Array<double,3> data(
+      blitz::TinyVector<atb::BlitzIndexT,3>(19, 24, 27),
+      blitz::TinyVector<double,3>(1.0));
+  fillRandom(data);
+
+  atb::GaussianScaleSpace<double,3> scaleSpace(data, false, atb::CyclicBT);
+  scaleSpace.setMaximumCachedLevels(maximumCachedLevels);
+
+  std::vector< atb::Array<double,3> > levels;
+  for (size_t i = 0; i < sigmasUm.size(); ++i)
+  {
+    levels.push_back(scaleSpace.level(sigmasUm[i]));
+    LMBUNIT_ASSERT(blitz::all(levels[i].shape() == data.shape()));
+    LMBUNIT_ASSERT(
+        blitz::all(levels[i].elementSizeUm() == data.elementSizeUm()));
+  }
+
+  // The first level is computed from the data directly, the returned views
+  // must stay unchanged when levels are evicted
+  atb::Array<double,3> expected;
+  directSmoothing(data, sigmasUm[0], expected);
+  LMBUNIT_ASSERT(blitz::all(levels[0] == expected));
+  for (size_t i = 1; i < sigmasUm.size(); ++i)
+  {
+    directSmoothing(data, sigmasUm[i], expected);
+    LMBUNIT_ASSERT(blitz::max(blitz::abs(levels[i] - expected)) < 6e-3);
+  }
+
+  // A level below all cached levels is computed from the data directly,
+  // cached levels are returned unchanged
+  double sigmaUm = 0.5 * sigmasUm[0];
+  directSmoothing(data, sigmaUm, expected);
+  LMBUNIT_ASSERT(blitz::all(scaleSpace.level(sigmaUm) == expected));
+  atb::Array<double,3> last(scaleSpace.level(sigmasUm.back()));
+  LMBUNIT_ASSERT(blitz::all(last == levels.back()));
+}
+
+static void testDownsampledLevels()
+{
+  atb::Array<double,3> data(
+      blitz::TinyVector<atb::BlitzIndexT,3>(15, 24, 32),
+      blitz::TinyVector<double,3>(2.0, 1.0, 0.5));
+  fillRandom(data);
+
+  atb::GaussianScaleSpace<double,3> scaleSpace(data, true, atb::CyclicBT);
+
+  // sigma = 1.0 reaches two elements only along the last dimension
+  atb::Array<double,3> level(scaleSpace.level(1.0));
+  LMBUNIT_ASSERT_EQUAL(level.extent(0), 15);
+  LMBUNIT_ASSERT_EQUAL(level.extent(1), 24);
+  LMBUNIT_ASSERT_EQUAL(level.extent(2), 16);
+  LMBUNIT_ASSERT_EQUAL_DELTA(level.elementSizeUm()(0), 2.0, 1e-10);
+  LMBUNIT_ASSERT_EQUAL_DELTA(level.elementSizeUm()(1), 1.0, 1e-10);
+  LMBUNIT_ASSERT_EQUAL_DELTA(level.elementSizeUm()(2), 1.0, 1e-10);
+
+  atb::Array<double,3> expected;
+  directSmoothing(data, 1.0, expected);
+  for (atb::BlitzIndexT z = 0; z < level.extent(0); ++z)
+      for (atb::BlitzIndexT y = 0; y < level.extent(1); ++y)
+          for (atb::BlitzIndexT x = 0; x < level.extent(2); ++x)
+              LMBUNIT_ASSERT_EQUAL(level(z, y, x), expected(z, y, 2 * x));
+
+  // sigma = 4.0 reaches two elements along all dimensions of the reduced
+  // Array
+  level.reference(scaleSpace.level(4.0));
+  LMBUNIT_ASSERT_EQUAL(level.extent(0), 8);
+  LMBUNIT_ASSERT_EQUAL(level.extent(1), 12);
+  LMBUNIT_ASSERT_EQUAL(level.extent(2), 8);
+  LMBUNIT_ASSERT_EQUAL_DELTA(level.elementSizeUm()(0), 4.0, 1e-10);
+  LMBUNIT_ASSERT_EQUAL_DELTA(level.elementSizeUm()(1), 2.0, 1e-10);
+  LMBUNIT_ASSERT_EQUAL_DELTA(level.elementSizeUm()(2), 2.0, 1e-10);
+}
+
+int main(int, char**)
+{
+  LMBUNIT_WRITE_HEADER();
+
+  double sigmas1[] = { 1.0, 2.0, 3.0, 4.5 };
+  double sigmas2[] = { 0.7, 1.5, 2.5 };
+  double sigmas3[] = { 1.5, 4.0 };
+  std::vector<double> sigmasUm[] = {
+      std::vector<double>(sigmas1, sigmas1 + 4),
+      std::vector<double>(sigmas2, sigmas2 + 3),
+      std::vector<double>(sigmas3, sigmas3 + 2) };
+  for (int i = 0; i < 3; ++i)
+  {
+    LMBUNIT_RUN_TEST(testIncrementalLevelsMatchDirectSmoothing(sigmasUm[i], 0));
+    LMBUNIT_RUN_TEST(testIncrementalLevelsMatchDirectSmoothing(sigmasUm[i], 1));
+  }
+  LMBUNIT_RUN_TEST(testDownsampledLevels());
+
+  LMBUNIT_WRITE_STATISTICS();
+  return _nFails;
+}
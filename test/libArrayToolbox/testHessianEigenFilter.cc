@@ -0,0 +1,101 @@
+#include "lmbunit.hh"
+
+#include <libArrayToolbox/TypeTraits.hh>
+#include <libArrayToolbox/CentralHessianUTFilter.hh>
+#include <libArrayToolbox/HessianEigenFilter.hh>
+
+template<int Dim>
+class EigenvectorRecorder
+{
+
+public:
+
+  static bool const needsEigenvectors = true;
+
+  EigenvectorRecorder(blitz::TinyMatrix<double,Dim,Dim> *U)
+          : p_U(U)
+  {}
+
+  void operator()(
+      ptrdiff_t i, blitz::TinyVector<double,Dim> const &,
+      blitz::TinyMatrix<double,Dim,Dim> const &U)
+  {
+    p_U[i] = U;
+  }
+
+private:
+
+  blitz::TinyMatrix<double,Dim,Dim> *p_U;
+
+};
+
+template<int Dim>
+static void testHessianEigenFilterMatchesSeparateComputation(
+    atb::BoundaryTreatmentType btType)
+{
+  blitz::TinyVector<atb::BlitzIndexT,Dim> shape;
+  blitz::TinyVector<double,Dim> elementSizeUm;
+  for (int d = 0; d < Dim; ++d)
+  {
+    shape(d) = 4 + 3 * d;
+    elementSizeUm(d) = 0.5 + 0.25 * d;
+  }
+  blitz::Array<double,Dim> data(shape);
+  for (size_t i = 0; i < data.size(); ++i)
+      data.dataFirst()[i] =
+          static_cast<double>(std::rand()) / static_cast<double>(RAND_MAX);
+
+  blitz::Array<blitz::TinyVector<double,Dim * (Dim + 1) / 2>,Dim> hessian;
+  atb::CentralHessianUTFilter<double,Dim> hessianFilter(btType);
+  hessianFilter.apply(data, elementSizeUm, hessian);
+
+  blitz::Array<blitz::TinyVector<double,Dim>,Dim> lambda;
+  atb::HessianEigenFilter<double,Dim> eigenFilter(btType);
+  eigenFilter.apply(data, elementSizeUm, lambda);
+
+  std::vector< blitz::TinyMatrix<double,Dim,Dim> > U(data.size());
+  EigenvectorRecorder<Dim> recorder(&U[0]);
+  eigenFilter.decompose(data, elementSizeUm, recorder);
+
+  for (size_t i = 0; i < data.size(); ++i)
+  {
+    blitz::TinyMatrix<double,Dim,Dim> H;
+    int k = 0;
+    for (int r = 0; r < Dim; ++r)
+        for (int c = r; c < Dim; ++c, ++k)
+            H(r, c) = H(c, r) = hessian.dataFirst()[i](k);
+    blitz::TinyVector<double,Dim> expected;
+    atb::eigenvalueDecompositionRealSymmetric(H, expected, atb::Ascending);
+    for (int d = 0; d < Dim; ++d)
+    {
+      LMBUNIT_ASSERT_EQUAL_DELTA(
+          lambda.dataFirst()[i](d), expected(d), 1e-6);
+
+      // H u = lambda u
+      for (int r = 0; r < Dim; ++r)
+      {
+        double Hu = 0.0;
+        for (int c = 0; c < Dim; ++c) Hu += H(r, c) * U[i](c, d);
+        LMBUNIT_ASSERT_EQUAL_DELTA(Hu, expected(d) * U[i](r, d), 1e-5);
+      }
+    }
+  }
+}
+
+int main(int, char**)
+{
+  LMBUNIT_WRITE_HEADER();
+
+  atb::BoundaryTreatmentType btTypes[] = {
+      atb::CyclicBT, atb::RepeatBT, atb::MirrorBT };
+  for (int i = 0; i < 3; ++i)
+  {
+    LMBUNIT_RUN_TEST(
+        testHessianEigenFilterMatchesSeparateComputation<2>(btTypes[i]));
+    LMBUNIT_RUN_TEST(
+        testHessianEigenFilterMatchesSeparateComputation<3>(btTypes[i]));
+  }
+
+  LMBUNIT_WRITE_STATISTICS();
+  return _nFails;
+}
@@ -0,0 +1,217 @@
+#include "lmbunit.hh"
+
+#include <libArrayToolbox/TypeTraits.hh>
+#include <libArrayToolbox/Interpolator.hh>
+
+template<typename DataT, int Dim>
+static void testBatchInterpolationMatchesSingleAccess(
+    atb::InterpolationType ipType, atb::BoundaryTreatmentType btType)
+{
+  blitz::TinyVector<atb::BlitzIndexT,Dim> dataShape;
+  for (int d = 0; d < Dim; ++d) dataShape(d) = 3 + 2 * d;
+  blitz::Array<DataT,Dim> data(dataShape);
+  for (size_t i = 0; i < data.size(); ++i)
+      data.dataFirst()[i] = static_cast<DataT>(
+          100.0 * static_cast<double>(std::rand()) /
+          static_cast<double>(RAND_MAX));
+
+  atb::Interpolator<DataT,Dim> *ip =
+      atb::InterpolatorFactory<DataT,Dim>::get(
+          ipType, btType, static_cast<DataT>(7));
+
+  // Random positions including positions outside the Array
+  std::vector< blitz::TinyVector<double,Dim> > positions(200);
+  for (size_t i = 0; i < positions.size(); ++i)
+      for (int d = 0; d < Dim; ++d)
+          positions[i](d) = -3.0 + (dataShape(d) + 6.0) *
+              static_cast<double>(std::rand()) /
+              static_cast<double>(RAND_MAX);
+  std::vector<DataT> values(positions.size());
+  ip->getBatch(data, &positions[0], positions.size(), &values[0]);
+  for (size_t i = 0; i < positions.size(); ++i)
+      LMBUNIT_ASSERT_EQUAL_DELTA(values[i], ip->get(data, positions[i]), 1e-4);
+
+  // Slanted grid crossing the Array boundaries
+  blitz::TinyVector<double,Dim> origin, rowStep, columnStep;
+  for (int d = 0; d < Dim; ++d)
+  {
+    origin(d) = -1.7 + 0.3 * d;
+    rowStep(d) = 0.45 - 0.1 * d;
+    columnStep(d) = 0.13 + 0.05 * d;
+  }
+  size_t nRows = 17, nColumns = 93;
+  std::vector<DataT> grid(nRows * nColumns);
+  ip->getGrid(data, origin, rowStep, nRows, columnStep, nColumns, &grid[0]);
+  for (size_t r = 0; r < nRows; ++r)
+  {
+    for (size_t c = 0; c < nColumns; ++c)
+    {
+      blitz::TinyVector<double,Dim> pos;
+      for (int d = 0; d < Dim; ++d)
+          pos(d) = origin(d) + r * rowStep(d) + c * columnStep(d);
+      LMBUNIT_ASSERT_EQUAL_DELTA(
+          grid[r * nColumns + c], ip->get(data, pos), 1e-4);
+    }
+  }
+
+  delete ip;
+}
+
+template<typename DataT, int Dim>
+static void testBSplineInterpolationReproducesSamples(
+    atb::BoundaryTreatmentType btType)
+{
+  blitz::TinyVector<atb::BlitzIndexT,Dim> dataShape;
+  for (int d = 0; d < Dim; ++d) dataShape(d) = 5 + 3 * d;
+  blitz::Array<DataT,Dim> data(dataShape);
+  for (size_t i = 0; i < data.size(); ++i)
+      data.dataFirst()[i] = static_cast<DataT>(
+          static_cast<double>(std::rand()) / static_cast<double>(RAND_MAX));
+
+  atb::CubicInterpolator<DataT,Dim> ip(btType);
+  ip.setBSplinePrefilter(true);
+  LMBUNIT_ASSERT(ip.bSplinePrefilter());
+
+  // The prefiltered spline passes through all samples
+  std::vector< blitz::TinyVector<double,Dim> > positions(data.size());
+  for (size_t i = 0; i < data.size(); ++i)
+  {
+    size_t resid = i;
+    for (int d = Dim - 1; d >= 0; --d)
+    {
+      positions[i](d) = static_cast<double>(resid % dataShape(d));
+      resid /= dataShape(d);
+    }
+  }
+  std::vector<DataT> values(positions.size());
+  ip.getBatch(data, &positions[0], positions.size(), &values[0]);
+  for (size_t i = 0; i < data.size(); ++i)
+      LMBUNIT_ASSERT_EQUAL_DELTA(values[i], data.dataFirst()[i], 1e-4);
+
+  // Single access uses the same coefficients
+  blitz::TinyVector<double,Dim> pos(1.3);
+  DataT value;
+  ip.getBatch(data, &pos, 1, &value);
+  LMBUNIT_ASSERT_EQUAL_DELTA(ip.get(data, pos), value, 1e-6);
+
+  // Modifying the data in place requires invalidating the cache
+  data *= static_cast<DataT>(2);
+  ip.invalidateCache();
+  LMBUNIT_ASSERT_EQUAL_DELTA(ip.get(data, pos), 2 * value, 1e-4);
+}
+
+template<typename DataT, int Dim>
+static void testRankInterpolationAtBoundary(
+    atb::InterpolationType ipType, atb::BoundaryTreatmentType btType)
+{
+  blitz::TinyVector<atb::BlitzIndexT,Dim> dataShape;
+  for (int d = 0; d < Dim; ++d) dataShape(d) = 3 + d;
+  blitz::Array<DataT,Dim> data(dataShape);
+  for (size_t i = 0; i < data.size(); ++i)
+      data.dataFirst()[i] = static_cast<DataT>(std::rand() % 100);
+
+  atb::Interpolator<DataT,Dim> *ip =
+      atb::InterpolatorFactory<DataT,Dim>::get(
+          ipType, btType, static_cast<DataT>(50));
+  atb::BoundaryTreatment<DataT,Dim> *bt =
+      atb::BoundaryTreatmentFactory<DataT,Dim>::get(
+          btType, static_cast<DataT>(50));
+
+  // Compare against the adjacent values read through the virtual
+  // boundary treatment. Integer coordinates in some dimensions reduce the
+  // set of adjacent values.
+  for (int t = 0; t < 200; ++t)
+  {
+    blitz::TinyVector<double,Dim> pos;
+    blitz::TinyVector<ptrdiff_t,Dim> lPos;
+    for (int d = 0; d < Dim; ++d)
+    {
+      lPos(d) = std::rand() % (dataShape(d) + 4) - 2;
+      pos(d) = static_cast<double>(lPos(d)) +
+          ((std::rand() % 2 == 0) ? 0.0 : 0.5);
+    }
+    std::vector<DataT> values;
+    for (int i = 0; i < (1 << Dim); ++i)
+    {
+      blitz::TinyVector<ptrdiff_t,Dim> binPos(lPos);
+      bool skip = false;
+      for (int d = 0; d < Dim; ++d)
+      {
+        if ((i >> d) % 2 == 0) continue;
+        if (pos(d) == static_cast<double>(lPos(d))) skip = true;
+        binPos(d) += 1;
+      }
+      if (!skip) values.push_back(bt->get(data, binPos));
+    }
+    std::sort(values.begin(), values.end());
+    DataT expected = (ipType == atb::MinimumIP) ? values.front() :
+        ((ipType == atb::MaximumIP) ? values.back() :
+         values[values.size() / 2]);
+    LMBUNIT_ASSERT_EQUAL(ip->get(data, pos), expected);
+  }
+
+  delete bt;
+  delete ip;
+}
+
+int main(int, char**)
+{
+  LMBUNIT_WRITE_HEADER();
+
+  atb::InterpolationType ipTypes[] = {
+      atb::NearestIP, atb::LinearIP, atb::CubicIP };
+  atb::BoundaryTreatmentType btTypes[] = {
+      atb::ValueBT, atb::CyclicBT, atb::RepeatBT, atb::MirrorBT };
+  for (int i = 0; i < 3; ++i)
+  {
+    for (int j = 0; j < 4; ++j)
+    {
+      LMBUNIT_RUN_TEST(
+          (testBatchInterpolationMatchesSingleAccess<float,1>(
+              ipTypes[i], btTypes[j])));
+      LMBUNIT_RUN_TEST(
+          (testBatchInterpolationMatchesSingleAccess<double,2>(
+              ipTypes[i], btTypes[j])));
+      LMBUNIT_RUN_TEST(
+          (testBatchInterpolationMatchesSingleAccess<float,3>(
+              ipTypes[i], btTypes[j])));
+      LMBUNIT_RUN_TEST(
+          (testBatchInterpolationMatchesSingleAccess<double,4>(
+              ipTypes[i], btTypes[j])));
+    }
+  }
+
+  atb::InterpolationType rankIpTypes[] = {
+      atb::MinimumIP, atb::MaximumIP, atb::MedianIP };
+  for (int i = 0; i < 3; ++i)
+  {
+    for (int j = 0; j < 4; ++j)
+    {
+      LMBUNIT_RUN_TEST(
+          (testRankInterpolationAtBoundary<float,2>(
+              rankIpTypes[i], btTypes[j])));
+      LMBUNIT_RUN_TEST(
+          (testRankInterpolationAtBoundary<double,3>(
+              rankIpTypes[i], btTypes[j])));
+    }
+  }
+
+  // The prefilter assumes cyclic or mirrored continuation of the data
+  atb::BoundaryTreatmentType bSplineBtTypes[] = {
+      atb::CyclicBT, atb::MirrorBT };
+  for (int j = 0; j < 2; ++j)
+  {
+    LMBUNIT_RUN_TEST(
+        (testBSplineInterpolationReproducesSamples<double,1>(
+            bSplineBtTypes[j])));
+    LMBUNIT_RUN_TEST(
+        (testBSplineInterpolationReproducesSamples<double,2>(
+            bSplineBtTypes[j])));
+    LMBUNIT_RUN_TEST(
+        (testBSplineInterpolationReproducesSamples<float,3>(
+            bSplineBtTypes[j])));
+  }
+
+  LMBUNIT_WRITE_STATISTICS();
+  return _nFails;
+}
@@ -0,0 +1,131 @@
+#include "lmbunit.hh"
+
+#include <vector>
+#include <algorithm>
+
+#include <libArrayToolbox/TypeTraits.hh>
+#include <libArrayToolbox/IsotropicPercentileFilter.hh>
+
+// Per-voxel reference implementation, this is how the filter worked before
+// it became scanline-incremental
+template<typename DataT, int Dim>
+static void naivePercentileFilter(
+    blitz::Array<DataT,Dim> const &data,
+    blitz::TinyVector<double,Dim> const &elementSizeUm,
+    blitz::Array<DataT,Dim> &result, double radiusUm, double percentile)
+{
+  std::vector< blitz::TinyVector<atb::BlitzIndexT,Dim> > strel;
+  blitz::TinyVector<atb::BlitzIndexT,Dim> kernelShape;
+  size_t nPoints = 1;
+  for (int d = 0; d < Dim; ++d)
+  {
+    kernelShape(d) = 2 * static_cast<atb::BlitzIndexT>(
+        std::ceil(radiusUm / elementSizeUm(d))) + 1;
+    nPoints *= kernelShape(d);
+  }
+  blitz::TinyVector<atb::BlitzIndexT,Dim> c(kernelShape / 2);
+  for (size_t i = 0; i < nPoints; ++i)
+  {
+    double sqrDistUm = 0.0;
+    blitz::TinyVector<atb::BlitzIndexT,Dim> posPx;
+    size_t tmp = i;
+    for (int d = Dim - 1; d >= 0; --d)
+    {
+      posPx(d) = tmp % kernelShape(d) - c(d);
+      sqrDistUm += posPx(d) * elementSizeUm(d) * posPx(d) * elementSizeUm(d);
+      tmp /= kernelShape(d);
+    }
+    if (sqrDistUm <= radiusUm * radiusUm) strel.push_back(posPx);
+  }
+
+  result.resize(data.shape());
+  for (size_t i = 0; i < data.size(); ++i)
+  {
+    blitz::TinyVector<atb::BlitzIndexT,Dim> p;
+    size_t tmp = i;
+    for (int d = Dim - 1; d >= 0; --d)
+    {
+      p(d) = tmp % data.extent(d);
+      tmp /= data.extent(d);
+    }
+    std::vector<DataT> values;
+    for (size_t j = 0; j < strel.size(); ++j)
+    {
+      blitz::TinyVector<atb::BlitzIndexT,Dim> rdPos(p + strel[j]);
+      if (blitz::all(rdPos >= 0 && rdPos < data.shape()))
+          values.push_back(data(rdPos));
+    }
+    std::sort(values.begin(), values.end());
+    result(p) = values[
+        static_cast<size_t>(
+            std::round(percentile / 100.0 * (values.size() - 1)))];
+  }
+}
+
+template<typename DataT, int Dim>
+static void testPercentileFilterMatchesNaiveImplementation(double percentile)
+{
+  blitz::TinyVector<atb::BlitzIndexT,Dim> dataShape;
+  blitz::TinyVector<double,Dim> elementSizeUm;
+  double avgDim = std::pow(8000.0, 1.0 / static_cast<double>(Dim));
+  for (int d = 0; d < Dim; ++d)
+  {
+    dataShape(d) = static_cast<atb::BlitzIndexT>(
+        avgDim + 0.5 * avgDim * (static_cast<double>(std::rand()) /
+                                 static_cast<double>(RAND_MAX) - 0.5));
+    elementSizeUm(d) = 0.5 + static_cast<double>(std::rand()) /
+        static_cast<double>(RAND_MAX);
+  }
+  double radiusUm = 1.5 + 2.0 * static_cast<double>(std::rand()) /
+      static_cast<double>(RAND_MAX);
+  blitz::Array<DataT,Dim> data(dataShape);
+  for (size_t i = 0; i < data.size(); ++i)
+      data.dataFirst()[i] = static_cast<DataT>(
+          atb::traits<DataT>::saturated *
+          static_cast<double>(std::rand()) / static_cast<double>(RAND_MAX));
+
+  blitz::Array<DataT,Dim> expectedResult;
+  naivePercentileFilter(
+      data, elementSizeUm, expectedResult, radiusUm, percentile);
+
+  atb::IsotropicPercentileFilter<DataT,Dim> filter(radiusUm, percentile);
+  blitz::Array<DataT,Dim> result;
+  filter.apply(data, elementSizeUm, result);
+  LMBUNIT_ASSERT(blitz::all(result.shape() == dataShape));
+  LMBUNIT_ASSERT(blitz::all(result == expectedResult));
+
+  // In-place filtering must give the same result
+  filter.apply(data, elementSizeUm, data);
+  LMBUNIT_ASSERT(blitz::all(data == expectedResult));
+}
+
+int main(int, char**)
+{
+  LMBUNIT_WRITE_HEADER();
+
+  double percentiles[] = { 0.0, 25.0, 50.0, 90.0, 100.0 };
+  for (int i = 0; i < 5; ++i)
+  {
+    LMBUNIT_RUN_TEST(
+        (testPercentileFilterMatchesNaiveImplementation<unsigned char,1>(
+            percentiles[i])));
+    LMBUNIT_RUN_TEST(
+        (testPercentileFilterMatchesNaiveImplementation<unsigned char,2>(
+            percentiles[i])));
+    LMBUNIT_RUN_TEST(
+        (testPercentileFilterMatchesNaiveImplementation<unsigned short,3>(
+            percentiles[i])));
+    LMBUNIT_RUN_TEST(
+        (testPercentileFilterMatchesNaiveImplementation<unsigned char,3>(
+            percentiles[i])));
+    LMBUNIT_RUN_TEST(
+        (testPercentileFilterMatchesNaiveImplementation<float,3>(
+            percentiles[i])));
+    LMBUNIT_RUN_TEST(
+        (testPercentileFilterMatchesNaiveImplementation<double,2>(
+            percentiles[i])));
+  }
+
+  LMBUNIT_WRITE_STATISTICS();
+  return _nFails;
+}
@@ -0,0 +1,174 @@
+#include "lmbunit.hh"
+
+#include <vector>
+#include <cstdlib>
+
+#include <libArrayToolbox/TypeTraits.hh>
+#include <libArrayToolbox/LocalMaximumExtraction.hh>
+
+static void testNMSMatchesBruteForce(bool excludeBoundary)
+{
+  blitz::Array<float,3> data(9, 14, 11);
+  for (size_t i = 0; i < data.size(); ++i)
+      data.dataFirst()[i] = static_cast<float>(std::rand() % 20);
+  blitz::TinyVector<atb::BlitzIndexT,3> radius(1, 2, 0);
+  float minValue = 5.0f;
+
+  std::vector< atb::LocalMaximum<float,3> > maxima;
+  atb::extractLocalMaximaNMS(
+      data, maxima, radius, minValue, blitz::TinyVector<double,3>(1.0), 0.0,
+      0, false, excludeBoundary);
+
+  blitz::Array<bool,3> isMaximum(data.shape());
+  isMaximum = false;
+  for (size_t i = 0; i < maxima.size(); ++i)
+  {
+    LMBUNIT_ASSERT(!isMaximum(maxima[i].voxel));
+    isMaximum(maxima[i].voxel) = true;
+    LMBUNIT_ASSERT_EQUAL(maxima[i].value, data(maxima[i].voxel));
+    if (i > 0) LMBUNIT_ASSERT(maxima[i - 1].value >= maxima[i].value);
+  }
+
+  size_t nExpected = 0;
+  blitz::TinyVector<atb::BlitzIndexT,3> p, q;
+  for (p(0) = 0; p(0) < data.extent(0); ++p(0))
+  {
+    for (p(1) = 0; p(1) < data.extent(1); ++p(1))
+    {
+      for (p(2) = 0; p(2) < data.extent(2); ++p(2))
+      {
+        bool expected = data(p) >= minValue &&
+            !(excludeBoundary &&
+              blitz::any(p == 0 || p == data.shape() - 1));
+        for (q(0) = p(0) - radius(0); q(0) <= p(0) + radius(0); ++q(0))
+            for (q(1) = p(1) - radius(1); q(1) <= p(1) + radius(1); ++q(1))
+                for (q(2) = p(2) - radius(2); q(2) <= p(2) + radius(2);
+                     ++q(2))
+                    if (blitz::all(q >= 0 && q < data.shape()) &&
+                        data(q) > data(p)) expected = false;
+        LMBUNIT_ASSERT_EQUAL(isMaximum(p), expected);
+        if (expected) ++nExpected;
+      }
+    }
+  }
+  LMBUNIT_ASSERT_EQUAL(maxima.size(), nExpected);
+}
+
+static void testNMSContainsStrictMaxima()
+{
+  blitz::Array<double,2> data(31, 27);
+  for (size_t i = 0; i < data.size(); ++i)
+      data.dataFirst()[i] =
+          static_cast<double>(std::rand()) / static_cast<double>(RAND_MAX);
+
+  std::vector< blitz::TinyVector<atb::BlitzIndexT,2> > strict;
+  atb::extractLocalMaxima(data, strict, atb::COMPLEX_NHOOD);
+  LMBUNIT_ASSERT(strict.size() > 0);
+  for (size_t i = 1; i < strict.size(); ++i)
+      LMBUNIT_ASSERT(
+          strict[i - 1](0) < strict[i](0) ||
+          (strict[i - 1](0) == strict[i](0) &&
+           strict[i - 1](1) < strict[i](1)));
+
+  std::vector< atb::LocalMaximum<double,2> > maxima;
+  atb::extractLocalMaximaNMS(
+      data, maxima, blitz::TinyVector<atb::BlitzIndexT,2>(1));
+  for (size_t i = 0; i < strict.size(); ++i)
+  {
+    size_t j = 0;
+    for (; j < maxima.size(); ++j)
+        if (blitz::all(maxima[j].voxel == strict[i])) break;
+    LMBUNIT_ASSERT(j < maxima.size());
+  }
+}
+
+static void testSubVoxelRefinement()
+{
+  blitz::Array<double,2> data(9, 11);
+  for (int y = 0; y < data.extent(0); ++y)
+      for (int x = 0; x < data.extent(1); ++x)
+          data(y, x) = 10.0 - (y - 3.3) * (y - 3.3) -
+              2.0 * (x - 4.6) * (x - 4.6);
+
+  std::vector< atb::LocalMaximum<double,2> > maxima;
+  atb::extractLocalMaximaNMS(
+      data, maxima, blitz::TinyVector<atb::BlitzIndexT,2>(1),
+      atb::traits<double>::smallest, blitz::TinyVector<double,2>(1.0),
+      0.0, 0, true);
+  LMBUNIT_ASSERT_EQUAL(maxima.size(), 1u);
+  LMBUNIT_ASSERT_EQUAL(maxima[0].voxel(0), 3);
+  LMBUNIT_ASSERT_EQUAL(maxima[0].voxel(1), 5);
+  LMBUNIT_ASSERT_EQUAL_DELTA(maxima[0].position(0), 3.3, 1e-10);
+  LMBUNIT_ASSERT_EQUAL_DELTA(maxima[0].position(1), 4.6, 1e-10);
+  LMBUNIT_ASSERT_EQUAL_DELTA(maxima[0].value, 10.0, 1e-10);
+}
+
+static void testMinDistanceAndMaxCount()
+{
+  blitz::Array<float,2> data(20, 20);
+  data = 0.0f;
+  data(2, 2) = 5.0f;
+  data(2, 5) = 4.0f;
+  data(10, 2) = 3.0f;
+  data(15, 15) = 2.0f;
+  data(17, 15) = 1.0f;
+
+  blitz::TinyVector<atb::BlitzIndexT,2> radius(1);
+  std::vector< atb::LocalMaximum<float,2> > maxima;
+  atb::extractLocalMaximaNMS(data, maxima, radius, 1.0f);
+  LMBUNIT_ASSERT_EQUAL(maxima.size(), 5u);
+
+  // Distances are measured in units of the element size, the maxima at
+  // (2, 5) and (17, 15) are closer than 2.5 units to stronger ones
+  blitz::TinyVector<double,2> elSize(1.0, 0.5);
+  atb::extractLocalMaximaNMS(data, maxima, radius, 1.0f, elSize, 2.5);
+  LMBUNIT_ASSERT_EQUAL(maxima.size(), 3u);
+  LMBUNIT_ASSERT_EQUAL(maxima[0].value, 5.0f);
+  LMBUNIT_ASSERT_EQUAL(maxima[1].value, 3.0f);
+  LMBUNIT_ASSERT_EQUAL(maxima[2].value, 2.0f);
+
+  atb::extractLocalMaximaNMS(data, maxima, radius, 1.0f, elSize, 2.5, 2);
+  LMBUNIT_ASSERT_EQUAL(maxima.size(), 2u);
+  LMBUNIT_ASSERT_EQUAL(maxima[1].value, 3.0f);
+
+  atb::extractLocalMaximaNMS(data, maxima, radius, 1.0f, elSize, 0.0, 2);
+  LMBUNIT_ASSERT_EQUAL(maxima.size(), 2u);
+  LMBUNIT_ASSERT_EQUAL(maxima[0].value, 5.0f);
+  LMBUNIT_ASSERT_EQUAL(maxima[1].value, 4.0f);
+}
+
+static void testTinyMinDistance()
+{
+  // The suppression grid cells are at least one voxel large, a minimum
+  // distance far below the element size must neither exhaust the memory
+  // nor suppress distinct maxima
+  blitz::Array<float,3> data(40, 50, 60);
+  for (size_t i = 0; i < data.size(); ++i)
+      data.dataFirst()[i] = static_cast<float>(std::rand() % 1000);
+  blitz::TinyVector<atb::BlitzIndexT,3> radius(1);
+
+  std::vector< atb::LocalMaximum<float,3> > expected, maxima;
+  atb::extractLocalMaximaNMS(data, expected, radius);
+  LMBUNIT_ASSERT(expected.size() > 0);
+  atb::extractLocalMaximaNMS(
+      data, maxima, radius, atb::traits<float>::smallest,
+      blitz::TinyVector<double,3>(2.0, 1.0, 0.5), 1e-9);
+  LMBUNIT_ASSERT_EQUAL(maxima.size(), expected.size());
+  for (size_t i = 0; i < maxima.size(); ++i)
+      LMBUNIT_ASSERT(blitz::all(maxima[i].voxel == expected[i].voxel));
+}
+
+int main(int, char**)
+{
+  LMBUNIT_WRITE_HEADER();
+
+  LMBUNIT_RUN_TEST(testNMSMatchesBruteForce(false));
+  LMBUNIT_RUN_TEST(testNMSMatchesBruteForce(true));
+  LMBUNIT_RUN_TEST(testNMSContainsStrictMaxima());
+  LMBUNIT_RUN_TEST(testSubVoxelRefinement());
+  LMBUNIT_RUN_TEST(testMinDistanceAndMaxCount());
+  LMBUNIT_RUN_TEST(testTinyMinDistance());
+
+  LMBUNIT_WRITE_STATISTICS();
+  return _nFails;
+}
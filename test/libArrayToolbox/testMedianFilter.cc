@@ -0,0 +1,146 @@
+#include "lmbunit.hh"
+
+#include <libArrayToolbox/TypeTraits.hh>
+#include <libArrayToolbox/MedianFilter.hh>
+
+#include <set>
+#include <deque>
+
+template<typename DataT, int Dim>
+static void testMedianFilterMatchesNaiveImplementation()
+{
+  blitz::TinyVector<atb::BlitzIndexT,Dim> dataShape;
+  blitz::TinyVector<atb::BlitzIndexT,Dim> filterShapePx;
+  double avgDim = std::pow(20000.0, 1.0 / static_cast<double>(Dim));
+  for (int d = 0; d < Dim; ++d)
+  {
+    dataShape(d) = static_cast<atb::BlitzIndexT>(
+        avgDim + 0.5 * avgDim * (static_cast<double>(std::rand()) /
+                                 static_cast<double>(RAND_MAX) - 0.5));
+    filterShapePx(d) = static_cast<atb::BlitzIndexT>(
+        4 + 4 * (static_cast<double>(std::rand()) /
+                 static_cast<double>(RAND_MAX) - 0.5));
+  }
+  blitz::Array<DataT,Dim> data(dataShape);
+  for (size_t i = 0; i < data.size(); ++i)
+      data.dataFirst()[i] = static_cast<DataT>(
+          atb::traits<DataT>::saturated *
+          static_cast<double>(std::rand()) / static_cast<double>(RAND_MAX));
+
+  blitz::Array<DataT,Dim> expectedResult(dataShape);
+  for (size_t i = 0; i < expectedResult.size(); ++i)
+  {
+    size_t tmp = i;
+    blitz::TinyVector<atb::BlitzIndexT,Dim> x;
+    for (int d = Dim - 1; d >= 0; --d)
+    {
+      x(d) = tmp % data.extent(d);
+      tmp /= data.extent(d);
+    }
+    std::vector<DataT> values;
+    for (size_t j = 0; j < static_cast<size_t>(blitz::product(filterShapePx));
+         ++j)
+    {
+      tmp = j;
+      blitz::TinyVector<atb::BlitzIndexT,Dim> dx;
+      for (int d = Dim - 1; d >= 0; --d)
+      {
+        dx(d) = tmp % filterShapePx(d) - filterShapePx(d) / 2;
+        tmp /= filterShapePx(d);
+      }
+      blitz::TinyVector<atb::BlitzIndexT,Dim> rdPos(x + dx);
+      if (blitz::all(rdPos >= 0) && blitz::all(rdPos < dataShape))
+          values.push_back(data(rdPos));
+    }
+    std::nth_element(
+        values.begin(), values.begin() + values.size() / 2, values.end());
+    expectedResult(x) = values[values.size() / 2];
+  }
+
+  blitz::Array<DataT,Dim> result;
+  atb::MedianFilter<DataT,Dim>::apply(data, result, filterShapePx);
+  LMBUNIT_ASSERT(blitz::all(result == expectedResult));
+
+  // In-place filtering must give the same result
+  atb::MedianFilter<DataT,Dim>::apply(data, data, filterShapePx);
+  LMBUNIT_ASSERT(blitz::all(data == expectedResult));
+}
+
+// Slide a window over random values, first a large then a small one, and
+// compare the ranks against a sorted reference. The number of blocks must
+// follow the square root of the window size also after shrinking.
+static void testSlidingWindowRankStaysBalanced()
+{
+  atb::SlidingWindowRank<float> window;
+  std::multiset<float> reference;
+  std::deque<float> values;
+  size_t windowSizes[] = { 2000, 300 };
+  for (int phase = 0; phase < 2; ++phase)
+  {
+    for (int step = 0; step < 50000; ++step)
+    {
+      float value = 0.5f * static_cast<float>(std::rand() % 5000);
+      window.insert(value);
+      reference.insert(value);
+      values.push_back(value);
+      while (values.size() > windowSizes[phase])
+      {
+        window.erase(values.front());
+        reference.erase(reference.find(values.front()));
+        values.pop_front();
+      }
+      LMBUNIT_ASSERT_EQUAL(window.size(), values.size());
+      if (step % 101 == 0)
+      {
+        size_t k = std::rand() % values.size();
+        std::multiset<float>::const_iterator it = reference.begin();
+        std::advance(it, k);
+        LMBUNIT_ASSERT_EQUAL(window.kth(k), *it);
+      }
+      if (step > 10000)
+          LMBUNIT_ASSERT(
+              window.nBlocks() <= 4 * static_cast<size_t>(
+                  std::sqrt(static_cast<double>(windowSizes[phase]))) + 4);
+    }
+  }
+  while (values.size() > 0)
+  {
+    window.erase(values.front());
+    values.pop_front();
+  }
+  LMBUNIT_ASSERT_EQUAL(window.size(), static_cast<size_t>(0));
+  LMBUNIT_ASSERT_EQUAL(window.nBlocks(), static_cast<size_t>(0));
+}
+
+int main(int, char**)
+{
+  LMBUNIT_WRITE_HEADER();
+
+  LMBUNIT_RUN_TEST(testSlidingWindowRankStaysBalanced());
+
+  LMBUNIT_RUN_TEST(
+      (testMedianFilterMatchesNaiveImplementation<unsigned char,1>()));
+  LMBUNIT_RUN_TEST(
+      (testMedianFilterMatchesNaiveImplementation<unsigned short,1>()));
+  LMBUNIT_RUN_TEST(
+      (testMedianFilterMatchesNaiveImplementation<float,1>()));
+  LMBUNIT_RUN_TEST(
+      (testMedianFilterMatchesNaiveImplementation<unsigned char,2>()));
+  LMBUNIT_RUN_TEST(
+      (testMedianFilterMatchesNaiveImplementation<short,2>()));
+  LMBUNIT_RUN_TEST(
+      (testMedianFilterMatchesNaiveImplementation<double,2>()));
+  LMBUNIT_RUN_TEST(
+      (testMedianFilterMatchesNaiveImplementation<unsigned char,3>()));
+  LMBUNIT_RUN_TEST(
+      (testMedianFilterMatchesNaiveImplementation<unsigned short,3>()));
+  LMBUNIT_RUN_TEST(
+      (testMedianFilterMatchesNaiveImplementation<int,3>()));
+  LMBUNIT_RUN_TEST(
+      (testMedianFilterMatchesNaiveImplementation<float,3>()));
+  LMBUNIT_RUN_TEST(
+      (testMedianFilterMatchesNaiveImplementation<double,3>()));
+
+  LMBUNIT_WRITE_STATISTICS();
+  return _nFails;
+}
@@ -0,0 +1,281 @@
+#include "lmbunit.hh"
+
+#include <vector>
+#include <set>
+#include <queue>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <libArrayToolbox/TypeTraits.hh>
+#include <libArrayToolbox/ATBMorphology.hh>
+
+template<typename DataT, int Dim>
+static void fillRandom(blitz::Array<DataT,Dim> &array)
+{
+  for (size_t i = 0; i < array.size(); ++i)
+      array.dataFirst()[i] = static_cast<DataT>(
+          atb::traits<DataT>::saturated *
+          static_cast<double>(std::rand()) / static_cast<double>(RAND_MAX));
+}
+
+template<int Dim>
+static blitz::TinyVector<atb::BlitzIndexT,Dim> randomShape(
+    atb::BlitzIndexT minExtent, atb::BlitzIndexT maxExtent)
+{
+  blitz::TinyVector<atb::BlitzIndexT,Dim> shape;
+  for (int d = 0; d < Dim; ++d)
+      shape(d) = minExtent + std::rand() % (maxExtent - minExtent + 1);
+  return shape;
+}
+
+// A duplicate point makes isBoxStructuringElement() fail, so the same box
+// is processed by the brute force path
+template<int Dim>
+static std::vector< blitz::TinyVector<atb::BlitzIndexT,Dim> > bruteForceStrel(
+    std::vector< blitz::TinyVector<atb::BlitzIndexT,Dim> > const &strel)
+{
+  std::vector< blitz::TinyVector<atb::BlitzIndexT,Dim> > res(strel);
+  res.push_back(strel[0]);
+  return res;
+}
+
+template<typename DataT, int Dim>
+static void testBoxMorphologyMatchesBruteForce()
+{
+  for (int iter = 0; iter < 4; ++iter)
+  {
+    // Boxes with even and odd extents, some of them exceeding the data
+    // extents to check the boundary handling
+    blitz::Array<DataT,Dim> data(randomShape<Dim>(3, 12));
+    fillRandom(data);
+    std::vector< blitz::TinyVector<atb::BlitzIndexT,Dim> > strel(
+        atb::boxStructuringElement(randomShape<Dim>(1, 8)));
+    blitz::TinyVector<atb::BlitzIndexT,Dim> lb, ub;
+    LMBUNIT_ASSERT(atb::isBoxStructuringElement(strel, lb, ub));
+    if (iter == 3)
+    {
+      // Box with the reference point in its corner
+      for (size_t i = 0; i < strel.size(); ++i) strel[i] -= lb;
+      LMBUNIT_ASSERT(atb::isBoxStructuringElement(strel, lb, ub));
+      LMBUNIT_ASSERT(blitz::all(lb == 0));
+    }
+    LMBUNIT_ASSERT(
+        !atb::isBoxStructuringElement(bruteForceStrel(strel), lb, ub));
+
+    blitz::Array<DataT,Dim> expected, result;
+    atb::dilate(data, expected, bruteForceStrel(strel));
+    atb::dilate(data, result, strel);
+    LMBUNIT_ASSERT(blitz::all(result.shape() == data.shape()));
+    LMBUNIT_ASSERT(blitz::all(result == expected));
+
+    atb::erode(data, expected, bruteForceStrel(strel));
+    atb::erode(data, result, strel);
+    LMBUNIT_ASSERT(blitz::all(result == expected));
+
+    atb::open(data, expected, bruteForceStrel(strel));
+    atb::open(data, result, strel);
+    LMBUNIT_ASSERT(blitz::all(result == expected));
+
+    atb::close(data, expected, bruteForceStrel(strel));
+    atb::close(data, result, strel);
+    LMBUNIT_ASSERT(blitz::all(result == expected));
+
+    // In-place filtering must give the same result
+    atb::erode(data, expected, bruteForceStrel(strel));
+    atb::erode(data, data, strel);
+    LMBUNIT_ASSERT(blitz::all(data == expected));
+  }
+}
+
+template<typename DataT, int Dim>
+static void testLineMorphologyMatchesBruteForce(
+    double radiusUm, atb::BlitzIndexT minExtent, atb::BlitzIndexT maxExtent)
+{
+  blitz::Array<DataT,Dim> data(randomShape<Dim>(minExtent, maxExtent));
+  fillRandom(data);
+  std::vector< atb::StructuringElementLine<Dim> > lines(
+      atb::sphericalStructuringElementLines(
+          blitz::TinyVector<double,Dim>(1.0), radiusUm));
+  LMBUNIT_ASSERT(lines.size() > 0);
+
+  // The equivalent structuring element is the Minkowski sum of all
+  // line segments
+  std::set< std::vector<atb::BlitzIndexT> > points;
+  points.insert(std::vector<atb::BlitzIndexT>(Dim, 0));
+  blitz::TinyVector<atb::BlitzIndexT,Dim> margin(atb::BlitzIndexT(0));
+  for (size_t l = 0; l < lines.size(); ++l)
+  {
+    std::set< std::vector<atb::BlitzIndexT> > sum;
+    for (std::set< std::vector<atb::BlitzIndexT> >::const_iterator it =
+             points.begin(); it != points.end(); ++it)
+    {
+      for (atb::BlitzIndexT k = -lines[l].nSteps; k <= lines[l].nSteps; ++k)
+      {
+        std::vector<atb::BlitzIndexT> p(*it);
+        for (int d = 0; d < Dim; ++d) p[d] += k * lines[l].step(d);
+        sum.insert(p);
+      }
+    }
+    points.swap(sum);
+    for (int d = 0; d < Dim; ++d)
+        margin(d) += lines[l].nSteps * std::abs(lines[l].step(d));
+  }
+  std::vector< blitz::TinyVector<atb::BlitzIndexT,Dim> > strel;
+  for (std::set< std::vector<atb::BlitzIndexT> >::const_iterator it =
+           points.begin(); it != points.end(); ++it)
+  {
+    blitz::TinyVector<atb::BlitzIndexT,Dim> p;
+    for (int d = 0; d < Dim; ++d) p(d) = (*it)[d];
+    strel.push_back(p);
+  }
+  strel = bruteForceStrel(strel);
+
+  // The line passes treat out-of-Array positions of intermediate results
+  // as neutral elements, so the results only agree where the whole
+  // Minkowski sum lies within the Array
+  blitz::Array<DataT,Dim> expected, result;
+  for (int op = 0; op < 2; ++op)
+  {
+    if (op == 0)
+    {
+      atb::dilate(data, expected, strel);
+      atb::dilate(data, result, lines);
+    }
+    else
+    {
+      atb::erode(data, expected, strel);
+      atb::erode(data, result, lines);
+    }
+    LMBUNIT_ASSERT(blitz::all(result.shape() == data.shape()));
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+      blitz::TinyVector<atb::BlitzIndexT,Dim> p;
+      size_t tmp = i;
+      for (int d = Dim - 1; d >= 0; --d)
+      {
+        p(d) = tmp % data.extent(d);
+        tmp /= data.extent(d);
+      }
+      if (blitz::any(p < margin || p >= data.shape() - margin)) continue;
+      LMBUNIT_ASSERT_EQUAL(result(p), expected(p));
+    }
+  }
+}
+
+// Sequential flood fill labelling, components are numbered in raster order
+// of their first voxel
+template<int Dim>
+static void floodFillLabelling(
+    blitz::Array<bool,Dim> const &data, blitz::Array<int,Dim> &labels,
+    atb::NHood nh)
+{
+  std::vector< blitz::TinyVector<atb::BlitzIndexT,Dim> > nhood;
+  atb::BlitzIndexT nOffsets = 1;
+  for (int d = 0; d < Dim; ++d) nOffsets *= 3;
+  for (atb::BlitzIndexT i = 0; i < nOffsets; ++i)
+  {
+    blitz::TinyVector<atb::BlitzIndexT,Dim> dx;
+    atb::BlitzIndexT tmp = i;
+    for (int d = Dim - 1; d >= 0; --d)
+    {
+      dx(d) = tmp % 3 - 1;
+      tmp /= 3;
+    }
+    int nNonZero = 0;
+    for (int d = 0; d < Dim; ++d) if (dx(d) != 0) ++nNonZero;
+    if (nNonZero == 0 || (nh == atb::SIMPLE_NHOOD && nNonZero > 1)) continue;
+    nhood.push_back(dx);
+  }
+
+  labels.resize(data.shape());
+  labels = 0;
+  int nextLabel = 1;
+  for (size_t i = 0; i < data.size(); ++i)
+  {
+    blitz::TinyVector<atb::BlitzIndexT,Dim> p;
+    size_t tmp = i;
+    for (int d = Dim - 1; d >= 0; --d)
+    {
+      p(d) = tmp % data.extent(d);
+      tmp /= data.extent(d);
+    }
+    if (!data(p) || labels(p) != 0) continue;
+    std::queue< blitz::TinyVector<atb::BlitzIndexT,Dim> > queue;
+    labels(p) = nextLabel;
+    queue.push(p);
+    while (!queue.empty())
+    {
+      blitz::TinyVector<atb::BlitzIndexT,Dim> q(queue.front());
+      queue.pop();
+      for (size_t k = 0; k < nhood.size(); ++k)
+      {
+        blitz::TinyVector<atb::BlitzIndexT,Dim> r(q + nhood[k]);
+        if (blitz::any(r < 0 || r >= data.shape()) || !data(r) ||
+            labels(r) != 0) continue;
+        labels(r) = nextLabel;
+        queue.push(r);
+      }
+    }
+    ++nextLabel;
+  }
+}
+
+template<int Dim>
+static void testConnectedComponentLabellingMatchesSerial(atb::NHood nh)
+{
+  // Sparse random masks give many small components crossing the slab
+  // borders in all directions
+  blitz::Array<bool,Dim> data(randomShape<Dim>(10, 30));
+  for (size_t i = 0; i < data.size(); ++i)
+      data.dataFirst()[i] = std::rand() < RAND_MAX / 3;
+
+  blitz::Array<int,Dim> expected;
+  floodFillLabelling(data, expected, nh);
+
+  int nThreads[] = { 1, 2, 3, 7 };
+  for (int t = 0; t < 4; ++t)
+  {
+#ifdef _OPENMP
+    int oldNThreads = omp_get_max_threads();
+    omp_set_num_threads(nThreads[t]);
+#endif
+    blitz::Array<int,Dim> labels;
+    atb::connectedComponentLabelling(data, labels, nh);
+#ifdef _OPENMP
+    omp_set_num_threads(oldNThreads);
+#endif
+    LMBUNIT_ASSERT(blitz::all(labels.shape() == data.shape()));
+    LMBUNIT_ASSERT(blitz::all(labels == expected));
+  }
+}
+
+int main(int, char**)
+{
+  LMBUNIT_WRITE_HEADER();
+
+  LMBUNIT_RUN_TEST((testBoxMorphologyMatchesBruteForce<unsigned char,1>()));
+  LMBUNIT_RUN_TEST((testBoxMorphologyMatchesBruteForce<unsigned char,2>()));
+  LMBUNIT_RUN_TEST((testBoxMorphologyMatchesBruteForce<float,2>()));
+  LMBUNIT_RUN_TEST((testBoxMorphologyMatchesBruteForce<unsigned short,3>()));
+  LMBUNIT_RUN_TEST((testBoxMorphologyMatchesBruteForce<double,3>()));
+  LMBUNIT_RUN_TEST(
+      (testLineMorphologyMatchesBruteForce<unsigned char,2>(5.0, 14, 20)));
+  LMBUNIT_RUN_TEST(
+      (testLineMorphologyMatchesBruteForce<float,3>(8.0, 24, 28)));
+
+  LMBUNIT_RUN_TEST(
+      (testConnectedComponentLabellingMatchesSerial<1>(atb::COMPLEX_NHOOD)));
+  LMBUNIT_RUN_TEST(
+      (testConnectedComponentLabellingMatchesSerial<2>(atb::SIMPLE_NHOOD)));
+  LMBUNIT_RUN_TEST(
+      (testConnectedComponentLabellingMatchesSerial<2>(atb::COMPLEX_NHOOD)));
+  LMBUNIT_RUN_TEST(
+      (testConnectedComponentLabellingMatchesSerial<3>(atb::SIMPLE_NHOOD)));
+  LMBUNIT_RUN_TEST(
+      (testConnectedComponentLabellingMatchesSerial<3>(atb::COMPLEX_NHOOD)));
+
+  LMBUNIT_WRITE_STATISTICS();
+  return _nFails;
+}
@@ -0,0 +1,146 @@
+#include "lmbunit.hh"
+
+#include <libArrayToolbox/TypeTraits.hh>
+#include <libArrayToolbox/BoundaryTreatment.hh>
+#include <libArrayToolbox/OverlapSaveConvolver.hh>
+#include <libArrayToolbox/FastConvolutionFilter.hh>
+#include <libArrayToolbox/FastCorrelationFilter.hh>
+#include <libArrayToolbox/FastNormalizedCorrelationFilter.hh>
+
+template<typename DataT>
+static void testOverlapSaveMatchesNaiveImplementation(
+    atb::BoundaryTreatmentType btType, bool correlate,
+    atb::BlitzIndexT kernelExtent0, atb::BlitzIndexT kernelExtent1)
+{
+  DataT boundaryValue = static_cast<DataT>(3);
+  blitz::Array<DataT,2> data(37, 29);
+  for (size_t i = 0; i < data.size(); ++i)
+      data.dataFirst()[i] = static_cast<DataT>(
+          static_cast<double>(std::rand()) / static_cast<double>(RAND_MAX));
+  blitz::Array<DataT,2> kernel(kernelExtent0, kernelExtent1);
+  for (size_t i = 0; i < kernel.size(); ++i)
+      kernel.dataFirst()[i] = static_cast<DataT>(
+          static_cast<double>(std::rand()) / static_cast<double>(RAND_MAX));
+
+  atb::BoundaryTreatment<DataT,2> *bt =
+      atb::BoundaryTreatmentFactory<DataT,2>::get(btType, boundaryValue);
+
+  // Small tiles to get several tiles per dimension
+  atb::OverlapSaveConvolver<DataT,2> convolver(correlate);
+  convolver.setKernel(kernel);
+  convolver.setTileSize(64);
+  blitz::TinyVector<atb::BlitzIndexT,2> tileShape(
+      convolver.tileShape(data.shape()));
+  LMBUNIT_ASSERT(blitz::all(tileShape < data.shape()));
+
+  blitz::Array<DataT,2> result;
+  convolver.apply(data, result, *bt);
+  LMBUNIT_ASSERT(blitz::all(result.shape() == data.shape()));
+
+  for (atb::BlitzIndexT y = 0; y < data.extent(0); ++y)
+  {
+    for (atb::BlitzIndexT x = 0; x < data.extent(1); ++x)
+    {
+      DataT expected = atb::traits<DataT>::zero;
+      for (atb::BlitzIndexT ky = 0; ky < kernel.extent(0); ++ky)
+      {
+        for (atb::BlitzIndexT kx = 0; kx < kernel.extent(1); ++kx)
+        {
+          blitz::TinyVector<ptrdiff_t,2> offset(
+              ky - kernel.extent(0) / 2, kx - kernel.extent(1) / 2);
+          blitz::TinyVector<ptrdiff_t,2> rdPos(y, x);
+          if (correlate) rdPos += offset;
+          else rdPos -= offset;
+          expected += kernel(ky, kx) * bt->get(data, rdPos);
+        }
+      }
+      LMBUNIT_ASSERT_EQUAL_DELTA(result(y, x), expected, 1e-3);
+    }
+  }
+
+  // In-place application
+  blitz::Array<DataT,2> inPlace(data.shape());
+  inPlace = data;
+  convolver.apply(inPlace, inPlace, *bt);
+  for (size_t i = 0; i < result.size(); ++i)
+      LMBUNIT_ASSERT_EQUAL_DELTA(
+          inPlace.dataFirst()[i], result.dataFirst()[i], 1e-5);
+
+  delete bt;
+}
+
+template<typename DataT>
+static void testTiledFiltersMatchPaddedFilters(
+    atb::BoundaryTreatmentType btType)
+{
+  blitz::Array<DataT,3> data(12, 17, 10);
+  for (size_t i = 0; i < data.size(); ++i)
+      data.dataFirst()[i] = static_cast<DataT>(
+          static_cast<double>(std::rand()) / static_cast<double>(RAND_MAX));
+  blitz::Array<DataT,3> kernel(3, 5, 4);
+  for (size_t i = 0; i < kernel.size(); ++i)
+      kernel.dataFirst()[i] = static_cast<DataT>(
+          static_cast<double>(std::rand()) / static_cast<double>(RAND_MAX));
+  blitz::TinyVector<double,3> elSize(1.0);
+
+  blitz::Array<DataT,3> padded, tiled;
+
+  // CropBT is only supported by the normalized cross-correlation
+  if (btType != atb::CropBT)
+  {
+    atb::FastConvolutionFilter<DataT,3> convolution(kernel, btType);
+    convolution.apply(data, elSize, padded);
+    convolution.setTiled(true);
+    LMBUNIT_ASSERT(convolution.tiled());
+    convolution.apply(data, elSize, tiled);
+    for (size_t i = 0; i < data.size(); ++i)
+        LMBUNIT_ASSERT_EQUAL_DELTA(
+            tiled.dataFirst()[i], padded.dataFirst()[i], 1e-3);
+
+    atb::FastCorrelationFilter<DataT,3> correlation(kernel, btType);
+    correlation.apply(data, elSize, padded);
+    correlation.setTiled(true);
+    correlation.apply(data, elSize, tiled);
+    for (size_t i = 0; i < data.size(); ++i)
+        LMBUNIT_ASSERT_EQUAL_DELTA(
+            tiled.dataFirst()[i], padded.dataFirst()[i], 1e-3);
+  }
+
+  atb::FastNormalizedCorrelationFilter<DataT,3> ncc(kernel, btType);
+  ncc.apply(data, elSize, padded);
+  ncc.setTiled(true);
+  ncc.apply(data, elSize, tiled);
+  for (size_t i = 0; i < data.size(); ++i)
+      LMBUNIT_ASSERT_EQUAL_DELTA(
+          tiled.dataFirst()[i], padded.dataFirst()[i], 1e-3);
+}
+
+int main(int, char**)
+{
+  LMBUNIT_WRITE_HEADER();
+
+  atb::BoundaryTreatmentType btTypes[] = {
+      atb::ValueBT, atb::CyclicBT, atb::RepeatBT, atb::MirrorBT };
+  for (int i = 0; i < 4; ++i)
+  {
+    LMBUNIT_RUN_TEST(
+        (testOverlapSaveMatchesNaiveImplementation<float>(
+            btTypes[i], false, 3, 5)));
+    LMBUNIT_RUN_TEST(
+        (testOverlapSaveMatchesNaiveImplementation<double>(
+            btTypes[i], false, 4, 1)));
+    LMBUNIT_RUN_TEST(
+        (testOverlapSaveMatchesNaiveImplementation<float>(
+            btTypes[i], true, 5, 2)));
+    LMBUNIT_RUN_TEST(
+        (testOverlapSaveMatchesNaiveImplementation<double>(
+            btTypes[i], true, 6, 5)));
+    LMBUNIT_RUN_TEST(
+        (testTiledFiltersMatchPaddedFilters<double>(btTypes[i])));
+  }
+  LMBUNIT_RUN_TEST(
+      (testTiledFiltersMatchPaddedFilters<double>(atb::CropBT)));
+
+  LMBUNIT_WRITE_STATISTICS();
+  return _nFails;
+}
@@ -0,0 +1,137 @@
+#include "lmbunit.hh"
+
+#include <libArrayToolbox/TypeTraits.hh>
+#include <libArrayToolbox/BoundaryTreatment.hh>
+#include <libArrayToolbox/SeparableCorrelationFilter.hh>
+
+template<typename DataT>
+static void testSeparableCorrelationFilterMatchesNaiveImplementation(
+    atb::BoundaryTreatmentType btType, atb::BlitzIndexT kernelSize)
+{
+  DataT boundaryValue = static_cast<DataT>(3);
+  blitz::Array<DataT,2> data(9, 13);
+  for (size_t i = 0; i < data.size(); ++i)
+      data.dataFirst()[i] = static_cast<DataT>(
+          static_cast<double>(std::rand()) / static_cast<double>(RAND_MAX));
+
+  blitz::Array<DataT,1> kernel(kernelSize);
+  for (atb::BlitzIndexT k = 0; k < kernelSize; ++k)
+      kernel(k) = static_cast<DataT>(
+          0.1 + static_cast<double>(std::rand()) /
+          static_cast<double>(RAND_MAX));
+  DataT kernelSum = blitz::sum(kernel);
+
+  atb::BoundaryTreatment<DataT,2> *bt =
+      atb::BoundaryTreatmentFactory<DataT,2>::get(btType, boundaryValue);
+
+  // Dimension 0 is filtered in line blocks, dimension 1 line by line.
+  // Kernels exceeding the line length take the naive code path.
+  for (int dim = 0; dim < 2; ++dim)
+  {
+    blitz::TinyVector<blitz::Array<DataT,1>*,2> kernels(NULL, NULL);
+    kernels(dim) = &kernel;
+    atb::SeparableCorrelationFilter<DataT,2> filter(
+        kernels, btType, boundaryValue);
+    blitz::Array<DataT,2> result;
+    filter.applyAlongDim(
+        data, blitz::TinyVector<double,2>(1.0), result, dim, NULL);
+
+    for (atb::BlitzIndexT y = 0; y < data.extent(0); ++y)
+    {
+      for (atb::BlitzIndexT x = 0; x < data.extent(1); ++x)
+      {
+        blitz::TinyVector<ptrdiff_t,2> pos(y, x);
+        DataT expected = atb::traits<DataT>::zero;
+        DataT weight = atb::traits<DataT>::zero;
+        for (atb::BlitzIndexT k = 0; k < kernelSize; ++k)
+        {
+          blitz::TinyVector<ptrdiff_t,2> rdPos(pos);
+          rdPos(dim) += k - kernelSize / 2;
+          if (btType == atb::CropBT)
+          {
+            if (rdPos(dim) < 0 || rdPos(dim) >= data.extent(dim)) continue;
+            weight += kernel(k);
+          }
+          expected += kernel(k) * bt->get(data, rdPos);
+        }
+        if (btType == atb::CropBT) expected *= kernelSum / weight;
+        LMBUNIT_ASSERT_EQUAL_DELTA(result(y, x), expected, 1e-4);
+      }
+    }
+  }
+
+  delete bt;
+}
+
+template<typename DataT>
+static void testBoundaryPoliciesMatchBoundaryTreatments(
+    atb::BoundaryTreatmentType btType)
+{
+  DataT boundaryValue = static_cast<DataT>(7);
+  DataT data[] = { 1, 2, 3, 4, 5 };
+  atb::BoundaryTreatment<DataT,1> *bt =
+      atb::BoundaryTreatmentFactory<DataT,1>::get(btType, boundaryValue);
+  for (ptrdiff_t pos = -12; pos < 17; ++pos)
+  {
+    DataT expected = bt->get(data, pos, 5);
+    DataT got = atb::traits<DataT>::zero;
+    switch (btType)
+    {
+    case atb::ValueBT:
+      got = atb::ValueBoundaryPolicy<DataT,1>(boundaryValue).get(
+          data, pos, 5);
+      break;
+    case atb::CyclicBT:
+      got = atb::CyclicBoundaryPolicy<DataT,1>().get(data, pos, 5);
+      break;
+    case atb::RepeatBT:
+      got = atb::RepeatBoundaryPolicy<DataT,1>().get(data, pos, 5);
+      break;
+    case atb::MirrorBT:
+      got = atb::MirrorBoundaryPolicy<DataT,1>().get(data, pos, 5);
+      break;
+    default:
+      break;
+    }
+    LMBUNIT_ASSERT_EQUAL(got, expected);
+  }
+  delete bt;
+}
+
+int main(int, char**)
+{
+  LMBUNIT_WRITE_HEADER();
+
+  LMBUNIT_RUN_TEST(
+      (testBoundaryPoliciesMatchBoundaryTreatments<float>(atb::ValueBT)));
+  LMBUNIT_RUN_TEST(
+      (testBoundaryPoliciesMatchBoundaryTreatments<float>(atb::CyclicBT)));
+  LMBUNIT_RUN_TEST(
+      (testBoundaryPoliciesMatchBoundaryTreatments<float>(atb::RepeatBT)));
+  LMBUNIT_RUN_TEST(
+      (testBoundaryPoliciesMatchBoundaryTreatments<float>(atb::MirrorBT)));
+
+  atb::BoundaryTreatmentType btTypes[] = {
+      atb::ValueBT, atb::CyclicBT, atb::RepeatBT, atb::MirrorBT };
+  for (int i = 0; i < 4; ++i)
+  {
+    LMBUNIT_RUN_TEST(
+        (testSeparableCorrelationFilterMatchesNaiveImplementation<float>(
+            btTypes[i], 5)));
+    LMBUNIT_RUN_TEST(
+        (testSeparableCorrelationFilterMatchesNaiveImplementation<double>(
+            btTypes[i], 7)));
+    LMBUNIT_RUN_TEST(
+        (testSeparableCorrelationFilterMatchesNaiveImplementation<double>(
+            btTypes[i], 21)));
+  }
+  LMBUNIT_RUN_TEST(
+      (testSeparableCorrelationFilterMatchesNaiveImplementation<float>(
+          atb::CropBT, 5)));
+  LMBUNIT_RUN_TEST(
+      (testSeparableCorrelationFilterMatchesNaiveImplementation<double>(
+          atb::CropBT, 7)));
+
+  LMBUNIT_WRITE_STATISTICS();
+  return _nFails;
+}
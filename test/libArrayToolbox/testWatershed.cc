@@ -0,0 +1,222 @@
+#include "lmbunit.hh"
+
+#include <cstdlib>
+#include <cmath>
+#include <limits>
+#include <set>
+#include <vector>
+
+#include <libArrayToolbox/algo/lmorph.hh>
+
+static blitz::TinyVector<int,3> randomShape(int minExtent, int maxExtent)
+{
+  blitz::TinyVector<int,3> shape;
+  for (int d = 0; d < 3; ++d)
+      shape(d) = minExtent + std::rand() % (maxExtent - minExtent + 1);
+  return shape;
+}
+
+// Uniform random values in [minValue, maxValue]. Small integer ranges give
+// large plateaus.
+template<typename DataT>
+static void fillRandom(
+    blitz::Array<DataT,3> &data, double minValue, double maxValue)
+{
+  bool isInteger = std::numeric_limits<DataT>::is_integer;
+  for (size_t i = 0; i < data.size(); ++i)
+  {
+    double r = static_cast<double>(std::rand()) /
+        (static_cast<double>(RAND_MAX) + 1.0);
+    double value = minValue + r * (maxValue - minValue + (isInteger ? 1 : 0));
+    data.dataFirst()[i] =
+        static_cast<DataT>(isInteger ? std::floor(value) : value);
+  }
+}
+
+// Single voxel seeds labelled 1, 2, ...
+static void randomSeeds(blitz::Array<int,3> &label, int nSeeds)
+{
+  label = 0;
+  for (int i = 1; i <= nSeeds; ++i)
+      label.dataFirst()[std::rand() % label.size()] = i;
+}
+
+// Sparse random markers, neighboring marker voxels form one basin
+static void randomMarkers(blitz::Array<unsigned char,3> &marker)
+{
+  for (size_t i = 0; i < marker.size(); ++i)
+      marker.dataFirst()[i] = (std::rand() % 50 == 0) ? 1 : 0;
+}
+
+// Checks a tiled watershed result against its seeds: seed voxels keep
+// their labels, every label stems from a seed and different labels are
+// always separated by watershed voxels.
+static bool isValidWatershed(
+    blitz::Array<int,3> const &result, blitz::Array<int,3> const &seeds,
+    int conn)
+{
+  std::set<int> seedLabels;
+  blitz::TinyVector<int,3> p, q;
+  for (p(0) = 0; p(0) < seeds.extent(0); ++p(0))
+      for (p(1) = 0; p(1) < seeds.extent(1); ++p(1))
+          for (p(2) = 0; p(2) < seeds.extent(2); ++p(2))
+          {
+            if (seeds(p) == 0) continue;
+            if (result(p) != seeds(p)) return false;
+            seedLabels.insert(seeds(p));
+          }
+
+  Walker3D walker(result.shape(), conn);
+  for (p(0) = 0; p(0) < result.extent(0); ++p(0))
+      for (p(1) = 0; p(1) < result.extent(1); ++p(1))
+          for (p(2) = 0; p(2) < result.extent(2); ++p(2))
+          {
+            if (result(p) == 0) continue;
+            if (seedLabels.find(result(p)) == seedLabels.end()) return false;
+            walker.setLocation(p);
+            while (walker.getNextNeighbor(q))
+            {
+              if (result(q) != 0 && result(q) != result(p) &&
+                  (seeds(p) == 0 || seeds(q) == 0)) return false;
+            }
+          }
+  return true;
+}
+
+static void testBucketQueueMatchesPriorityQueue(
+    int minValue, int maxValue, int conn)
+{
+  blitz::Array<int,3> data(randomShape(8, 20));
+  fillRandom(data, minValue, maxValue);
+
+  blitz::Array<int,3> expected(data.shape()), result(data.shape());
+  randomSeeds(expected, 10);
+  result = expected;
+  morphWatershed(data, expected, conn);
+  morphWatershedBucketQueue(data, result, conn);
+  LMBUNIT_ASSERT(blitz::all(result == expected));
+
+  blitz::Array<unsigned char,3> marker(data.shape());
+  randomMarkers(marker);
+  morphWatershed(data, marker, expected, conn);
+  morphWatershedBucketQueue(data, marker, result, conn);
+  LMBUNIT_ASSERT(blitz::all(result == expected));
+
+  // A single tile is flooded exactly like the whole volume
+  morphWatershedTiled(data, marker, result, conn, 65536, 1);
+  LMBUNIT_ASSERT(blitz::all(result == expected));
+}
+
+template<typename DataT>
+static void testTiledIsValidWatershed(
+    double minValue, double maxValue, int nLevels, int conn)
+{
+  blitz::Array<DataT,3> data(randomShape(8, 20));
+  fillRandom(data, minValue, maxValue);
+
+  blitz::Array<int,3> seeds(data.shape());
+  randomSeeds(seeds, 10);
+  blitz::Array<unsigned char,3> marker(data.shape());
+  randomMarkers(marker);
+  blitz::Array<int,3> markerSeeds(data.shape());
+  morphConnectedComponentLabelling(marker, markerSeeds, conn);
+
+  blitz::Array<int,3> expected(data.shape()), expectedMarker(data.shape());
+  expected = seeds;
+  morphWatershedBucketQueue(data, expected, conn, nLevels);
+  morphWatershedBucketQueue(data, marker, expectedMarker, conn, nLevels);
+
+  blitz::Array<int,3> result(data.shape());
+  result = seeds;
+  morphWatershedTiled(data, result, conn, nLevels, 1);
+  LMBUNIT_ASSERT(blitz::all(result == expected));
+  morphWatershedTiled(data, marker, result, conn, nLevels, 1);
+  LMBUNIT_ASSERT(blitz::all(result == expectedMarker));
+
+  // The borders between the independently flooded tiles may shift the
+  // watershed lines, but the result must still be a valid partition
+  int nTiles[] = { 0, 2, 3, 7, 100 };
+  for (int t = 0; t < 5; ++t)
+  {
+    result = seeds;
+    morphWatershedTiled(data, result, conn, nLevels, nTiles[t]);
+    LMBUNIT_ASSERT(isValidWatershed(result, seeds, conn));
+
+    morphWatershedTiled(data, marker, result, conn, nLevels, nTiles[t]);
+    LMBUNIT_ASSERT(isValidWatershed(result, markerSeeds, conn));
+  }
+}
+
+// Basins around the seeds with distinct ridges in between: the tiles must
+// reproduce the sequential partition up to the voxels next to the ridges.
+static void testTiledMatchesOnSmoothData(int conn)
+{
+  blitz::Array<float,3> data(randomShape(30, 40));
+  blitz::Array<int,3> seeds(data.shape());
+  randomSeeds(seeds, 8);
+
+  std::vector< blitz::TinyVector<int,3> > seedPos;
+  blitz::TinyVector<int,3> p;
+  for (p(0) = 0; p(0) < data.extent(0); ++p(0))
+      for (p(1) = 0; p(1) < data.extent(1); ++p(1))
+          for (p(2) = 0; p(2) < data.extent(2); ++p(2))
+              if (seeds(p) != 0) seedPos.push_back(p);
+  for (p(0) = 0; p(0) < data.extent(0); ++p(0))
+      for (p(1) = 0; p(1) < data.extent(1); ++p(1))
+          for (p(2) = 0; p(2) < data.extent(2); ++p(2))
+          {
+            float minDist = std::numeric_limits<float>::infinity();
+            for (size_t i = 0; i < seedPos.size(); ++i)
+            {
+              blitz::TinyVector<int,3> d(p - seedPos[i]);
+              minDist = std::min(
+                  minDist, std::sqrt(
+                      static_cast<float>(d(0) * d(0) + d(1) * d(1) +
+                                         d(2) * d(2))));
+            }
+            data(p) = minDist;
+          }
+
+  blitz::Array<int,3> expected(data.shape()), result(data.shape());
+  expected = seeds;
+  morphWatershedBucketQueue(data, expected, conn, 256);
+
+  int nTiles[] = { 2, 3, 7 };
+  for (int t = 0; t < 3; ++t)
+  {
+    result = seeds;
+    morphWatershedTiled(data, result, conn, 256, nTiles[t]);
+    LMBUNIT_ASSERT(isValidWatershed(result, seeds, conn));
+    size_t nEqual = 0;
+    for (size_t i = 0; i < result.size(); ++i)
+        if (result.dataFirst()[i] == expected.dataFirst()[i]) ++nEqual;
+    LMBUNIT_ASSERT(nEqual >= 0.97 * result.size());
+  }
+}
+
+int main(int, char**)
+{
+  LMBUNIT_WRITE_HEADER();
+
+  for (int iter = 0; iter < 3; ++iter)
+  {
+    LMBUNIT_RUN_TEST(testBucketQueueMatchesPriorityQueue(-20000, 20000, 6));
+    LMBUNIT_RUN_TEST(testBucketQueueMatchesPriorityQueue(-20000, 20000, 26));
+    LMBUNIT_RUN_TEST(testBucketQueueMatchesPriorityQueue(-3, 4, 6));
+    LMBUNIT_RUN_TEST(testBucketQueueMatchesPriorityQueue(-3, 4, 26));
+
+    LMBUNIT_RUN_TEST(
+        (testTiledIsValidWatershed<unsigned char>(0.0, 255.0, 65536, 6)));
+    LMBUNIT_RUN_TEST(
+        (testTiledIsValidWatershed<unsigned char>(0.0, 255.0, 65536, 26)));
+    LMBUNIT_RUN_TEST(
+        (testTiledIsValidWatershed<double>(-1.0, 1.0, 64, 6)));
+    LMBUNIT_RUN_TEST(
+        (testTiledIsValidWatershed<double>(-1.0, 1.0, 64, 26)));
+    LMBUNIT_RUN_TEST(testTiledMatchesOnSmoothData(6));
+    LMBUNIT_RUN_TEST(testTiledMatchesOnSmoothData(26));
+  }
+
+  LMBUNIT_WRITE_STATISTICS();
+  return _nFails;
+}
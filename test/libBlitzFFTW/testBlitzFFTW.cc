@@ -34,6 +34,9 @@
 **
 **************************************************************************/
 
+#include <cmath>
+#include <cstdlib>
+
 #include "lmbunit.hh"
 #include <libBlitzFFTW/BlitzFFTW.hh>
 
@@ -580,6 +583,104 @@ static void testUnShuffle()
 }
 
 
+static void testForwardManyMatchesSingleTransforms()
+{
+  BlitzFFTW<double>* fftProc = BlitzFFTW<double>::instance();
+
+  blitz::Array<double,3> data(3, 6, 8);
+  for (size_t i = 0; i < data.size(); ++i)
+      data.dataFirst()[i] = static_cast<double>(std::rand()) / RAND_MAX;
+
+  blitz::Array<std::complex<double>,3> stack(3, 6, 5);
+  fftProc->forwardMany(data, stack);
+
+  blitz::Array<double,2> slice(6, 8);
+  blitz::Array<std::complex<double>,2> fft(6, 5);
+  for (int i = 0; i < data.extent(0); ++i)
+  {
+    slice = data(i, blitz::Range::all(), blitz::Range::all());
+    fftProc->forward(slice, fft);
+    for (int y = 0; y < fft.extent(0); ++y)
+    {
+      for (int x = 0; x < fft.extent(1); ++x)
+      {
+        LMBUNIT_ASSERT_EQUAL_DELTA(
+            stack(i, y, x).real(), fft(y, x).real(), 1e-10);
+        LMBUNIT_ASSERT_EQUAL_DELTA(
+            stack(i, y, x).imag(), fft(y, x).imag(), 1e-10);
+      }
+    }
+  }
+
+  blitz::Array<double,3> back(data.shape());
+  fftProc->backwardMany(stack, back);
+  back /= 6 * 8;
+  for (size_t i = 0; i < data.size(); ++i)
+      LMBUNIT_ASSERT_EQUAL_DELTA(
+          back.dataFirst()[i], data.dataFirst()[i], 1e-10);
+}
+
+
+static void testForwardAlongAxis()
+{
+  BlitzFFTW<double>* fftProc = BlitzFFTW<double>::instance();
+
+  blitz::Array<double,2> data(7, 5);
+  for (size_t i = 0; i < data.size(); ++i)
+      data.dataFirst()[i] = static_cast<double>(std::rand()) / RAND_MAX;
+
+  blitz::Array<std::complex<double>,2> lines(4, 5);
+  fftProc->forwardAlongAxis(data, lines, 0);
+
+  blitz::Array<double,1> line(7);
+  blitz::Array<std::complex<double>,1> fft(4);
+  for (int x = 0; x < data.extent(1); ++x)
+  {
+    line = data(blitz::Range::all(), x);
+    fftProc->forward(line, fft);
+    for (int k = 0; k < fft.extent(0); ++k)
+    {
+      LMBUNIT_ASSERT_EQUAL_DELTA(lines(k, x).real(), fft(k).real(), 1e-10);
+      LMBUNIT_ASSERT_EQUAL_DELTA(lines(k, x).imag(), fft(k).imag(), 1e-10);
+    }
+  }
+}
+
+
+static void testR2RDCT()
+{
+  BlitzFFTW<double>* fftProc = BlitzFFTW<double>::instance();
+
+  blitz::Array<double,2> data(6, 5);
+  for (size_t i = 0; i < data.size(); ++i)
+      data.dataFirst()[i] = static_cast<double>(std::rand()) / RAND_MAX;
+
+  // Unnormalized DCT-II along the lines compared to its definition
+  blitz::Array<double,2> dct(data.shape());
+  fftProc->r2rAlongAxis(data, dct, BlitzFFTW<double>::DCT_II, 1);
+  int n = data.extent(1);
+  for (int y = 0; y < data.extent(0); ++y)
+  {
+    for (int k = 0; k < n; ++k)
+    {
+      double expected = 0.0;
+      for (int j = 0; j < n; ++j)
+          expected += 2.0 * data(y, j) * std::cos(M_PI * (j + 0.5) * k / n);
+      LMBUNIT_ASSERT_EQUAL_DELTA(dct(y, k), expected, 1e-10);
+    }
+  }
+
+  // DCT-III inverts the 2-D DCT-II up to the factor 2N per dimension
+  fftProc->r2r(data, dct, BlitzFFTW<double>::DCT_II);
+  blitz::Array<double,2> back(data.shape());
+  fftProc->r2r(dct, back, BlitzFFTW<double>::DCT_III);
+  back /= 4.0 * data.size();
+  for (size_t i = 0; i < data.size(); ++i)
+      LMBUNIT_ASSERT_EQUAL_DELTA(
+          back.dataFirst()[i], data.dataFirst()[i], 1e-10);
+}
+
+
 int main() 
 {
   
@@ -594,6 +695,9 @@ int main()
   LMBUNIT_RUN_TEST(testFFT2DDoubleWithoutDataPreserval());
   LMBUNIT_RUN_TEST(testComplex2ComplexDoubleWithoutDataPreserval());
   LMBUNIT_RUN_TEST(testUnShuffle());
+  LMBUNIT_RUN_TEST(testForwardManyMatchesSingleTransforms());
+  LMBUNIT_RUN_TEST(testForwardAlongAxis());
+  LMBUNIT_RUN_TEST(testR2RDCT());
   LMBUNIT_WRITE_STATISTICS();
   
   return _nFails;
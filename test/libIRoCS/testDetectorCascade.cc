@@ -0,0 +1,366 @@
+#include "lmbunit.hh"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include <libBlitzHdf5/BlitzHdf5Light.hh>
+#include <libArrayToolbox/Array.hh>
+#include <libArrayToolbox/ATBNucleus.hh>
+
+#include <libIRoCS/iRoCSFeatures.hh>
+#include <libIRoCS/DetectorCascade.hh>
+#include <libIRoCS/DetectNucleiWorker.hh>
+
+static double randomValue(double minValue, double maxValue)
+{
+  return minValue + (maxValue - minValue) *
+      static_cast<double>(std::rand()) / static_cast<double>(RAND_MAX);
+}
+
+// Standard normal deviate (Box-Muller)
+static double randomGaussian()
+{
+  double u = randomValue(1e-12, 1.0);
+  double v = randomValue(0.0, 1.0);
+  return std::sqrt(-2.0 * std::log(u)) * std::cos(2.0 * M_PI * v);
+}
+
+// Positives and negatives only differ in the stage features, the other
+// components are noise with large range
+static void createSamples(
+    std::vector<svt::BasicFV> &samples, std::vector<int> const &stageIndices,
+    int nPositives, int nNegatives, int nFeatures)
+{
+  samples.resize(nPositives + nNegatives);
+  for (int i = 0; i < nPositives + nNegatives; ++i)
+  {
+    double label = (i < nPositives) ? 1.0 : 0.0;
+    samples[i].resize(nFeatures);
+    for (int k = 0; k < nFeatures; ++k)
+        samples[i][k] = 100.0 * randomGaussian();
+    for (size_t k = 0; k < stageIndices.size(); ++k)
+        samples[i][stageIndices[k]] = static_cast<double>(k + 1) * (
+            randomGaussian() + ((label > 0.0) ? 1.0 : -1.0)) + 10.0;
+    samples[i].setLabel(label);
+    samples[i].setUniqueID(static_cast<unsigned int>(i));
+  }
+}
+
+// The stage must pass at least the target recall of the positive training
+// samples and reject the reported fraction of the negatives
+static void testThresholdKeepsTargetRecall(double targetRecall)
+{
+  int nPositives = 300, nNegatives = 500;
+  std::vector<int> stageIndices;
+  stageIndices.push_back(2);
+  stageIndices.push_back(3);
+  stageIndices.push_back(5);
+  std::vector<svt::BasicFV> samples;
+  createSamples(samples, stageIndices, nPositives, nNegatives, 8);
+
+  iRoCS::DetectorCascade cascade;
+  LMBUNIT_ASSERT(!cascade.enabled());
+  LMBUNIT_ASSERT(cascade.accept(samples[nPositives]));
+  cascade.train(samples, stageIndices, targetRecall);
+  LMBUNIT_ASSERT(cascade.enabled());
+  LMBUNIT_ASSERT(cascade.featureIndices() == stageIndices);
+  LMBUNIT_ASSERT_EQUAL(cascade.weights().size(), stageIndices.size());
+  LMBUNIT_ASSERT_EQUAL(cascade.targetRecall(), targetRecall);
+
+  int nAcceptedPositives = 0, nRejectedNegatives = 0;
+  for (int i = 0; i < nPositives + nNegatives; ++i)
+  {
+    LMBUNIT_ASSERT_EQUAL(
+        cascade.accept(samples[i]), cascade.score(samples[i]) >= 0.0);
+    if (i < nPositives && cascade.accept(samples[i])) nAcceptedPositives++;
+    if (i >= nPositives && !cascade.accept(samples[i])) nRejectedNegatives++;
+  }
+  LMBUNIT_ASSERT(
+      static_cast<double>(nAcceptedPositives) >=
+      targetRecall * static_cast<double>(nPositives));
+
+  // Negatives scoring exactly at the threshold may flip when folding the
+  // standardization into the weights
+  double rejectionRate = static_cast<double>(nRejectedNegatives) /
+      static_cast<double>(nNegatives);
+  LMBUNIT_ASSERT_EQUAL_DELTA(
+      rejectionRate, cascade.rejectionRate(),
+      2.0 / static_cast<double>(nNegatives));
+
+  // The classes are well separated, the stage must reject negatives
+  LMBUNIT_ASSERT(rejectionRate > 0.5);
+}
+
+static void testSaveLoadRoundTrip()
+{
+  std::string fileName(TOP_BUILD_DIR "/test/libIRoCS/testCascadeModel.h5");
+  std::vector<int> stageIndices;
+  stageIndices.push_back(1);
+  stageIndices.push_back(4);
+  std::vector<svt::BasicFV> samples;
+  createSamples(samples, stageIndices, 100, 200, 6);
+
+  iRoCS::DetectorCascade cascade;
+  cascade.train(samples, stageIndices, 0.95);
+  LMBUNIT_ASSERT(cascade.enabled());
+
+  try
+  {
+    BlitzH5File modelFile(fileName, BlitzH5File::Replace);
+  }
+  catch (BlitzH5Error &e)
+  {
+    LMBUNIT_WRITE_FAILURE("Could not create model file");
+    return;
+  }
+
+  // Files without stage leave the stage disabled
+  iRoCS::DetectorCascade loaded;
+  LMBUNIT_ASSERT(!loaded.load(fileName));
+  LMBUNIT_ASSERT(!loaded.enabled());
+
+  // Disabled stages are not written
+  iRoCS::DetectorCascade().save(fileName);
+  LMBUNIT_ASSERT(!loaded.load(fileName));
+
+  cascade.save(fileName);
+  LMBUNIT_ASSERT(loaded.load(fileName));
+  LMBUNIT_ASSERT(loaded.enabled());
+  LMBUNIT_ASSERT(loaded.featureIndices() == cascade.featureIndices());
+  LMBUNIT_ASSERT(loaded.weights() == cascade.weights());
+  LMBUNIT_ASSERT_EQUAL(loaded.offset(), cascade.offset());
+  LMBUNIT_ASSERT_EQUAL(loaded.targetRecall(), cascade.targetRecall());
+  LMBUNIT_ASSERT_EQUAL(loaded.rejectionRate(), cascade.rejectionRate());
+  for (size_t i = 0; i < samples.size(); ++i)
+      LMBUNIT_ASSERT_EQUAL(loaded.score(samples[i]), cascade.score(samples[i]));
+
+  std::remove(fileName.c_str());
+}
+
+// Bright spheres on a noisy background, the positive voxels are the sphere
+// interiors
+static void createNucleusVolume(
+    atb::Array<double,3> &data, blitz::Array<bool,3> &positive)
+{
+  data.resize(blitz::TinyVector<atb::BlitzIndexT,3>(18, 22, 24));
+  data.setElementSizeUm(blitz::TinyVector<double,3>(1.0));
+  positive.resize(data.shape());
+  positive = false;
+  double centers[][3] = {
+      { 5.0, 6.0, 6.0 }, { 12.0, 15.0, 8.0 }, { 9.0, 8.0, 17.0 },
+      { 13.0, 16.0, 18.0 } };
+  for (atb::BlitzIndexT z = 0; z < data.extent(0); ++z)
+  {
+    for (atb::BlitzIndexT y = 0; y < data.extent(1); ++y)
+    {
+      for (atb::BlitzIndexT x = 0; x < data.extent(2); ++x)
+      {
+        data(z, y, x) = randomValue(0.0, 0.2);
+        for (int s = 0; s < 4; ++s)
+        {
+          double r2 = (z - centers[s][0]) * (z - centers[s][0]) +
+              (y - centers[s][1]) * (y - centers[s][1]) +
+              (x - centers[s][2]) * (x - centers[s][2]);
+          if (r2 <= 9.0) data(z, y, x) += 0.8;
+          if (r2 <= 2.0) positive(z, y, x) = true;
+        }
+      }
+    }
+  }
+}
+
+// Feature layout and groups of trainDetector() and detectNuclei()
+static double const sigmaMin = 0.5, sigmaMax = 64.0, sigmaStep = 2.0;
+static int const bandMax = 5;
+
+static int setupFeatureGroups(iRoCS::Features &features)
+{
+  int nFeatures = 0;
+  std::string sdMagGroup("/features/SDmag");
+  for (double sigma = sigmaMin; sigma <= sigmaMax; sigma *= sigmaStep)
+  {
+    for (int laplace = 0; laplace <= bandMax / 2; ++laplace)
+    {
+      for (int band = 0; band <= bandMax - 2 * laplace; ++band, ++nFeatures)
+          features.addFeatureToGroup(
+              sdMagGroup, features.sdFeatureName(
+                  atb::SDMagFeatureIndex(sigma, laplace, band)));
+    }
+  }
+  features.setGroupNormalization(
+      sdMagGroup, iRoCS::Features::FeatureZeroMeanStddev);
+
+  std::string houghGroup("/features/hough");
+  for (int i = iRoCS::Features::PositiveMagnitude;
+       i <= iRoCS::Features::NegativeRadius; ++i, ++nFeatures)
+      features.addFeatureToGroup(houghGroup, features.houghFeatureName(i));
+  features.setGroupNormalization(
+      houghGroup, iRoCS::Features::FeatureZeroMeanStddev);
+  return nFeatures;
+}
+
+// The raw feature vectors of all voxels
+static void computeFeatureVectors(
+    atb::Array<double,3> const &data, iRoCS::Features &features,
+    int nFeatures, std::vector<svt::BasicFV> &vectors)
+{
+  vectors.resize(data.size());
+  for (size_t j = 0; j < vectors.size(); ++j) vectors[j].resize(nFeatures);
+
+  int feaIdx = 0;
+  for (double sigma = sigmaMin; sigma <= sigmaMax; sigma *= sigmaStep)
+  {
+    for (int laplace = 0; laplace <= bandMax / 2; ++laplace)
+    {
+      int maxBand = bandMax - 2 * laplace;
+      for (int band = 0; band <= maxBand; ++band, ++feaIdx)
+      {
+        atb::Array<double,3> &fea = features.sdFeature(
+            data, atb::SDMagFeatureIndex(sigma, laplace, band), maxBand, "");
+        for (size_t j = 0; j < vectors.size(); ++j)
+            vectors[j][feaIdx] = fea.data()[j];
+      }
+      for (int band = 1; band <= bandMax - 2 * laplace; ++band)
+          features.deleteFeature(atb::SDMagFeatureIndex(sigma, laplace, band));
+    }
+    for (int laplace = 0; laplace <= bandMax / 2; ++laplace)
+        features.deleteFeature(atb::SDMagFeatureIndex(sigma, laplace, 0));
+    features.deleteFeature(atb::SDMagFeatureIndex(sigma, 0, 0));
+  }
+  for (int i = iRoCS::Features::PositiveMagnitude;
+       i <= iRoCS::Features::NegativeRadius; ++i, ++feaIdx)
+  {
+    atb::Array<double,3> &fea = features.houghFeature(data, i, "");
+    for (size_t j = 0; j < vectors.size(); ++j)
+        vectors[j][feaIdx] = fea.data()[j];
+    features.deleteFeature(i);
+  }
+}
+
+static bool runDetection(
+    atb::Array<double,3> const &data, std::string const &modelFileName,
+    ptrdiff_t memoryLimit, std::string const &cacheFileName,
+    atb::Array<float,3> &decisionValues)
+{
+  std::remove(cacheFileName.c_str());
+  std::vector<atb::Nucleus> nuclei;
+  iRoCS::detectNuclei(data, nuclei, modelFileName, memoryLimit, cacheFileName);
+  try
+  {
+    decisionValues.load(cacheFileName, "/decisionValues");
+  }
+  catch (BlitzH5Error &e)
+  {
+    std::remove(cacheFileName.c_str());
+    return false;
+  }
+  std::remove(cacheFileName.c_str());
+  return decisionValues.size() == data.size();
+}
+
+// Without cascade all voxels are classified with the SVM exactly as before
+// the stage was introduced. With cascade the passed voxels keep their
+// decision values, rejected ones get -1.
+static void testDetectNucleiWithCascade()
+{
+  std::string modelFileName(
+      TOP_BUILD_DIR "/test/libIRoCS/testDetectNucleiModel.h5");
+  std::string cacheFileName(
+      TOP_BUILD_DIR "/test/libIRoCS/testDetectNucleiCache.h5");
+
+  atb::Array<double,3> data;
+  blitz::Array<bool,3> positive;
+  createNucleusVolume(data, positive);
+
+  iRoCS::Features features;
+  int nFeatures = setupFeatureGroups(features);
+  std::vector<svt::BasicFV> vectors;
+  computeFeatureVectors(data, features, nFeatures, vectors);
+
+  std::vector<svt::BasicFV> trainingSet;
+  for (size_t j = 0; j < vectors.size(); ++j)
+  {
+    if (positive.dataFirst()[j] || j % 5 == 0)
+    {
+      trainingSet.push_back(vectors[j]);
+      trainingSet.back().setLabel(positive.dataFirst()[j] ? 1.0 : 0.0);
+      trainingSet.back().setUniqueID(
+          static_cast<unsigned int>(trainingSet.size() - 1));
+    }
+  }
+  std::vector<svt::BasicFV> rawTrainingSet(trainingSet);
+
+  try
+  {
+    BlitzH5File modelFile(modelFileName, BlitzH5File::Replace);
+  }
+  catch (BlitzH5Error &e)
+  {
+    LMBUNIT_WRITE_FAILURE("Could not create model file");
+    return;
+  }
+  features.normalizeFeatures(trainingSet);
+  features.saveNormalizationParameters(modelFileName);
+  features.trainTwoClassSVM(trainingSet, modelFileName, 1.0f, 0.01f);
+
+  // Reference decision values of all voxels
+  iRoCS::Features classifier;
+  classifier.loadNormalizationParameters(modelFileName);
+  std::vector<svt::BasicFV> testVectors(vectors);
+  classifier.normalizeFeatures(testVectors);
+  classifier.classifyTwoClassSVM(testVectors, modelFileName);
+
+  atb::Array<float,3> decisionValues;
+  LMBUNIT_ASSERT(
+      runDetection(data, modelFileName, 0, cacheFileName, decisionValues));
+  for (size_t j = 0; j < testVectors.size(); ++j)
+      LMBUNIT_ASSERT_EQUAL_DELTA(
+          decisionValues.data()[j],
+          static_cast<float>(testVectors[j].getLabel()), 1e-5);
+
+  // The stage works on the raw Hough features like in trainDetector()
+  std::vector<int> houghIndices;
+  for (int i = nFeatures - 4; i < nFeatures; ++i) houghIndices.push_back(i);
+  iRoCS::DetectorCascade cascade;
+  cascade.train(rawTrainingSet, houghIndices, 1.0);
+  LMBUNIT_ASSERT(cascade.enabled());
+  cascade.save(modelFileName);
+
+  // A small memory limit splits the passed voxels into several chunks
+  ptrdiff_t memoryLimit = 1000 * nFeatures * sizeof(double);
+  LMBUNIT_ASSERT(
+      runDetection(
+          data, modelFileName, memoryLimit, cacheFileName, decisionValues));
+  size_t nRejected = 0;
+  for (size_t j = 0; j < vectors.size(); ++j)
+  {
+    if (cascade.accept(vectors[j]))
+        LMBUNIT_ASSERT_EQUAL_DELTA(
+            decisionValues.data()[j],
+            static_cast<float>(testVectors[j].getLabel()), 1e-5);
+    else
+    {
+      LMBUNIT_ASSERT(!positive.dataFirst()[j]);
+      LMBUNIT_ASSERT_EQUAL(decisionValues.data()[j], -1.0f);
+      nRejected++;
+    }
+  }
+  LMBUNIT_ASSERT(nRejected > 0);
+
+  std::remove(modelFileName.c_str());
+}
+
+int main(int, char**)
+{
+  LMBUNIT_WRITE_HEADER();
+
+  double targetRecalls[] = { 0.5, 0.9, 0.99, 1.0 };
+  for (int i = 0; i < 4; ++i)
+      LMBUNIT_RUN_TEST(testThresholdKeepsTargetRecall(targetRecalls[i]));
+  LMBUNIT_RUN_TEST(testSaveLoadRoundTrip());
+  LMBUNIT_RUN_TEST(testDetectNucleiWithCascade());
+
+  LMBUNIT_WRITE_STATISTICS();
+  return _nFails;
+}
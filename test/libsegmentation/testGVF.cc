@@ -0,0 +1,191 @@
+#include "lmbunit.hh"
+
+#include <cmath>
+
+#include <libsegmentation/gvf.hh>
+
+static double randomValue(double minValue, double maxValue)
+{
+  return minValue + (maxValue - minValue) *
+      static_cast<double>(std::rand()) / static_cast<double>(RAND_MAX);
+}
+
+template<typename T>
+static void fillRandom(
+    blitz::Array<T,3> &data, double minValue, double maxValue)
+{
+  for (size_t i = 0; i < data.size(); ++i)
+      data.dataFirst()[i] = static_cast<T>(randomValue(minValue, maxValue));
+}
+
+// Random vector field with smooth structure, the squared magnitudes span
+// several orders of magnitude like image gradients
+template<typename T>
+static void fillRandomGradient(blitz::Array<blitz::TinyVector<T,3>,3> &data)
+{
+  for (size_t i = 0; i < data.size(); ++i)
+  {
+    double scale = std::pow(randomValue(0.0, 1.0), 2.0);
+    for (int d = 0; d < 3; ++d)
+        data.dataFirst()[i](d) = static_cast<T>(
+            scale * randomValue(-1.0, 1.0));
+  }
+}
+
+// Every V-cycle must reduce the residual by a factor independent of the
+// grid size. Odd and even extents and extents too small for coarsening
+// are covered.
+template<typename T>
+static void testMultigridReducesResidual(
+    int extent0, int extent1, int extent2,
+    blitz::TinyVector<T,3> const &w, T mu, int nCycles,
+    double finalRelativeResidual)
+{
+  blitz::Array<T,3> c(extent0, extent1, extent2);
+  fillRandom(c, 0.0, 1.0);
+  c = blitz::pow2(blitz::pow2(c));
+  blitz::Array<T,3> rhs(c.shape());
+  fillRandom(rhs, -0.5, 0.5);
+  rhs *= c;
+
+  // Random initial guess including the fixed boundary
+  blitz::Array<T,3> u(c.shape());
+  fillRandom(u, -0.5, 0.5);
+
+  segmentation::GVFMultigridSolver<T> solver(c, w, mu);
+  double initialResidual = std::sqrt(solver.squaredResidualNorm(u, rhs));
+  LMBUNIT_ASSERT(initialResidual > 0.0);
+
+  blitz::Array<T,3> boundary(c.shape());
+  boundary = u;
+
+  double residual = initialResidual;
+  for (int cycle = 0; cycle < nCycles; ++cycle)
+  {
+    solver.vCycle(u, rhs);
+    double newResidual = std::sqrt(solver.squaredResidualNorm(u, rhs));
+    LMBUNIT_ASSERT(newResidual < 0.5 * residual);
+    residual = newResidual;
+  }
+  LMBUNIT_ASSERT(residual < finalRelativeResidual * initialResidual);
+
+  // The boundary is kept fixed
+  for (int lev = 0; lev < extent0; ++lev)
+      for (int row = 0; row < extent1; ++row)
+          for (int col = 0; col < extent2; ++col)
+              if (lev == 0 || lev == extent0 - 1 || row == 0 ||
+                  row == extent1 - 1 || col == 0 || col == extent2 - 1)
+                  LMBUNIT_ASSERT_EQUAL(
+                      u(lev, row, col), boundary(lev, row, col));
+}
+
+// Both solvers discretize the same equation for isotropic data and must
+// converge to the same solution
+static void testMultigridMatchesSOR(
+    int extent0, int extent1, int extent2, double mu)
+{
+  blitz::Array<blitz::TinyVector<double,3>,3> gradient(
+      extent0, extent1, extent2);
+  fillRandomGradient(gradient);
+  blitz::TinyVector<double,3> elementSizeUm(1.0);
+
+  blitz::Array<blitz::TinyVector<double,3>,3> expected(gradient.shape());
+  expected = gradient;
+  segmentation::gradientVectorFlowSOR(
+      expected, elementSizeUm, mu, 1.5, 2000);
+
+  blitz::Array<blitz::TinyVector<double,3>,3> result(gradient.shape());
+  result = gradient;
+  segmentation::gradientVectorFlowMultigrid(
+      result, elementSizeUm, mu, 100, 1e-12);
+
+  for (size_t i = 0; i < gradient.size(); ++i)
+      for (int d = 0; d < 3; ++d)
+          LMBUNIT_ASSERT_EQUAL_DELTA(
+              result.dataFirst()[i](d), expected.dataFirst()[i](d), 1e-6);
+
+  // The flow must actually differ from the normalized input
+  double maxNorm = 0.0;
+  for (size_t i = 0; i < gradient.size(); ++i)
+      maxNorm = std::max(
+          maxNorm, std::sqrt(blitz::dot(
+                                 gradient.dataFirst()[i],
+                                 gradient.dataFirst()[i])));
+  double maxChange = 0.0;
+  for (size_t i = 0; i < gradient.size(); ++i)
+      for (int d = 0; d < 3; ++d)
+          maxChange = std::max(
+              maxChange, std::abs(result.dataFirst()[i](d) -
+                                  gradient.dataFirst()[i](d) / maxNorm));
+  LMBUNIT_ASSERT(maxChange > 1e-2);
+}
+
+// Only the ratios of the element sizes matter
+static void testMultigridRespectsElementSize()
+{
+  blitz::Array<blitz::TinyVector<double,3>,3> gradient(9, 12, 11);
+  fillRandomGradient(gradient);
+
+  blitz::Array<blitz::TinyVector<double,3>,3> isotropic(gradient.shape());
+  isotropic = gradient;
+  segmentation::gradientVectorFlowMultigrid(
+      isotropic, blitz::TinyVector<double,3>(1.0), 0.1, 100, 1e-12);
+
+  blitz::Array<blitz::TinyVector<double,3>,3> scaled(gradient.shape());
+  scaled = gradient;
+  segmentation::gradientVectorFlowMultigrid(
+      scaled, blitz::TinyVector<double,3>(0.5), 0.1, 100, 1e-12);
+
+  blitz::Array<blitz::TinyVector<double,3>,3> anisotropic(gradient.shape());
+  anisotropic = gradient;
+  segmentation::gradientVectorFlowMultigrid(
+      anisotropic, blitz::TinyVector<double,3>(2.0, 1.0, 1.0), 0.1, 100,
+      1e-12);
+
+  double maxScaledDiff = 0.0, maxAnisotropicDiff = 0.0;
+  for (size_t i = 0; i < gradient.size(); ++i)
+  {
+    for (int d = 0; d < 3; ++d)
+    {
+      maxScaledDiff = std::max(
+          maxScaledDiff, std::abs(scaled.dataFirst()[i](d) -
+                                  isotropic.dataFirst()[i](d)));
+      maxAnisotropicDiff = std::max(
+          maxAnisotropicDiff, std::abs(anisotropic.dataFirst()[i](d) -
+                                       isotropic.dataFirst()[i](d)));
+    }
+  }
+  LMBUNIT_ASSERT(maxScaledDiff < 1e-8);
+  LMBUNIT_ASSERT(maxAnisotropicDiff > 1e-3);
+}
+
+int main(int, char**)
+{
+  LMBUNIT_WRITE_HEADER();
+
+  blitz::TinyVector<double,3> isotropic(1.0), anisotropic(0.25, 1.0, 1.0);
+  int shapes[][3] = {
+      { 17, 17, 17 }, { 16, 16, 16 }, { 20, 23, 18 }, { 12, 30, 9 },
+      { 6, 6, 6 }, { 4, 10, 7 } };
+  for (int i = 0; i < 6; ++i)
+  {
+    LMBUNIT_RUN_TEST(
+        (testMultigridReducesResidual<double>(
+            shapes[i][0], shapes[i][1], shapes[i][2], isotropic, 0.1, 8,
+            1e-4)));
+    LMBUNIT_RUN_TEST(
+        (testMultigridReducesResidual<double>(
+            shapes[i][0], shapes[i][1], shapes[i][2], anisotropic, 1.0, 8,
+            1e-4)));
+  }
+  LMBUNIT_RUN_TEST(
+      (testMultigridReducesResidual<float>(
+          16, 21, 13, blitz::TinyVector<float,3>(1.0f), 0.1f, 3, 1e-2)));
+
+  LMBUNIT_RUN_TEST(testMultigridMatchesSOR(12, 13, 14, 0.1));
+  LMBUNIT_RUN_TEST(testMultigridMatchesSOR(10, 16, 9, 0.5));
+  LMBUNIT_RUN_TEST(testMultigridRespectsElementSize());
+
+  LMBUNIT_WRITE_STATISTICS();
+  return _nFails;
+}
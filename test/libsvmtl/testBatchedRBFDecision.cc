@@ -0,0 +1,149 @@
+/**************************************************************************
+**       Title: test unit for BatchedRBFDecision
+**    $RCSfile$
+**   $Revision$$Name$
+**       $Date$
+**   Copyright: GPL $Author$
+** Description:
+**
+**    
+**
+**************************************************************************/
+
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+
+#include "lmbunit.hh"
+#include <libsvmtl/BasicFV.hh>
+#include <libsvmtl/Kernel_RBF.hh>
+#include <libsvmtl/TwoClassSVMc.hh>
+#include <libsvmtl/BatchedRBFDecision.hh>
+
+static void fillRandom( std::vector<svt::BasicFV>& fvs, size_t dim)
+{
+  for( size_t i = 0; i < fvs.size(); ++i)
+  {
+    fvs[i].resize( dim);
+    for( size_t k = 0; k < dim; ++k)
+    {
+      fvs[i][k] = static_cast<double>( std::rand()) / RAND_MAX - 0.5;
+    }
+  }
+}
+
+template<typename ValueT>
+static void testBatchedRBFDecisionMatchesClassify( double tolerance)
+{
+  // sizes chosen to leave remainders in all block loops
+  size_t dim = 13;
+  std::vector<svt::BasicFV> supportVectors( 301);
+  fillRandom( supportVectors, dim);
+  std::vector<svt::BasicFV> testVectors( 150);
+  fillRandom( testVectors, dim);
+  
+  svt::Model<svt::BasicFV> model;
+  model.resize( supportVectors.size());
+  for( unsigned int i = 0; i < supportVectors.size(); ++i)
+  {
+    double alpha = (i % 2 == 0) ? 0.5 + 0.001 * i : -0.7 + 0.002 * i;
+    model.setSupportVector( i, &supportVectors[i], alpha);
+  }
+  model.setRho( 0.3);
+
+  svt::TwoClassSVMc<svt::Kernel_RBF> svm;
+  svm.kernel().setGamma( 0.8);
+
+  svt::BatchedRBFDecision<ValueT> batch( model, svm.kernel().gamma());
+  LMBUNIT_ASSERT_EQUAL( batch.nSupportVectors(), supportVectors.size());
+  LMBUNIT_ASSERT_EQUAL( batch.featureVectorDim(), dim);
+  batch.setBlockSizes( 8, 64);
+
+  std::vector<double> decisionValues( testVectors.size());
+  batch.decisionValues( testVectors.begin(), testVectors.end(),
+                        &decisionValues[0]);
+  for( size_t i = 0; i < testVectors.size(); ++i)
+  {
+    LMBUNIT_ASSERT_EQUAL_DELTA( decisionValues[i],
+                                svm.classify( testVectors[i], model),
+                                tolerance);
+  }
+
+  // packed matrix interface
+  std::vector<ValueT> matrix( testVectors.size() * dim);
+  for( size_t i = 0; i < testVectors.size(); ++i)
+  {
+    for( size_t k = 0; k < dim; ++k)
+    {
+      matrix[i * dim + k] = static_cast<ValueT>( testVectors[i][k]);
+    }
+  }
+  std::vector<double> matrixValues( testVectors.size());
+  batch.decisionValues( &matrix[0], testVectors.size(), &matrixValues[0]);
+  for( size_t i = 0; i < testVectors.size(); ++i)
+  {
+    LMBUNIT_ASSERT_EQUAL_DELTA( matrixValues[i], decisionValues[i],
+                                tolerance);
+  }
+}
+
+template<typename ValueT>
+static void testBatchedRBFExp( double tolerance)
+{
+  std::vector<ValueT> x( 1000);
+  for( size_t i = 0; i < x.size(); ++i)
+  {
+    x[i] = static_cast<ValueT>( -0.05 * i);
+  }
+  std::vector<ValueT> y( x);
+  svt::BatchedRBFExp<ValueT>::apply( &y[0], y.size());
+  for( size_t i = 0; i < x.size(); ++i)
+  {
+    double expected = std::exp( static_cast<double>( x[i]));
+    LMBUNIT_ASSERT_EQUAL_DELTA( y[i] / expected, 1.0, tolerance);
+  }
+}
+
+static void testBatchedRBFDecisionRejectsWrongDim()
+{
+  std::vector<svt::BasicFV> supportVectors( 3);
+  fillRandom( supportVectors, 4);
+  svt::Model<svt::BasicFV> model;
+  model.resize( supportVectors.size());
+  for( unsigned int i = 0; i < supportVectors.size(); ++i)
+  {
+    model.setSupportVector( i, &supportVectors[i], 1.0);
+  }
+  svt::BatchedRBFDecision<double> batch( model, 1.0);
+
+  std::vector<svt::BasicFV> testVectors( 2);
+  fillRandom( testVectors, 5);
+  std::vector<double> decisionValues( testVectors.size());
+  bool thrown = false;
+  try
+  {
+    batch.decisionValues( testVectors.begin(), testVectors.end(),
+                          &decisionValues[0]);
+  }
+  catch( svt::WrongParameterError&)
+  {
+    thrown = true;
+  }
+  LMBUNIT_ASSERT( thrown);
+}
+
+int main( int argc, char** argv)
+{
+  LMBUNIT_WRITE_HEADER();
+
+  LMBUNIT_RUN_TEST_NOFORK( testBatchedRBFExp<double>( 1e-14) );
+  LMBUNIT_RUN_TEST_NOFORK( testBatchedRBFExp<float>( 1e-6) );
+  LMBUNIT_RUN_TEST_NOFORK(
+      testBatchedRBFDecisionMatchesClassify<double>( 1e-10) );
+  LMBUNIT_RUN_TEST_NOFORK(
+      testBatchedRBFDecisionMatchesClassify<float>( 1e-4) );
+  LMBUNIT_RUN_TEST_NOFORK( testBatchedRBFDecisionRejectsWrongDim() );
+  LMBUNIT_WRITE_STATISTICS();
+
+  return _nFails;
+}
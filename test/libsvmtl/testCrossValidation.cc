@@ -44,6 +44,7 @@
 #include <libsvmtl/Kernel_RBF.hh>
 #include <libsvmtl/Kernel_MATRIX.hh>
 #include <libsvmtl/BasicFV.hh>
+#include <libsvmtl/SparseFV.hh>
 #include <libsvmtl/CrossValidator.hh>
 #include <libsvmtl/DirectAccessor.hh>
 
@@ -327,6 +328,83 @@ static void testLeaveOneOut()
 }
 
 
+static void createSparseFeatureVectors( 
+    std::vector<svt::SparseFV>& featureVectors)
+{
+  featureVectors.resize( 60);
+  for( unsigned int i = 0; i < featureVectors.size(); ++i)
+  {
+    int label = i % 3;
+    featureVectors[i].setLabel( label);
+    featureVectors[i][0] = label + 2 * double(std::rand())/RAND_MAX;
+    featureVectors[i][1 + i % 4] = double(std::rand())/RAND_MAX;
+  }
+  svt::adjustUniqueIDs( featureVectors);
+}
+
+template< typename SVM_TYPE>
+static int doCVOnSparseFVs( std::vector<svt::SparseFV>& featureVectors,
+                            int nThreads, int firstSubset, int endSubset,
+                            std::vector<double>& predictedClassLabelByUID)
+{
+  svt::CrossValidator<svt::SparseFV, SVM_TYPE> cv;
+  svt::StDataASCII params;
+  params.setValue("cost",             10);
+  params.setValue("gamma",            0.5);
+  params.setValue("verbose_level",    0);
+  cv.svm()->loadParameters( params);
+  cv.setNThreads( nThreads);
+  svt::GroupedTrainingData<svt::SparseFV> trainData( featureVectors.begin(),
+                                                     featureVectors.end(),
+                                                     svt::DirectAccessor());
+  cv.setTrainingData( &trainData);
+  cv.updateKernelCache();
+  cv.preprocessTrainingData();
+  
+  std::vector<int> subsetIndexByUID;
+  svt::generateSortedSubsets( featureVectors.size(), 5, subsetIndexByUID);
+  return cv.doCVOnSubsets( firstSubset, endSubset, subsetIndexByUID,
+                           predictedClassLabelByUID);
+}
+
+template< typename SVM_TYPE>
+static void testConcurrentCVMatchesSerial()
+{
+  // the squares of the SparseFVs are not computed before the CV
+  std::vector<svt::SparseFV> featureVectors;
+  createSparseFeatureVectors( featureVectors);
+  std::vector<svt::SparseFV> featureVectorsCopy( featureVectors);
+  std::vector<svt::SparseFV> featureVectorsCopy2( featureVectors);
+  
+  std::vector<double> serialPredictions;
+  int serialNCorrect = doCVOnSparseFVs<SVM_TYPE>( 
+      featureVectors, 1, 0, 5, serialPredictions);
+  std::vector<double> predictions;
+  int nCorrect = doCVOnSparseFVs<SVM_TYPE>( 
+      featureVectorsCopy, 4, 0, 5, predictions);
+
+  LMBUNIT_ASSERT( serialNCorrect > 0);
+  LMBUNIT_ASSERT_EQUAL( nCorrect, serialNCorrect);
+  LMBUNIT_ASSERT_EQUAL( predictions.size(), serialPredictions.size());
+  for( size_t i = 0; i < predictions.size(); ++i)
+  {
+    LMBUNIT_ASSERT_EQUAL( predictions[i], serialPredictions[i]);
+  }
+
+  // evaluating the subsets in two parts gives the same predictions
+  std::vector<double> partPredictions;
+  int nCorrectPart1 = doCVOnSparseFVs<SVM_TYPE>( 
+      featureVectorsCopy2, 4, 0, 2, partPredictions);
+  int nCorrectPart2 = doCVOnSparseFVs<SVM_TYPE>( 
+      featureVectorsCopy2, 4, 2, 5, partPredictions);
+  LMBUNIT_ASSERT_EQUAL( nCorrectPart1 + nCorrectPart2, serialNCorrect);
+  for( size_t i = 0; i < partPredictions.size(); ++i)
+  {
+    LMBUNIT_ASSERT_EQUAL( partPredictions[i], serialPredictions[i]);
+  }
+}
+
+
 template< typename SVM_TYPE>
 static double measureCrossValidationTime( 
     std::vector<svt::BasicFV>& featureVectors)
@@ -435,6 +513,7 @@ int main( int argc, char** argv)
   LMBUNIT_RUN_TEST_NOFORK( testBasics());
   LMBUNIT_RUN_TEST_NOFORK( testLeaveOneOut<svt::MultiClassSVMOneVsRest< svt::TwoClassSVMc< svt::Kernel_LINEAR> > >());
   LMBUNIT_RUN_TEST_NOFORK( testLeaveOneOut<svt::MultiClassSVMOneVsRest< svt::TwoClassSVMc< svt::Kernel_MATRIX<svt::Kernel_LINEAR> > > >());
+  LMBUNIT_RUN_TEST_NOFORK( testConcurrentCVMatchesSerial<svt::MultiClassSVMOneVsRest< svt::TwoClassSVMc< svt::Kernel_RBF> > >());
   LMBUNIT_RUN_TEST_NOFORK( testComputationTime());
   LMBUNIT_RUN_TEST( testException());
   
@@ -138,6 +138,161 @@ static void testSearch2D()
 }
 
 
+typedef svt::CrossValidator<
+    svt::BasicFV, svt::MultiClassSVMOneVsOne< svt::TwoClassSVMc<
+                      svt::Kernel_MATRIX< svt::Kernel_RBF> > > > TestCV;
+
+static void createNoisyFeatureVectors( 
+    std::vector<svt::BasicFV>& featureVectors)
+{
+  unsigned int nClasses = 3;
+  unsigned int nFeatureVectorsPerClass = 20;
+  unsigned int nComponents = 5;
+  
+  // classes overlap, so the grid points give different results
+  featureVectors.resize( nFeatureVectorsPerClass * nClasses);
+  for( unsigned int i = 0; i < featureVectors.size(); ++i)
+  {
+    int label = i % nClasses;
+    svt::BasicFV& fv = featureVectors[i];
+    fv.resize( nComponents);
+    fv.setLabel( label);
+    fv[0] = label + 2 * double(std::rand())/RAND_MAX;
+    for( unsigned int j = 1; j < nComponents; ++j)
+    {
+      fv[j] = double(std::rand())/RAND_MAX;
+    }
+  }
+  svt::adjustUniqueIDs( featureVectors);
+}
+
+
+static void testParallelSearch2DMatchesSerial()
+{
+  std::vector<svt::BasicFV> featureVectors;
+  createNoisyFeatureVectors( featureVectors);
+  svt::GroupedTrainingData<svt::BasicFV> trainData( featureVectors.begin(),
+                                                    featureVectors.end(),
+                                                    svt::DirectAccessor());
+  std::vector<int> subsetIndexByUID;
+  svt::generateSortedSubsets( featureVectors.size(), 5, subsetIndexByUID);
+
+  svt::GridAxis row( "gamma:0.01,mul10, 100");
+  row.setChangesKernel( true);
+  svt::GridAxis col( "cost:0.01,mul10, 1000");
+  col.setChangesKernel( false);
+  
+  TestCV serialCV;
+  serialCV.setTrainingData( &trainData);
+  svt::GridSearch serialGrid;
+  std::vector<svt::StDataASCII> serialInfos;
+  unsigned int serialBest;
+  std::vector<svt::SingleClassResult> serialTable;
+  serialGrid.search2D( row, col, &serialCV, subsetIndexByUID, 
+                       serialInfos, serialBest, serialTable);
+
+  std::vector<TestCV*> cvs;
+  for( int i = 0; i < 3; ++i)
+  {
+    cvs.push_back( new TestCV);
+    cvs.back()->setTrainingData( &trainData);
+  }
+  svt::GridSearch grid;
+  grid.setNThreads( 2);
+  std::vector<svt::StDataASCII> infos;
+  unsigned int best;
+  std::vector<svt::SingleClassResult> table;
+  grid.search2D( row, col, cvs, subsetIndexByUID, infos, best, table);
+  for( size_t i = 0; i < cvs.size(); ++i) delete cvs[i];
+  
+  LMBUNIT_ASSERT_EQUAL( infos.size(), serialInfos.size());
+  for( size_t i = 0; i < infos.size(); ++i)
+  {
+    LMBUNIT_ASSERT_EQUAL( infos[i].asUint( "nCorrect"),
+                          serialInfos[i].asUint( "nCorrect"));
+    LMBUNIT_ASSERT_EQUAL( infos[i].asUint( "sum_nSV"),
+                          serialInfos[i].asUint( "sum_nSV"));
+    LMBUNIT_ASSERT_EQUAL( infos[i].asDouble( "gamma"),
+                          serialInfos[i].asDouble( "gamma"));
+    LMBUNIT_ASSERT_EQUAL( infos[i].asDouble( "cost"),
+                          serialInfos[i].asDouble( "cost"));
+    LMBUNIT_ASSERT( !infos[i].valueExists( "nEvaluatedSubsets"));
+  }
+  LMBUNIT_ASSERT_EQUAL( best, serialBest);
+  LMBUNIT_ASSERT_EQUAL( table.size(), serialTable.size());
+}
+
+
+static void testSuccessiveHalving()
+{
+  std::vector<svt::BasicFV> featureVectors;
+  createNoisyFeatureVectors( featureVectors);
+  svt::GroupedTrainingData<svt::BasicFV> trainData( featureVectors.begin(),
+                                                    featureVectors.end(),
+                                                    svt::DirectAccessor());
+  std::vector<int> subsetIndexByUID;
+  svt::generateSortedSubsets( featureVectors.size(), 6, subsetIndexByUID);
+
+  svt::GridAxis row( "gamma:0.01,mul10, 100");
+  row.setChangesKernel( true);
+  svt::GridAxis col( "cost:0.01,mul10, 1000");
+  col.setChangesKernel( false);
+  
+  TestCV cv;
+  cv.setTrainingData( &trainData);
+  svt::GridSearch grid;
+  grid.setHalvingRate( 2);
+  std::vector<svt::StDataASCII> infos;
+  unsigned int best;
+  std::vector<svt::SingleClassResult> table;
+  grid.search2D( row, col, &cv, subsetIndexByUID, infos, best, table);
+
+  LMBUNIT_ASSERT_EQUAL( infos.size(), row.nValues() * col.nValues());
+  unsigned int nTerminated = 0;
+  unsigned int maxNCorrectOfFullCV = 0;
+  for( size_t i = 0; i < infos.size(); ++i)
+  {
+    LMBUNIT_ASSERT( infos[i].valueExists( "nEvaluatedSubsets"));
+    if( infos[i].valueExists( "terminatedEarly"))
+    {
+      ++nTerminated;
+      LMBUNIT_ASSERT( infos[i].asUint( "nEvaluatedSubsets") < 6);
+    }
+    else
+    {
+      LMBUNIT_ASSERT_EQUAL( infos[i].asUint( "nEvaluatedSubsets"), 6u);
+      maxNCorrectOfFullCV = std::max( maxNCorrectOfFullCV,
+                                      infos[i].asUint( "nCorrect"));
+    }
+  }
+  LMBUNIT_ASSERT( nTerminated > 0);
+  LMBUNIT_ASSERT( !infos[best].valueExists( "terminatedEarly"));
+  LMBUNIT_ASSERT_EQUAL( infos[best].asUint( "nCorrect"), maxNCorrectOfFullCV);
+
+  // the surviving grid points are evaluated like in a full search
+  grid.setHalvingRate( 0);
+  std::vector<svt::StDataASCII> fullInfos;
+  unsigned int fullBest;
+  grid.search2D( row, col, &cv, subsetIndexByUID, fullInfos, fullBest,
+                 table);
+  for( size_t i = 0; i < infos.size(); ++i)
+  {
+    if( !infos[i].valueExists( "terminatedEarly"))
+    {
+      LMBUNIT_ASSERT_EQUAL( infos[i].asUint( "nCorrect"),
+                            fullInfos[i].asUint( "nCorrect"));
+      LMBUNIT_ASSERT_EQUAL( infos[i].asUint( "sum_nFV"),
+                            fullInfos[i].asUint( "sum_nFV"));
+      LMBUNIT_ASSERT_EQUAL( infos[i].asUint( "sum_nSV"),
+                            fullInfos[i].asUint( "sum_nSV"));
+      LMBUNIT_ASSERT_EQUAL_DELTA( infos[i].asDouble( "nSV_per_nFV"),
+                                  fullInfos[i].asDouble( "nSV_per_nFV"),
+                                  1e-12);
+    }
+  }
+}
+
+
 static void testException()
 {
   try
@@ -172,6 +327,8 @@ int main( int argc, char** argv)
 {
   LMBUNIT_WRITE_HEADER();
   LMBUNIT_RUN_TEST( testSearch2D() );
+  LMBUNIT_RUN_TEST( testParallelSearch2DMatchesSerial() );
+  LMBUNIT_RUN_TEST( testSuccessiveHalving() );
   LMBUNIT_RUN_TEST_NOFORK( testException() );
   LMBUNIT_WRITE_STATISTICS();
 
@@ -97,7 +97,7 @@ int main( int argc, char** argv)
 {
   LMBUNIT_WRITE_HEADER();
   LMBUNIT_RUN_TEST( testHelpExtractor<MyMultiClassList>(0,2) );
-  LMBUNIT_RUN_TEST( testHelpExtractor<MyTwoClassList>(6,2) );
+  LMBUNIT_RUN_TEST( testHelpExtractor<MyTwoClassList>(7,2) );
   LMBUNIT_RUN_TEST( testHelpExtractor<MyKernelList>(6,8) );
   
   LMBUNIT_WRITE_STATISTICS();
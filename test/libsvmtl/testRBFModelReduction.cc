@@ -0,0 +1,231 @@
+/**************************************************************************
+**       Title: test unit for RBFModelReducer and RandomFourierRBFModel
+**    $RCSfile$
+**   $Revision$$Name$
+**       $Date$
+**   Copyright: GPL $Author$
+** Description:
+**
+**    
+**
+**************************************************************************/
+
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+
+#include "lmbunit.hh"
+#include <libsvmtl/BasicFV.hh>
+#include <libsvmtl/Kernel_RBF.hh>
+#include <libsvmtl/TwoClassSVMc.hh>
+#include <libsvmtl/StDataASCII.hh>
+#include <libsvmtl/RBFModelReducer.hh>
+#include <libsvmtl/RandomFourierRBFModel.hh>
+
+// points scattered around two cluster centers, so a few vectors suffice
+// to approximate the expansion
+static void fillClustered( std::vector<svt::BasicFV>& fvs, size_t dim)
+{
+  for( size_t i = 0; i < fvs.size(); ++i)
+  {
+    fvs[i].resize( dim);
+    for( size_t k = 0; k < dim; ++k)
+    {
+      double center = (i % 2 == 0) ? 0.5 : -0.5;
+      fvs[i][k] = center + 0.2 * (
+          static_cast<double>( std::rand()) / RAND_MAX - 0.5);
+    }
+  }
+}
+
+static void setupModel( std::vector<svt::BasicFV>& supportVectors,
+                        svt::Model<svt::BasicFV>& model)
+{
+  model.resize( supportVectors.size());
+  for( unsigned int i = 0; i < supportVectors.size(); ++i)
+  {
+    double alpha = (i % 2 == 0) ? 0.5 + 0.001 * i : -0.4 - 0.001 * i;
+    model.setSupportVector( i, &supportVectors[i], alpha);
+  }
+  model.setRho( 0.1);
+}
+
+static void testNystroemWithAllLandmarksIsExact()
+{
+  size_t dim = 4;
+  std::vector<svt::BasicFV> supportVectors( 12);
+  std::vector<svt::BasicFV> testVectors( 50);
+  for( size_t i = 0; i < supportVectors.size(); ++i)
+  {
+    supportVectors[i].resize( dim);
+    for( size_t k = 0; k < dim; ++k)
+        supportVectors[i][k] = static_cast<double>( std::rand()) / RAND_MAX;
+  }
+  fillClustered( testVectors, dim);
+  svt::Model<svt::BasicFV> model;
+  setupModel( supportVectors, model);
+
+  svt::TwoClassSVMc<svt::Kernel_RBF> svm;
+  svm.kernel().setGamma( 2.0);
+
+  svt::RBFModelReducer<svt::BasicFV> reducer( model, svm.kernel().gamma());
+  svt::Model<svt::BasicFV> reduced;
+  reducer.reduceNystroem( supportVectors.size(), reduced);
+  LMBUNIT_ASSERT_EQUAL( reduced.size(), supportVectors.size());
+  LMBUNIT_ASSERT_EQUAL_DELTA( reduced.rho(), model.rho(), 1e-15);
+  LMBUNIT_ASSERT( reducer.relativeError() < 1e-4);
+  for( size_t i = 0; i < testVectors.size(); ++i)
+  {
+    LMBUNIT_ASSERT_EQUAL_DELTA( svm.classify( testVectors[i], reduced),
+                                svm.classify( testVectors[i], model),
+                                1e-6);
+  }
+}
+
+static void testReductionErrorDecreasesWithSize()
+{
+  size_t dim = 3;
+  std::vector<svt::BasicFV> supportVectors( 200);
+  fillClustered( supportVectors, dim);
+  std::vector<svt::BasicFV> testVectors( 100);
+  fillClustered( testVectors, dim);
+  svt::Model<svt::BasicFV> model;
+  setupModel( supportVectors, model);
+
+  svt::TwoClassSVMc<svt::Kernel_RBF> svm;
+  svm.kernel().setGamma( 1.0);
+  svt::RBFModelReducer<svt::BasicFV> reducer( model, svm.kernel().gamma());
+
+  svt::Model<svt::BasicFV> reduced;
+  double previousError = 1.0;
+  size_t sizes[] = { 1, 2, 5, 10 };
+  for( int s = 0; s < 4; ++s)
+  {
+    reducer.reducePreImage( sizes[s], reduced);
+    LMBUNIT_ASSERT( reduced.size() <= sizes[s]);
+    LMBUNIT_ASSERT( reducer.relativeError() <= previousError + 1e-12);
+    previousError = reducer.relativeError();
+  }
+  LMBUNIT_ASSERT( previousError < 0.01);
+
+  // |f(x) - f'(x)| <= |Psi - Psi'| |phi(x)| and |Psi| <= sum_i |alpha_i|
+  double alphaSum = 0.0;
+  for( unsigned int i = 0; i < model.size(); ++i)
+      alphaSum += std::abs( model.alpha(i));
+  for( size_t i = 0; i < testVectors.size(); ++i)
+  {
+    LMBUNIT_ASSERT_EQUAL_DELTA( svm.classify( testVectors[i], reduced),
+                                svm.classify( testVectors[i], model),
+                                previousError * alphaSum);
+  }
+
+  previousError = 1.0;
+  for( int s = 0; s < 4; ++s)
+  {
+    reducer.reduceNystroem( sizes[s], reduced);
+    LMBUNIT_ASSERT( reduced.size() <= sizes[s]);
+    LMBUNIT_ASSERT( reducer.relativeError() <= previousError + 1e-12);
+    previousError = reducer.relativeError();
+  }
+}
+
+static void testRandomFourierFeaturesApproximateModel()
+{
+  size_t dim = 3;
+  std::vector<svt::BasicFV> supportVectors( 10);
+  fillClustered( supportVectors, dim);
+  std::vector<svt::BasicFV> testVectors( 20);
+  fillClustered( testVectors, dim);
+  svt::Model<svt::BasicFV> model;
+  setupModel( supportVectors, model);
+
+  svt::TwoClassSVMc<svt::Kernel_RBF> svm;
+  svm.kernel().setGamma( 1.5);
+
+  svt::RandomFourierRBFModel rff;
+  rff.approximate( model, svm.kernel().gamma(), 50000, 7);
+  LMBUNIT_ASSERT_EQUAL( rff.nFeatures(), size_t(50000));
+  LMBUNIT_ASSERT_EQUAL( rff.featureVectorDim(), dim);
+
+  std::vector<double> decisionValues( testVectors.size());
+  rff.decisionValues( testVectors.begin(), testVectors.end(),
+                      &decisionValues[0]);
+  for( size_t i = 0; i < testVectors.size(); ++i)
+  {
+    LMBUNIT_ASSERT_EQUAL_DELTA( decisionValues[i],
+                                svm.classify( testVectors[i], model),
+                                0.1);
+  }
+}
+
+static void testSaveLoadApproximations()
+{
+  size_t dim = 3;
+  std::vector<svt::BasicFV> supportVectors( 30);
+  fillClustered( supportVectors, dim);
+  std::vector<svt::BasicFV> testVectors( 10);
+  fillClustered( testVectors, dim);
+  svt::Model<svt::BasicFV> model;
+  setupModel( supportVectors, model);
+
+  svt::TwoClassSVMc<svt::Kernel_RBF> svm;
+  svm.kernel().setGamma( 1.0);
+
+  svt::RBFModelReducer<svt::BasicFV> reducer( model, svm.kernel().gamma());
+  svt::Model<svt::BasicFV> reduced;
+  reducer.reducePreImage( 4, reduced);
+
+  svt::RandomFourierRBFModel rff;
+  rff.approximate( model, svm.kernel().gamma(), 100);
+
+  svt::StDataASCII stData;
+  model.saveParameters( stData);
+  reduced.saveParameters( stData, "approx_");
+  rff.saveParameters( stData, "rff_");
+  stData.setExceptionFlag( true);
+
+  svt::Model<svt::BasicFV> loadedReduced;
+  loadedReduced.loadParameters( stData, "approx_");
+  LMBUNIT_ASSERT_EQUAL( loadedReduced.size(), reduced.size());
+  svt::RandomFourierRBFModel loadedRff;
+  loadedRff.loadParameters( stData, "rff_");
+  LMBUNIT_ASSERT_EQUAL( loadedRff.nFeatures(), rff.nFeatures());
+
+  std::vector<double> expected( testVectors.size());
+  std::vector<double> loaded( testVectors.size());
+  rff.decisionValues( testVectors.begin(), testVectors.end(), &expected[0]);
+  loadedRff.decisionValues( testVectors.begin(), testVectors.end(),
+                            &loaded[0]);
+  for( size_t i = 0; i < testVectors.size(); ++i)
+  {
+    LMBUNIT_ASSERT_EQUAL_DELTA( loaded[i], expected[i], 1e-8);
+    // StDataASCII writes feature vectors with the default stream precision
+    LMBUNIT_ASSERT_EQUAL_DELTA( svm.classify( testVectors[i], loadedReduced),
+                                svm.classify( testVectors[i], reduced),
+                                1e-3);
+  }
+
+  bool thrown = false;
+  try
+  {
+    loadedRff.loadParameters( stData, "approx_");
+  }
+  catch( svt::SVMError&)
+  {
+    thrown = true;
+  }
+  LMBUNIT_ASSERT( thrown);
+}
+
+int main( int argc, char** argv)
+{
+  LMBUNIT_WRITE_HEADER();
+
+  LMBUNIT_RUN_TEST_NOFORK( testNystroemWithAllLandmarksIsExact() );
+  LMBUNIT_RUN_TEST_NOFORK( testReductionErrorDecreasesWithSize() );
+  LMBUNIT_RUN_TEST_NOFORK( testRandomFourierFeaturesApproximateModel() );
+  LMBUNIT_RUN_TEST_NOFORK( testSaveLoadApproximations() );
+  LMBUNIT_WRITE_STATISTICS();
+
+  return _nFails;
+}
@@ -42,6 +42,7 @@
 **************************************************************************/
 
 #include <sstream>
+#include <cmath>
 
 #include "lmbunit.hh"
 #include <libsvmtl/BasicFV.hh>
@@ -372,6 +373,59 @@ static void testModelInputOutput()
 
 
 
+template<typename SVM, typename FV>
+static void trainOnNoisyRings( SVM& svm, int nThreads,
+                               std::vector<FV>& featureVectors,
+                               svt::Model<FV>& model)
+{
+  svm.kernel().setGamma( 0.5);
+  // small cache to force column eviction during training
+  svm.setCacheSizeMB( 0.25);
+  svm.setNThreads( nThreads);
+  svm.train( featureVectors.begin(), featureVectors.end(), model);
+}
+
+template<typename FV, typename SVM>
+static void testParallelSolverMatchesSerial( SVM& svm)
+{
+  // two overlapping noisy rings, large enough to use the parallel
+  // loops. The squares of SparseFV are not computed before training
+  std::vector<FV> featureVectors(2000);
+  unsigned int seed = 42;
+  for( size_t i = 0; i < featureVectors.size(); ++i)
+  {
+    double radius = (i % 2 == 0) ? 1.0 : 1.5;
+    seed = seed * 1103515245 + 12345;
+    double phi = 6.283185307 * (seed % 10000) / 10000.0;
+    seed = seed * 1103515245 + 12345;
+    double noise = 0.5 * ((seed % 10000) / 10000.0 - 0.5);
+    featureVectors[i].setLabel( (i % 2 == 0) ? -1 : +1);
+    featureVectors[i].setUniqueID( static_cast<unsigned int>(i));
+    featureVectors[i].resize( 2);
+    featureVectors[i][0] = (radius + noise) * std::cos( phi);
+    featureVectors[i][1] = (radius + noise) * std::sin( phi);
+  }
+
+  std::vector<FV> featureVectorsCopy( featureVectors);
+  svt::Model<FV> serialModel;
+  trainOnNoisyRings( svm, 1, featureVectors, serialModel);
+  svt::Model<FV> parallelModel;
+  trainOnNoisyRings( svm, 4, featureVectorsCopy, parallelModel);
+
+  LMBUNIT_ASSERT( serialModel.size() > 0);
+  LMBUNIT_ASSERT_EQUAL( parallelModel.size(), serialModel.size());
+  LMBUNIT_ASSERT_EQUAL( parallelModel.rho(), serialModel.rho());
+  LMBUNIT_ASSERT_EQUAL( parallelModel.getTrainingInfoValue("iterations"),
+                        serialModel.getTrainingInfoValue("iterations"));
+  for( unsigned int i = 0; i < serialModel.size(); ++i)
+  {
+    LMBUNIT_ASSERT_EQUAL( parallelModel.alpha(i), serialModel.alpha(i));
+    LMBUNIT_ASSERT_EQUAL( parallelModel.supportVector(i)->uniqueID(),
+                          serialModel.supportVector(i)->uniqueID());
+  }
+}
+
+
 int main( int argc, char** argv)
 {
   LMBUNIT_WRITE_HEADER();
@@ -386,6 +440,19 @@ int main( int argc, char** argv)
   LMBUNIT_RUN_TEST_NOFORK( testOwnFVClassesWithSVMnu() );
   LMBUNIT_RUN_TEST_NOFORK( testModelInputOutput<svt::BasicFV>() );
   LMBUNIT_RUN_TEST_NOFORK( testModelInputOutput<svt::SparseFV>() );
+
+  svt::TwoClassSVMc<svt::Kernel_RBF> svmc;
+  svmc.setCost( 10);
+  LMBUNIT_RUN_TEST_NOFORK( 
+      testParallelSolverMatchesSerial<svt::BasicFV>( svmc) );
+  LMBUNIT_RUN_TEST_NOFORK( 
+      testParallelSolverMatchesSerial<svt::SparseFV>( svmc) );
+  svt::TwoClassSVMnu<svt::Kernel_RBF> svmnu;
+  svmnu.setNu( 0.3);
+  LMBUNIT_RUN_TEST_NOFORK( 
+      testParallelSolverMatchesSerial<svt::BasicFV>( svmnu) );
+  LMBUNIT_RUN_TEST_NOFORK( 
+      testParallelSolverMatchesSerial<svt::SparseFV>( svmnu) );
   LMBUNIT_WRITE_STATISTICS();
 
   return _nFails;